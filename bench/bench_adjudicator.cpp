@@ -0,0 +1,708 @@
+/**
+ * Diplomacy AI Client - Part of the DAIDE project.
+ *
+ * Adjudicator Benchmark. Times MapAndUnits::adjudicate() on the standard map, in movement, retreat and adjustment
+ * turns, and counts the heap allocations made while adjudicating.
+ *
+ * The positions are taken from random games played from the standard opening, and each scenario adjudicates a fixed
+ * list of random legal order sets for them in turn. Everything is drawn from one seeded generator, so a run with the
+ * same seed adjudicates the same order sets, and its results checksum only changes if the adjudication does.
+ *
+ * The search scenarios adjudicate runs of order sets in one position, each differing from the last in an order or two,
+ * as a bot searching over orders does. They are run with the dependency adjudicator and with the incremental one.
+ *
+ * Each scenario is reported as a JSON object on a line of its own, for tracking from release to release. Movement and
+ * retreat adjudications must not allocate, and the run fails if any of them do.
+ *
+ * Usage: bench_adjudicator [-iAdjudications] [-sSeed]
+ *
+ * Release 8~3
+ **/
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench/standard_game.h"
+#include "daide_client/map_and_units.h"
+#include "daide_client/map_cache.h"
+#include "daide_client/order_generator.h"
+
+using DAIDE::GamePosition;
+using DAIDE::LegalOrders;
+using DAIDE::MapAndUnits;
+using DAIDE::MapCache;
+using DAIDE::MapTopology;
+using DAIDE::OrderGenerator;
+using DAIDE::Token;
+using DAIDE::TokenMessage;
+using DAIDE::set_chosen_orders;
+using DAIDE::set_up_standard_game;
+
+namespace {
+
+// Allocations are only counted while an adjudication is being timed
+std::atomic<bool> counting_allocations {false};
+std::atomic<long> allocation_count {0};
+std::atomic<long> allocated_bytes {0};
+
+// Every form of operator new and delete goes through these. They are not inlined, so the compiler never sees new and
+// delete paired with malloc and free, and does not warn of a mismatch.
+__attribute__((noinline)) void *allocate(std::size_t size, std::size_t alignment) {
+    void *memory {nullptr};
+
+    if (counting_allocations.load(std::memory_order_relaxed)) {
+        allocation_count.fetch_add(1, std::memory_order_relaxed);
+        allocated_bytes.fetch_add(static_cast<long>(size), std::memory_order_relaxed);
+    }
+
+    if (size == 0) { size = 1; }
+    if (alignment <= alignof(std::max_align_t)) {
+        memory = std::malloc(size);
+    } else if (posix_memalign(&memory, alignment, size) != 0) {
+        memory = nullptr;
+    }
+
+    if (memory == nullptr) { throw std::bad_alloc(); }
+    return memory;
+}
+
+__attribute__((noinline)) void deallocate(void *memory) noexcept { std::free(memory); }
+
+} // namespace
+
+void *operator new(std::size_t size) { return allocate(size, 0); }
+
+void *operator new[](std::size_t size) { return allocate(size, 0); }
+
+void operator delete(void *memory) noexcept { deallocate(memory); }
+
+void operator delete[](void *memory) noexcept { deallocate(memory); }
+
+void operator delete(void *memory, std::size_t) noexcept { deallocate(memory); }
+
+void operator delete[](void *memory, std::size_t) noexcept { deallocate(memory); }
+
+#ifdef __cpp_aligned_new
+void *operator new(std::size_t size, std::align_val_t alignment) {
+    return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment) {
+    return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void *memory, std::align_val_t) noexcept { deallocate(memory); }
+
+void operator delete[](void *memory, std::align_val_t) noexcept { deallocate(memory); }
+
+void operator delete(void *memory, std::size_t, std::align_val_t) noexcept { deallocate(memory); }
+
+void operator delete[](void *memory, std::size_t, std::align_val_t) noexcept { deallocate(memory); }
+#endif
+
+namespace {
+
+// The games the positions are taken from
+enum { NUMBER_OF_GAMES = 6 };
+enum { YEARS_PER_GAME = 15 };
+
+// The number of order sets in each scenario. They are adjudicated in turn until the number of adjudications is made.
+enum { ORDER_SETS_PER_SCENARIO = 512 };
+enum { DEFAULT_ADJUDICATIONS = 20000 };
+enum { DEFAULT_SEED = 1 };
+
+// The number of units in the longest ring of attack set up
+enum { MAX_RING_LENGTH = 6 };
+
+// In the search scenarios, the order sets given to each position, and the most units changed between them
+enum { SEARCH_SETS_PER_POSITION = 8 };
+enum { MOST_UNITS_CHANGED = 2 };
+
+using RANDOM = std::mt19937;
+
+// A position to order, with its legal orders
+using BASE_POSITION = struct {
+    GamePosition position;
+    LegalOrders legal_orders;
+};
+
+using BASE_POSITIONS = std::vector<BASE_POSITION>;
+
+// A build, or a remove, for one power
+using BUILD_ORDER = struct {
+    MapAndUnits::POWER_INDEX power;
+    MapAndUnits::COAST_ID location;
+};
+
+// A set of orders for one of the base positions. In movement and retreat turns, the index of the order chosen for
+// each unit of the legal orders. In adjustment turns, the builds and removes.
+using ORDER_SET = struct {
+    int base_position;
+    std::vector<uint16_t> choices;
+    std::vector<BUILD_ORDER> builds;
+};
+
+using SCENARIO = struct {
+    const char *name;
+    const BASE_POSITIONS *base_positions;
+    MapAndUnits::MOVE_ADJUDICATOR move_adjudicator;
+    bool allocation_free;
+    std::vector<ORDER_SET> order_sets;
+};
+
+using SCENARIO_RESULT = struct {
+    long adjudications;
+    double seconds;
+    long allocations;
+    long allocated_bytes;
+    uint64_t results_checksum;
+};
+
+// Uniform enough for a benchmark, and the same with every standard library
+int random_below(RANDOM &random, int limit) {
+    return static_cast<int>(random() % static_cast<unsigned>(limit));
+}
+
+uint64_t add_to_checksum(uint64_t checksum, uint64_t value) {
+    return (checksum ^ value) * 1099511628211ULL;
+}
+
+// A random order for a unit. Half the time it is one of the unit's moves, if it has any, so there are battles.
+int choose_order(RANDOM &random, const LegalOrders &legal_orders, const LegalOrders::UNIT_ORDERS &unit) {
+    LegalOrders::LEGAL_ORDER_LIST orders = legal_orders.get_orders(unit);
+    int number_of_moves {0};
+
+    for (const auto &order : orders) {
+        if (order.order_type == MapAndUnits::MOVE_ORDER) { number_of_moves++; }
+    }
+
+    if ((number_of_moves == 0) || (random_below(random, 2) == 0)) {
+        return random_below(random, orders.size());
+    }
+
+    int moves_to_skip = random_below(random, number_of_moves);
+    for (int order_ctr = 0; order_ctr < orders.size(); order_ctr++) {
+        if ((orders[order_ctr].order_type == MapAndUnits::MOVE_ORDER) && (moves_to_skip-- == 0)) {
+            return order_ctr;
+        }
+    }
+    return 0;
+}
+
+std::vector<uint16_t> choose_orders(RANDOM &random, const LegalOrders &legal_orders) {
+    std::vector<uint16_t> choices;
+
+    for (const auto &unit : legal_orders.get_all_units()) {
+        choices.push_back(static_cast<uint16_t>(choose_order(random, legal_orders, unit)));
+    }
+    return choices;
+}
+
+// Random builds on each power's free home centres, and random removes of its units. Sometimes one fewer than needed
+// is ordered, so waives and civil disorder disbands are adjudicated too.
+std::vector<BUILD_ORDER> choose_builds(RANDOM &random, const GamePosition &position, const LegalOrders &legal_orders) {
+    const MapTopology &topology = *legal_orders.get_topology();
+    std::vector<BUILD_ORDER> builds;
+    std::vector<MapAndUnits::COAST_ID> candidates;
+
+    for (const auto &power_orders : position.winter_orders) {
+        MapAndUnits::POWER_INDEX power = power_orders.first;
+        int number_of_builds = legal_orders.get_number_of_builds(power);
+        int number_of_orders = std::abs(number_of_builds) - random_below(random, 2);
+
+        candidates.clear();
+        if (number_of_builds > 0) {
+            for (MapAndUnits::COAST_INDEX location : legal_orders.get_build_locations(power)) {
+                candidates.push_back(topology.get_coast(location));
+            }
+        } else {
+            for (const auto &unit : legal_orders.get_units(power)) {
+                candidates.push_back(position.units.find(unit.unit)->second.coast_id);
+            }
+        }
+
+        // Take candidates in a random order, at most one in each province
+        MapAndUnits::PROVINCE_SET ordered_provinces;
+        for (int candidate_ctr = 0;
+             (candidate_ctr < static_cast<int>(candidates.size())) && (number_of_orders > 0);
+             candidate_ctr++) {
+
+            std::swap(candidates[candidate_ctr],
+                      candidates[candidate_ctr
+                                 + random_below(random, static_cast<int>(candidates.size()) - candidate_ctr)]);
+
+            if (!ordered_provinces.contains(candidates[candidate_ctr].province_index)) {
+                ordered_provinces.insert(candidates[candidate_ctr].province_index);
+                builds.push_back(BUILD_ORDER {power, candidates[candidate_ctr]});
+                number_of_orders--;
+            }
+        }
+    }
+    return builds;
+}
+
+// Give every army which can be convoyed a convoy, three times in four, with each of the fleets on its route ordered to
+// convoy it. Each fleet takes part in one convoy at most. Returns whether any convoy was set up.
+bool add_convoys(RANDOM &random, const BASE_POSITION &base_position, std::vector<uint16_t> &choices) {
+    const LegalOrders &legal_orders = base_position.legal_orders;
+    const MapTopology &topology = *legal_orders.get_topology();
+    LegalOrders::UNIT_ORDERS_LIST units = legal_orders.get_all_units();
+    int unit_index[MapAndUnits::MAX_PROVINCES];
+    int fleet_choices[MapAndUnits::MAX_PROVINCES];
+    MapAndUnits::PROVINCE_SET convoying_fleets;
+    bool convoy_added {false};
+
+    for (int unit_ctr = 0; unit_ctr < units.size(); unit_ctr++) {
+        unit_index[units[unit_ctr].unit] = unit_ctr;
+    }
+
+    for (int unit_ctr = 0; unit_ctr < units.size(); unit_ctr++) {
+        LegalOrders::LEGAL_ORDER_LIST orders = legal_orders.get_orders(units[unit_ctr]);
+        int number_of_convoys {0};
+        int army_choice {-1};
+
+        for (const auto &order : orders) {
+            if (order.order_type == MapAndUnits::MOVE_BY_CONVOY_ORDER) { number_of_convoys++; }
+        }
+        if ((number_of_convoys == 0) || (random_below(random, 4) == 0)) { continue; }
+
+        int convoys_to_skip = random_below(random, number_of_convoys);
+        for (int order_ctr = 0; (order_ctr < orders.size()) && (army_choice < 0); order_ctr++) {
+            if ((orders[order_ctr].order_type == MapAndUnits::MOVE_BY_CONVOY_ORDER) && (convoys_to_skip-- == 0)) {
+                army_choice = order_ctr;
+            }
+        }
+
+        const LegalOrders::LEGAL_ORDER &convoy = orders[army_choice];
+        MapAndUnits::INDEX_LIST steps = legal_orders.get_convoy_steps(convoy);
+        MapAndUnits::PROVINCE_INDEX destination = topology.get_coast(convoy.destination).province_index;
+        bool route_free {true};
+
+        // Find the convoy order for each fleet on the route
+        for (int step_ctr = 0; route_free && (step_ctr < steps.size()); step_ctr++) {
+            MapAndUnits::PROVINCE_INDEX fleet = steps.first[step_ctr];
+            LegalOrders::LEGAL_ORDER_LIST fleet_orders = legal_orders.get_orders(units[unit_index[fleet]]);
+
+            fleet_choices[step_ctr] = -1;
+            for (int order_ctr = 0; order_ctr < fleet_orders.size(); order_ctr++) {
+                if ((fleet_orders[order_ctr].order_type == MapAndUnits::CONVOY_ORDER)
+                    && (fleet_orders[order_ctr].other_source_province == units[unit_ctr].unit)
+                    && (fleet_orders[order_ctr].other_dest_province == destination)) {
+                    fleet_choices[step_ctr] = order_ctr;
+                }
+            }
+            route_free = (fleet_choices[step_ctr] >= 0) && !convoying_fleets.contains(fleet);
+        }
+
+        if (route_free) {
+            choices[unit_ctr] = static_cast<uint16_t>(army_choice);
+            for (int step_ctr = 0; step_ctr < steps.size(); step_ctr++) {
+                choices[unit_index[steps.first[step_ctr]]] = static_cast<uint16_t>(fleet_choices[step_ctr]);
+                convoying_fleets.insert(steps.first[step_ctr]);
+            }
+            convoy_added = true;
+        }
+    }
+    return convoy_added;
+}
+
+// Set up a ring of three or more units, each moving into the province of the next, from a random starting unit.
+// Units already in a ring are left alone. Returns whether a ring was found.
+bool add_ring(RANDOM &random,
+              const BASE_POSITION &base_position,
+              std::vector<uint16_t> &choices,
+              MapAndUnits::PROVINCE_SET &ring_units) {
+    const LegalOrders &legal_orders = base_position.legal_orders;
+    const MapTopology &topology = *legal_orders.get_topology();
+    LegalOrders::UNIT_ORDERS_LIST units = legal_orders.get_all_units();
+    int unit_index[MapAndUnits::MAX_PROVINCES];
+    int ring_unit_indexes[MAX_RING_LENGTH];
+    int ring_choices[MAX_RING_LENGTH];
+    int ring_length {0};
+    MapAndUnits::PROVINCE_SET units_in_ring;
+
+    for (int unit_ctr = 0; unit_ctr < units.size(); unit_ctr++) {
+        unit_index[units[unit_ctr].unit] = unit_ctr;
+    }
+
+    int current_unit = random_below(random, units.size());
+    MapAndUnits::PROVINCE_INDEX first_province = units[current_unit].unit;
+    if (ring_units.contains(first_province)) { return false; }
+
+    while (ring_length < MAX_RING_LENGTH) {
+        LegalOrders::LEGAL_ORDER_LIST orders = legal_orders.get_orders(units[current_unit]);
+        int number_of_next_units {0};
+        int closing_choice {-1};
+
+        ring_unit_indexes[ring_length] = current_unit;
+        units_in_ring.insert(units[current_unit].unit);
+
+        // Count the moves onto units which could carry the ring on, and look for one which closes it
+        for (int order_ctr = 0; order_ctr < orders.size(); order_ctr++) {
+            if (orders[order_ctr].order_type != MapAndUnits::MOVE_ORDER) { continue; }
+
+            MapAndUnits::PROVINCE_INDEX destination = topology.get_coast(orders[order_ctr].destination).province_index;
+            if ((destination == first_province) && (ring_length >= 2)) {
+                closing_choice = order_ctr;
+            } else if ((base_position.position.units.find(destination) != base_position.position.units.end())
+                       && !units_in_ring.contains(destination)
+                       && !ring_units.contains(destination)) {
+                number_of_next_units++;
+            }
+        }
+
+        if (closing_choice >= 0) {
+            ring_choices[ring_length++] = closing_choice;
+
+            for (int ring_ctr = 0; ring_ctr < ring_length; ring_ctr++) {
+                choices[ring_unit_indexes[ring_ctr]] = static_cast<uint16_t>(ring_choices[ring_ctr]);
+                ring_units.insert(units[ring_unit_indexes[ring_ctr]].unit);
+            }
+            return true;
+        }
+
+        if (number_of_next_units == 0) { return false; }
+
+        int moves_to_skip = random_below(random, number_of_next_units);
+        for (int order_ctr = 0; order_ctr < orders.size(); order_ctr++) {
+            if (orders[order_ctr].order_type != MapAndUnits::MOVE_ORDER) { continue; }
+
+            MapAndUnits::PROVINCE_INDEX destination = topology.get_coast(orders[order_ctr].destination).province_index;
+            if ((destination != first_province)
+                && (base_position.position.units.find(destination) != base_position.position.units.end())
+                && !units_in_ring.contains(destination)
+                && !ring_units.contains(destination)
+                && (moves_to_skip-- == 0)) {
+
+                ring_choices[ring_length++] = order_ctr;
+                current_unit = unit_index[destination];
+                break;
+            }
+        }
+    }
+    return false;
+}
+
+// Put a base position, with an order set, into the map and units ready to adjudicate
+void set_orders(MapAndUnits &map_and_units, const BASE_POSITION &base_position, const ORDER_SET &order_set) {
+    map_and_units.set_position(base_position.position);
+
+    if (map_and_units.current_season == DAIDE::TOKEN_SEASON_WIN) {
+        for (const auto &build : order_set.builds) {
+            map_and_units.winter_orders[build.power].builds_or_disbands.insert(
+                    MapAndUnits::BUILDS_OR_DISBANDS::value_type(build.location, Token(0)));
+        }
+        return;
+    }
+
+    set_chosen_orders(map_and_units, base_position.legal_orders, order_set.choices);
+}
+
+// Play random games from the standard opening, keeping each position reached with its legal orders
+void play_games(RANDOM &random,
+                MapAndUnits &map_and_units,
+                OrderGenerator &order_generator,
+                BASE_POSITIONS *opening_positions,
+                BASE_POSITIONS *movement_positions,
+                BASE_POSITIONS *retreat_positions,
+                BASE_POSITIONS *build_positions) {
+    for (int game_ctr = 0; game_ctr < NUMBER_OF_GAMES; game_ctr++) {
+        set_up_standard_game(map_and_units);
+
+        for (int turn_ctr = 0; (turn_ctr < YEARS_PER_GAME * 5) && !map_and_units.game_over; turn_ctr++) {
+            BASE_POSITION base_position {map_and_units.get_position(), order_generator.generate(map_and_units)};
+            ORDER_SET order_set {0, {}, {}};
+            Token season = map_and_units.current_season;
+
+            if (season == DAIDE::TOKEN_SEASON_WIN) {
+                order_set.builds = choose_builds(random, base_position.position, base_position.legal_orders);
+                build_positions->push_back(base_position);
+            } else {
+                order_set.choices = choose_orders(random, base_position.legal_orders);
+
+                if ((season == DAIDE::TOKEN_SEASON_SUM) || (season == DAIDE::TOKEN_SEASON_AUT)) {
+                    retreat_positions->push_back(base_position);
+                } else if (turn_ctr == 0) {
+                    if (game_ctr == 0) { opening_positions->push_back(base_position); }
+                } else {
+                    movement_positions->push_back(base_position);
+                }
+            }
+
+            set_orders(map_and_units, base_position, order_set);
+            map_and_units.adjudicate();
+            map_and_units.apply_adjudication();
+        }
+    }
+}
+
+// Order sets of random orders, or of random builds in adjustment turns
+void add_random_order_sets(RANDOM &random, SCENARIO &scenario) {
+    const BASE_POSITIONS &base_positions = *scenario.base_positions;
+
+    for (int set_ctr = 0; (set_ctr < ORDER_SETS_PER_SCENARIO) && !base_positions.empty(); set_ctr++) {
+        int base_position = random_below(random, base_positions.size());
+        const BASE_POSITION &position = base_positions[base_position];
+
+        if (position.position.current_season == DAIDE::TOKEN_SEASON_WIN) {
+            scenario.order_sets.push_back(
+                    ORDER_SET {base_position, {}, choose_builds(random, position.position, position.legal_orders)});
+        } else {
+            scenario.order_sets.push_back(
+                    ORDER_SET {base_position, choose_orders(random, position.legal_orders), {}});
+        }
+    }
+}
+
+// Order sets with convoys, or with rings of attack, in positions where they can be set up
+void add_convoy_order_sets(RANDOM &random, SCENARIO &scenario) {
+    const BASE_POSITIONS &base_positions = *scenario.base_positions;
+
+    for (int attempt_ctr = 0;
+         (attempt_ctr < ORDER_SETS_PER_SCENARIO * 20)
+         && (static_cast<int>(scenario.order_sets.size()) < ORDER_SETS_PER_SCENARIO)
+         && !base_positions.empty();
+         attempt_ctr++) {
+
+        int base_position = random_below(random, base_positions.size());
+        ORDER_SET order_set {base_position, choose_orders(random, base_positions[base_position].legal_orders), {}};
+
+        if (add_convoys(random, base_positions[base_position], order_set.choices)) {
+            scenario.order_sets.push_back(order_set);
+        }
+    }
+}
+
+void add_ring_order_sets(RANDOM &random, SCENARIO &scenario) {
+    const BASE_POSITIONS &base_positions = *scenario.base_positions;
+
+    for (int attempt_ctr = 0;
+         (attempt_ctr < ORDER_SETS_PER_SCENARIO * 20)
+         && (static_cast<int>(scenario.order_sets.size()) < ORDER_SETS_PER_SCENARIO)
+         && !base_positions.empty();
+         attempt_ctr++) {
+
+        int base_position = random_below(random, base_positions.size());
+        ORDER_SET order_set {base_position, choose_orders(random, base_positions[base_position].legal_orders), {}};
+        MapAndUnits::PROVINCE_SET ring_units;
+        int number_of_rings {0};
+
+        // Up to two rings, from a few starting units each
+        for (int start_ctr = 0; (start_ctr < 16) && (number_of_rings < 2); start_ctr++) {
+            if (add_ring(random, base_positions[base_position], order_set.choices, ring_units)) { number_of_rings++; }
+        }
+
+        if (number_of_rings > 0) {
+            scenario.order_sets.push_back(order_set);
+        }
+    }
+}
+
+// Runs of order sets in one position, each with the orders of one or two units changed from the set before
+void add_search_order_sets(RANDOM &random, SCENARIO &scenario) {
+    const BASE_POSITIONS &base_positions = *scenario.base_positions;
+    ORDER_SET order_set {0, {}, {}};
+
+    for (int set_ctr = 0; (set_ctr < ORDER_SETS_PER_SCENARIO) && !base_positions.empty(); set_ctr++) {
+        if (set_ctr % SEARCH_SETS_PER_POSITION == 0) {
+            order_set.base_position = random_below(random, base_positions.size());
+            order_set.choices = choose_orders(random, base_positions[order_set.base_position].legal_orders);
+        } else {
+            const LegalOrders &legal_orders = base_positions[order_set.base_position].legal_orders;
+            LegalOrders::UNIT_ORDERS_LIST units = legal_orders.get_all_units();
+            int units_to_change = 1 + random_below(random, MOST_UNITS_CHANGED);
+
+            for (int change_ctr = 0; (change_ctr < units_to_change) && (units.size() > 0); change_ctr++) {
+                int unit_ctr = random_below(random, units.size());
+                int choice = choose_order(random, legal_orders, units[unit_ctr]);
+                order_set.choices[unit_ctr] = static_cast<uint16_t>(choice);
+            }
+        }
+        scenario.order_sets.push_back(order_set);
+    }
+}
+
+uint64_t add_results_to_checksum(uint64_t checksum, const MapAndUnits &map_and_units) {
+    if ((map_and_units.current_season == DAIDE::TOKEN_SEASON_SPR)
+        || (map_and_units.current_season == DAIDE::TOKEN_SEASON_FAL)) {
+        for (const auto &unit : map_and_units.units) {
+            const MapAndUnits::UNIT_AND_ORDER &result = unit.second;
+            uint64_t flags = (result.unit_moves ? 0x01 : 0) | (result.bounce ? 0x02 : 0) | (result.dislodged ? 0x04 : 0)
+                             | (result.support_cut ? 0x08 : 0) | (result.support_void ? 0x10 : 0)
+                             | (result.no_convoy ? 0x20 : 0) | (result.convoy_broken ? 0x40 : 0)
+                             | (result.no_army_to_convoy ? 0x80 : 0);
+
+            checksum = add_to_checksum(checksum, (static_cast<uint64_t>(unit.first) << 8) | flags);
+            if (result.dislodged) {
+                checksum = add_to_checksum(checksum, static_cast<uint64_t>(result.dislodged_from));
+            }
+        }
+    } else if ((map_and_units.current_season == DAIDE::TOKEN_SEASON_SUM)
+               || (map_and_units.current_season == DAIDE::TOKEN_SEASON_AUT)) {
+        for (const auto &unit : map_and_units.dislodged_units) {
+            uint64_t flags = (unit.second.unit_moves ? 0x01 : 0) | (unit.second.bounce ? 0x02 : 0);
+
+            checksum = add_to_checksum(checksum, (static_cast<uint64_t>(unit.first) << 8) | flags);
+        }
+    } else {
+        for (const auto &orders : map_and_units.winter_orders) {
+            checksum = add_to_checksum(checksum, static_cast<uint64_t>(orders.second.number_of_waives));
+
+            for (const auto &build : orders.second.builds_or_disbands) {
+                checksum = add_to_checksum(checksum, (static_cast<uint64_t>(build.first.province_index) << 16)
+                                                     | build.first.coast_token.get_token());
+            }
+        }
+    }
+    return checksum;
+}
+
+// Adjudicate the order sets in turn. The results of the first pass through them go into the checksum.
+SCENARIO_RESULT run_scenario(MapAndUnits &map_and_units, const SCENARIO &scenario, long number_of_adjudications) {
+    SCENARIO_RESULT result {0, 0.0, 0, 0, 14695981039346656037ULL};
+    int number_of_order_sets = static_cast<int>(scenario.order_sets.size());
+
+    map_and_units.set_move_adjudicator(scenario.move_adjudicator);
+
+    for (long adjudication_ctr = 0; adjudication_ctr < number_of_adjudications; adjudication_ctr++) {
+        const ORDER_SET &order_set = scenario.order_sets[adjudication_ctr % number_of_order_sets];
+
+        set_orders(map_and_units, (*scenario.base_positions)[order_set.base_position], order_set);
+
+        long allocations_before = allocation_count.load();
+        long bytes_before = allocated_bytes.load();
+        counting_allocations = true;
+        auto start_time = std::chrono::steady_clock::now();
+
+        map_and_units.adjudicate();
+
+        auto end_time = std::chrono::steady_clock::now();
+        counting_allocations = false;
+
+        result.adjudications++;
+        result.seconds += std::chrono::duration<double>(end_time - start_time).count();
+        result.allocations += allocation_count.load() - allocations_before;
+        result.allocated_bytes += allocated_bytes.load() - bytes_before;
+
+        if (adjudication_ctr < number_of_order_sets) {
+            result.results_checksum = add_results_to_checksum(result.results_checksum, map_and_units);
+        }
+    }
+    return result;
+}
+
+void print_result(const SCENARIO &scenario, const SCENARIO_RESULT &result, unsigned seed) {
+    double adjudications = static_cast<double>(result.adjudications);
+
+    std::printf("{\"benchmark\": \"adjudicator\", \"scenario\": \"%s\", \"seed\": %u, \"positions\": %d, "
+                "\"order_sets\": %d, \"adjudications\": %ld, \"seconds\": %.6f, \"adjudications_per_second\": %.1f, "
+                "\"nanoseconds_per_adjudication\": %.1f, \"allocations\": %ld, \"allocations_per_adjudication\": %.3f, "
+                "\"allocated_bytes\": %ld, \"results_checksum\": \"%016llx\"}\n",
+                scenario.name,
+                seed,
+                static_cast<int>(scenario.base_positions->size()),
+                static_cast<int>(scenario.order_sets.size()),
+                result.adjudications,
+                result.seconds,
+                (result.seconds > 0.0) ? adjudications / result.seconds : 0.0,
+                result.seconds * 1e9 / adjudications,
+                result.allocations,
+                static_cast<double>(result.allocations) / adjudications,
+                result.allocated_bytes,
+                static_cast<unsigned long long>(result.results_checksum));
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    long number_of_adjudications {DEFAULT_ADJUDICATIONS};
+    unsigned seed {DEFAULT_SEED};
+
+    for (int arg_ctr = 1; arg_ctr < argc; arg_ctr++) {
+        std::string arg = argv[arg_ctr];
+
+        if ((arg.size() > 2) && (arg.compare(0, 2, "-i") == 0)) {
+            number_of_adjudications = std::atol(arg.c_str() + 2);
+        } else if ((arg.size() > 2) && (arg.compare(0, 2, "-s") == 0)) {
+            seed = static_cast<unsigned>(std::strtoul(arg.c_str() + 2, nullptr, 10));
+        } else {
+            number_of_adjudications = 0;
+        }
+
+        if (number_of_adjudications <= 0) {
+            std::fprintf(stderr, "Usage: %s [-iAdjudications] [-sSeed]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    // Build the map without touching any cache files
+    MapCache::set_cache_directory("");
+
+    std::unique_ptr<MapAndUnits> map_and_units(new MapAndUnits);
+    TokenMessage mdf_message;
+    mdf_message.set_message_from_text(DAIDE::STANDARD_MDF);
+
+    int error_location = map_and_units->set_map(mdf_message);
+    if ((error_location != DAIDE::ADJUDICATOR_NO_ERROR) || !set_up_standard_game(*map_and_units)) {
+        std::fprintf(stderr, "Could not set up the standard map (error at %d)\n", error_location);
+        return 1;
+    }
+    map_and_units->set_order_checking(false, false);
+
+    RANDOM random(seed);
+    OrderGenerator order_generator;
+    BASE_POSITIONS opening_positions;
+    BASE_POSITIONS movement_positions;
+    BASE_POSITIONS retreat_positions;
+    BASE_POSITIONS build_positions;
+
+    play_games(random, *map_and_units, order_generator,
+               &opening_positions, &movement_positions, &retreat_positions, &build_positions);
+
+    std::vector<SCENARIO> scenarios {
+        SCENARIO {"opening_moves", &opening_positions, MapAndUnits::PHASED_MOVE_ADJUDICATOR, true, {}},
+        SCENARIO {"random_moves", &movement_positions, MapAndUnits::PHASED_MOVE_ADJUDICATOR, true, {}},
+        SCENARIO {"convoy_moves", &movement_positions, MapAndUnits::PHASED_MOVE_ADJUDICATOR, true, {}},
+        SCENARIO {"ring_moves", &movement_positions, MapAndUnits::PHASED_MOVE_ADJUDICATOR, true, {}},
+        SCENARIO {"retreats", &retreat_positions, MapAndUnits::PHASED_MOVE_ADJUDICATOR, true, {}},
+        SCENARIO {"builds", &build_positions, MapAndUnits::PHASED_MOVE_ADJUDICATOR, false, {}},
+        SCENARIO {"search_moves", &movement_positions, MapAndUnits::DEPENDENCY_MOVE_ADJUDICATOR, true, {}},
+        SCENARIO {"search_moves_incremental", &movement_positions, MapAndUnits::INCREMENTAL_MOVE_ADJUDICATOR, true, {}}
+    };
+
+    add_random_order_sets(random, scenarios[0]);
+    add_random_order_sets(random, scenarios[1]);
+    add_convoy_order_sets(random, scenarios[2]);
+    add_ring_order_sets(random, scenarios[3]);
+    add_random_order_sets(random, scenarios[4]);
+    add_random_order_sets(random, scenarios[5]);
+    add_search_order_sets(random, scenarios[6]);
+    scenarios[7].order_sets = scenarios[6].order_sets;
+
+    bool allocation_found {false};
+
+    for (const auto &scenario : scenarios) {
+        if (scenario.order_sets.empty()) {
+            std::fprintf(stderr, "No order sets for scenario %s\n", scenario.name);
+            continue;
+        }
+
+        SCENARIO_RESULT result = run_scenario(*map_and_units, scenario, number_of_adjudications);
+        print_result(scenario, result, seed);
+
+        if (scenario.allocation_free && (result.allocations > 0)) {
+            std::fprintf(stderr, "Scenario %s allocated %ld times\n", scenario.name, result.allocations);
+            allocation_found = true;
+        }
+    }
+    return allocation_found ? 1 : 0;
+}
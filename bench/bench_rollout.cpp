@@ -0,0 +1,141 @@
+/**
+ * Diplomacy AI Client - Part of the DAIDE project.
+ *
+ * Rollout Benchmark. Times the RolloutEngine playing whole games on the standard map, from the standard opening, with
+ * every power ordering at random, and reports the games played per second.
+ *
+ * Each game has its own random generator, seeded from the seed and the game's index, so a run with the same seed plays
+ * the same games with any number of threads, and its results checksum only changes if the games do.
+ *
+ * The run is reported as a JSON object on a line of its own, for tracking from release to release.
+ *
+ * Usage: bench_rollout [-gGames] [-tThreads] [-yYears] [-sSeed]
+ *
+ * Release 8~3
+ **/
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bench/standard_game.h"
+#include "daide_client/adjudication_pool.h"
+#include "daide_client/map_and_units.h"
+#include "daide_client/map_cache.h"
+#include "daide_client/rollout_engine.h"
+
+using DAIDE::AdjudicationPool;
+using DAIDE::MapAndUnits;
+using DAIDE::MapCache;
+using DAIDE::RolloutEngine;
+using DAIDE::TokenMessage;
+using DAIDE::set_up_standard_game;
+
+namespace {
+
+enum { DEFAULT_GAMES = 200 };
+enum { DEFAULT_YEARS = 20 };
+enum { DEFAULT_SEED = 1 };
+
+uint64_t add_to_checksum(uint64_t checksum, uint64_t value) {
+    return (checksum ^ value) * 1099511628211ULL;
+}
+
+// Covers how each game ended and the centres each power held
+uint64_t get_results_checksum(const std::vector<RolloutEngine::GAME_RESULT> &results) {
+    uint64_t checksum {14695981039346656037ULL};
+
+    for (const auto &result : results) {
+        checksum = add_to_checksum(checksum, static_cast<uint64_t>(result.game_end));
+        checksum = add_to_checksum(checksum, static_cast<uint64_t>(result.winner + 1));
+        checksum = add_to_checksum(checksum, static_cast<uint64_t>(result.final_year));
+        checksum = add_to_checksum(checksum, static_cast<uint64_t>(result.number_of_turns));
+
+        for (int centre_count : result.centre_counts) {
+            checksum = add_to_checksum(checksum, static_cast<uint64_t>(centre_count));
+        }
+    }
+    return checksum;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    int number_of_games {DEFAULT_GAMES};
+    int number_of_threads {0};
+    int number_of_years {DEFAULT_YEARS};
+    unsigned seed {DEFAULT_SEED};
+    bool arguments_valid {true};
+
+    for (int arg_ctr = 1; arg_ctr < argc; arg_ctr++) {
+        std::string arg = argv[arg_ctr];
+
+        if ((arg.size() > 2) && (arg.compare(0, 2, "-g") == 0)) {
+            number_of_games = std::atoi(arg.c_str() + 2);
+            arguments_valid = arguments_valid && (number_of_games > 0);
+        } else if ((arg.size() > 2) && (arg.compare(0, 2, "-t") == 0)) {
+            number_of_threads = std::atoi(arg.c_str() + 2);
+            arguments_valid = arguments_valid && (number_of_threads > 0);
+        } else if ((arg.size() > 2) && (arg.compare(0, 2, "-y") == 0)) {
+            number_of_years = std::atoi(arg.c_str() + 2);
+            arguments_valid = arguments_valid && (number_of_years > 0);
+        } else if ((arg.size() > 2) && (arg.compare(0, 2, "-s") == 0)) {
+            seed = static_cast<unsigned>(std::strtoul(arg.c_str() + 2, nullptr, 10));
+        } else {
+            arguments_valid = false;
+        }
+    }
+
+    if (!arguments_valid) {
+        std::fprintf(stderr, "Usage: %s [-gGames] [-tThreads] [-yYears] [-sSeed]\n", argv[0]);
+        return 1;
+    }
+
+    // Build the map without touching any cache files
+    MapCache::set_cache_directory("");
+
+    std::unique_ptr<MapAndUnits> map_and_units(new MapAndUnits);
+    TokenMessage mdf_message;
+    mdf_message.set_message_from_text(DAIDE::STANDARD_MDF);
+
+    int error_location = map_and_units->set_map(mdf_message);
+    if ((error_location != DAIDE::ADJUDICATOR_NO_ERROR) || !set_up_standard_game(*map_and_units)) {
+        std::fprintf(stderr, "Could not set up the standard map (error at %d)\n", error_location);
+        return 1;
+    }
+
+    AdjudicationPool pool(map_and_units->get_topology(), number_of_threads);
+    RolloutEngine rollout_engine(&pool);
+    std::vector<RolloutEngine::GAME_RESULT> results;
+    int solos {0};
+    int draws {0};
+
+    rollout_engine.set_last_year(map_and_units->current_year + number_of_years - 1);
+
+    RolloutEngine::ROLLOUT_STATS stats = rollout_engine.play_games(map_and_units->get_position(), number_of_games,
+                                                                   seed, &results);
+
+    for (const auto &result : results) {
+        if (result.game_end == RolloutEngine::GAME_END_SOLO) { solos++; }
+        if (result.game_end == RolloutEngine::GAME_END_DRAW) { draws++; }
+    }
+
+    std::printf("{\"benchmark\": \"rollout\", \"seed\": %u, \"threads\": %d, \"games\": %d, \"years\": %d, "
+                "\"turns\": %ld, \"solos\": %d, \"draws\": %d, \"seconds\": %.6f, \"games_per_second\": %.2f, "
+                "\"turns_per_second\": %.1f, \"results_checksum\": \"%016llx\"}\n",
+                seed,
+                pool.get_number_of_threads(),
+                stats.number_of_games,
+                number_of_years,
+                stats.number_of_turns,
+                solos,
+                draws,
+                stats.seconds,
+                stats.games_per_second,
+                (stats.seconds > 0.0) ? static_cast<double>(stats.number_of_turns) / stats.seconds : 0.0,
+                static_cast<unsigned long long>(get_results_checksum(results)));
+    return 0;
+}
@@ -0,0 +1,98 @@
+/**
+ * Diplomacy AI Client - Part of the DAIDE project.
+ *
+ * Standard Game. The standard map and starting position, for the tools which adjudicate random games on it, and a
+ * way to give the units orders chosen from their legal orders.
+ *
+ * Release 8~3
+ **/
+
+#ifndef _DAIDE_CLIENT_BENCH_STANDARD_GAME_H
+#define _DAIDE_CLIENT_BENCH_STANDARD_GAME_H
+
+#include <cstdint>
+#include <vector>
+
+#include "daide_client/map_and_units.h"
+#include "daide_client/order_generator.h"
+#include "daide_client/token_message.h"
+
+namespace DAIDE {
+
+const char STANDARD_MDF[] =
+        "MDF (AUS ENG FRA GER ITA RUS TUR) (((AUS BUD TRI VIE) (ENG EDI LON LVP) (FRA BRE MAR PAR) (GER BER "
+        "KIE MUN) (ITA NAP ROM VEN) (RUS MOS SEV STP WAR) (TUR ANK CON SMY) (UNO BEL BUL DEN GRE HOL NWY POR "
+        "RUM SER SPA SWE TUN)) (ADR AEG ALB APU ARM BAL BAR BLA BOH BUR CLY EAS ECH FIN GAL GAS GOB GOL HEL "
+        "ION IRI LVN MAO NAF NAO NTH NWG PIC PIE PRU RUH SIL SKA SYR TUS TYR TYS UKR WAL WES YOR)) ((ADR (FLT "
+        "ALB APU ION TRI VEN)) (AEG (FLT (BUL SCS) CON EAS GRE ION SMY)) (ALB (AMY GRE SER TRI) (FLT ADR GRE "
+        "ION TRI)) (ANK (AMY ARM CON SMY) (FLT ARM BLA CON)) (APU (AMY NAP ROM VEN) (FLT ADR ION NAP VEN)) "
+        "(ARM (AMY ANK SEV SMY SYR) (FLT ANK BLA SEV)) (BAL (FLT BER GOB DEN LVN KIE PRU SWE)) (BAR (FLT NWG "
+        "NWY (STP NCS))) (BEL (AMY BUR HOL PIC RUH) (FLT ECH HOL NTH PIC)) (BER (AMY KIE MUN PRU SIL) (FLT "
+        "BAL KIE PRU)) (BLA (FLT ANK ARM (BUL ECS) CON RUM SEV)) (BOH (AMY GAL MUN SIL TYR VIE)) (GOB (FLT "
+        "BAL FIN LVN (STP SCS) SWE)) (BRE (AMY GAS PAR PIC) (FLT ECH GAS MAO PIC)) (BUD (AMY GAL RUM SER TRI "
+        "VIE)) (BUL (AMY CON GRE RUM SER) ((FLT ECS) BLA CON RUM) ((FLT SCS) AEG CON GRE)) (BUR (AMY BEL GAS "
+        "MAR MUN PAR PIC RUH)) (CLY (AMY EDI LVP) (FLT EDI LVP NAO NWG)) (CON (AMY ANK BUL SMY) (FLT AEG ANK "
+        "BLA (BUL ECS) (BUL SCS) SMY)) (DEN (AMY KIE SWE) (FLT BAL HEL KIE NTH SKA SWE)) (EAS (FLT AEG ION "
+        "SMY SYR)) (EDI (AMY CLY LVP YOR) (FLT CLY NTH NWG YOR)) (ECH (FLT BEL BRE IRI LON MAO NTH PIC WAL)) "
+        "(FIN (AMY NWY STP SWE) (FLT GOB SWE (STP SCS))) (GAL (AMY BOH BUD RUM SIL UKR VIE WAR)) (GAS (AMY "
+        "BRE BUR MAR PAR SPA) (FLT BRE MAO (SPA NCS))) (GRE (AMY ALB BUL SER) (FLT AEG ALB (BUL SCS) ION)) "
+        "(HEL (FLT DEN HOL KIE NTH)) (HOL (AMY BEL KIE RUH) (FLT BEL HEL KIE NTH)) (ION (FLT ADR AEG ALB APU "
+        "EAS GRE NAP TUN TYS)) (IRI (FLT ECH LVP MAO NAO WAL)) (KIE (AMY BER DEN HOL MUN RUH) (FLT BAL BER "
+        "DEN HEL HOL)) (LON (AMY WAL YOR) (FLT ECH NTH WAL YOR)) (LVN (AMY MOS PRU STP WAR) (FLT BAL GOB PRU "
+        "(STP SCS))) (LVP (AMY CLY EDI WAL YOR) (FLT CLY IRI NAO WAL)) (GOL (FLT MAR PIE (SPA SCS) TUS TYS "
+        "WES)) (MAO (FLT BRE ECH GAS IRI NAF NAO POR (SPA NCS) (SPA SCS) WES)) (MAR (AMY BUR GAS PIE SPA) "
+        "(FLT GOL PIE (SPA SCS))) (MOS (AMY LVN SEV STP UKR WAR)) (MUN (AMY BER BOH BUR KIE RUH SIL TYR)) "
+        "(NAF (AMY TUN) (FLT MAO TUN WES)) (NAO (FLT CLY IRI LVP MAO NWG)) (NAP (AMY APU ROM) (FLT APU ION "
+        "ROM TYS)) (NTH (FLT BEL DEN ECH EDI HEL HOL LON NWG NWY SKA YOR)) (NWG (FLT BAR CLY EDI NAO NTH "
+        "NWY)) (NWY (AMY FIN STP SWE) (FLT BAR NTH NWG SKA (STP NCS) SWE)) (PAR (AMY BRE BUR GAS PIC)) (PIC "
+        "(AMY BEL BRE BUR PAR) (FLT BEL BRE ECH)) (PIE (AMY MAR TUS TYR VEN) (FLT GOL MAR TUS)) (POR (AMY "
+        "SPA) (FLT MAO (SPA NCS) (SPA SCS))) (PRU (AMY BER LVN SIL WAR) (FLT BAL BER LVN)) (ROM (AMY APU NAP "
+        "TUS VEN) (FLT NAP TUS TYS)) (RUH (AMY BEL BUR HOL KIE MUN)) (RUM (AMY BUD BUL GAL SER SEV UKR) (FLT "
+        "BLA (BUL ECS) SEV)) (SER (AMY ALB BUD BUL GRE RUM TRI)) (SEV (AMY ARM MOS RUM UKR) (FLT ARM BLA "
+        "RUM)) (SIL (AMY BER BOH GAL MUN PRU WAR)) (SKA (FLT DEN NTH NWY SWE)) (SMY (AMY ANK ARM CON SYR) "
+        "(FLT AEG CON EAS SYR)) (SPA (AMY GAS MAR POR) ((FLT NCS) GAS MAO POR) ((FLT SCS) GOL MAO MAR POR "
+        "WES)) (STP (AMY FIN LVN MOS NWY) ((FLT NCS) BAR NWY) ((FLT SCS) GOB FIN LVN)) (SWE (AMY DEN FIN NWY) "
+        "(FLT BAL GOB DEN FIN NWY SKA)) (SYR (AMY ARM SMY) (FLT EAS SMY)) (TRI (AMY ALB BUD SER TYR VEN VIE) "
+        "(FLT ADR ALB VEN)) (TUN (AMY NAF) (FLT ION NAF TYS WES)) (TUS (AMY PIE ROM VEN) (FLT GOL PIE ROM "
+        "TYS)) (TYR (AMY BOH MUN PIE TRI VEN VIE)) (TYS (FLT GOL ION NAP ROM TUN TUS WES)) (UKR (AMY GAL MOS "
+        "RUM SEV WAR)) (VEN (AMY APU PIE ROM TRI TUS TYR) (FLT ADR APU TRI)) (VIE (AMY BOH BUD GAL TRI TYR)) "
+        "(WAL (AMY LON LVP YOR) (FLT ECH IRI LON LVP)) (WAR (AMY GAL LVN MOS PRU SIL UKR)) (WES (FLT GOL MAO "
+        "NAF (SPA SCS) TUN TYS)) (YOR (AMY EDI LON LVP WAL) (FLT EDI LON NTH)))";
+
+const char STANDARD_SCO[] =
+        "SCO (AUS BUD TRI VIE) (ENG EDI LON LVP) (FRA BRE MAR PAR) (GER BER KIE MUN) (ITA NAP ROM VEN) "
+        "(RUS MOS SEV STP WAR) (TUR ANK CON SMY) (UNO BEL BUL DEN GRE HOL NWY POR RUM SER SPA SWE TUN)";
+
+const char STANDARD_NOW[] =
+        "NOW (SPR 1901) (AUS AMY BUD) (AUS AMY VIE) (AUS FLT TRI) (ENG FLT EDI) (ENG FLT LON) (ENG AMY LVP) "
+        "(FRA FLT BRE) (FRA AMY MAR) (FRA AMY PAR) (GER FLT KIE) (GER AMY BER) (GER AMY MUN) (ITA FLT NAP) "
+        "(ITA AMY ROM) (ITA AMY VEN) (RUS AMY WAR) (RUS AMY MOS) (RUS FLT SEV) (RUS FLT (STP SCS)) (TUR FLT ANK) "
+        "(TUR AMY CON) (TUR AMY SMY)";
+
+inline bool set_up_standard_game(MapAndUnits &map_and_units) {
+    TokenMessage sco_message;
+    TokenMessage now_message;
+
+    sco_message.set_message_from_text(STANDARD_SCO);
+    now_message.set_message_from_text(STANDARD_NOW);
+
+    return (map_and_units.set_ownership(sco_message) == ADJUDICATOR_NO_ERROR)
+           && (map_and_units.set_units(now_message) == ADJUDICATOR_NO_ERROR);
+}
+
+// Give each unit the order with the chosen index in its legal orders
+inline void set_chosen_orders(MapAndUnits &map_and_units,
+                              const LegalOrders &legal_orders,
+                              const std::vector<uint16_t> &choices) {
+    LegalOrders::UNIT_ORDERS_LIST units = legal_orders.get_all_units();
+
+    for (int unit_ctr = 0; unit_ctr < units.size(); unit_ctr++) {
+        const LegalOrders::LEGAL_ORDER &order = legal_orders.get_orders(units[unit_ctr])[choices[unit_ctr]];
+
+        legal_orders.set_order(&map_and_units, units[unit_ctr], order);
+    }
+}
+
+} // namespace DAIDE
+
+#endif // _DAIDE_CLIENT_BENCH_STANDARD_GAME_H
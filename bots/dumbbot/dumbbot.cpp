@@ -14,6 +14,7 @@
  * Release 8~3
  **/
 
+#include <cstdlib>
 #include <iostream>
 #include "bots/dumbbot/bot_type.h"
 #include "bots/dumbbot/dumbbot.h"
@@ -84,19 +85,14 @@ void DumbBot::send_nme_or_obs() {
 }
 
 void DumbBot::process_mdf_message(const TokenMessage & /*incoming_msg*/) {
-    MapAndUnits::PROVINCE_COASTS *province_coasts {nullptr};
-    MapAndUnits::COAST_SET *adjacent_coasts {nullptr};
+    const MapTopology &topology = *(m_map_and_units->get_topology());
 
     // Build the set of adjacent provinces
     for (int province_ctr = 0; province_ctr < m_map_and_units->number_of_provinces; province_ctr++) {
-        province_coasts = &(m_map_and_units->game_map[province_ctr].coast_info);
-
-        for (auto &province_coast : *province_coasts) {
-            adjacent_coasts = &(province_coast.second.adjacent_coasts);
+        m_adjacent_provinces[province_ctr].clear();
 
-            for (const auto &adjacent_coast : *adjacent_coasts) {
-                m_adjacent_provinces[province_ctr].insert(adjacent_coast.province_index);
-            }
+        for (int adjacent_province : topology.get_province_adjacencies(province_ctr)) {
+            m_adjacent_provinces[province_ctr].insert(adjacent_province);
         }
     }
 }
@@ -109,7 +105,7 @@ void DumbBot::process_sco_message(const TokenMessage & /*incoming_msg*/) {
     // Count the size of each power
     for (int province_ctr = 0; province_ctr < m_map_and_units->number_of_provinces; province_ctr++) {
         if (m_map_and_units->game_map[province_ctr].is_supply_centre) {
-            m_power_size[get_power_index(m_map_and_units->game_map[province_ctr].owner)]++;
+            m_power_size[get_power_index(m_map_and_units->province_owner[province_ctr])]++;
         }
     }
 
@@ -126,7 +122,7 @@ void DumbBot::process_sco_message(const TokenMessage & /*incoming_msg*/) {
 DumbBot::WEIGHTING DumbBot::calculate_defense_value(int province_index) {
     WEIGHTING defense_value {0};
     MapAndUnits::COAST_ID coast_id {-1};
-    MapAndUnits::COAST_SET *adjacent_unit_adjacent_coasts {nullptr};
+    const MapAndUnits::COAST_SET *adjacent_unit_adjacent_coasts {nullptr};
 
     // For each adjacent province
     for (auto adjacent_province_itr = m_adjacent_provinces[province_index].begin();
@@ -143,7 +139,7 @@ DumbBot::WEIGHTING DumbBot::calculate_defense_value(int province_index) {
 
                 // If it can move to this province
                 adjacent_unit_adjacent_coasts = &(m_map_and_units->game_map[*adjacent_province_itr]
-                                                  .coast_info[adjacent_unit_itr->second.coast_id.coast_token]
+                                                  .coast_info.at(adjacent_unit_itr->second.coast_id.coast_token)
                                                   .adjacent_coasts);
                 coast_id.province_index = province_index;
                 coast_id.coast_token = Token(0);
@@ -235,8 +231,8 @@ void DumbBot::calculate_factors(const WEIGHTING proximity_attack_weight, const W
     int adjacent_unit_count[MapAndUnits::MAX_PROVINCES][MapAndUnits::MAX_POWERS] {};
     WEIGHTING previous_weight {-1};
     MapAndUnits::COAST_ID coast_id {-1};
-    MapAndUnits::PROVINCE_COASTS *province_coasts {nullptr};
-    MapAndUnits::COAST_SET *adjacent_coasts {nullptr};
+    const MapAndUnits::PROVINCE_COASTS *province_coasts {nullptr};
+    const MapAndUnits::COAST_SET *adjacent_coasts {nullptr};
 
     // Initialise arrays to 0
     for (int province_ctr = 0; province_ctr < m_map_and_units->number_of_provinces; province_ctr++) {
@@ -249,13 +245,13 @@ void DumbBot::calculate_factors(const WEIGHTING proximity_attack_weight, const W
         if (m_map_and_units->game_map[province_ctr].is_supply_centre) {
 
             // Our SC. Calc defense value
-            if (m_map_and_units->game_map[province_ctr].owner == m_map_and_units->power_played) {
+            if (m_map_and_units->province_owner[province_ctr] == m_map_and_units->power_played) {
                 m_defense_value[province_ctr] = calculate_defense_value(province_ctr);
 
             // Not ours. Calc attack value (which is the size of the owning power)
             } else {
                 m_attack_value[province_ctr] = m_power_size[get_power_index(
-                        m_map_and_units->game_map[province_ctr].owner)];
+                        m_map_and_units->province_owner[province_ctr])];
             }
         }
     }
@@ -290,7 +286,7 @@ void DumbBot::calculate_factors(const WEIGHTING proximity_attack_weight, const W
              proximity_itr++) {
 
             adjacent_coasts = &(m_map_and_units->game_map[proximity_itr->first.province_index]
-                                .coast_info[proximity_itr->first.coast_token]
+                                .coast_info.at(proximity_itr->first.coast_token)
                                 .adjacent_coasts);
             previous_province = -1;
 
@@ -337,7 +333,7 @@ void DumbBot::calculate_factors(const WEIGHTING proximity_attack_weight, const W
 
     for (auto &unit : m_map_and_units->units) {
         adjacent_coasts = &(m_map_and_units->game_map[unit.second.coast_id.province_index]
-                            .coast_info[unit.second.coast_id.coast_token]
+                            .coast_info.at(unit.second.coast_id.coast_token)
                             .adjacent_coasts);
 
         for (const auto &adjacent_coast : *adjacent_coasts) {
@@ -409,7 +405,7 @@ void DumbBot::generate_movement_orders() {
     DESTINATION_MAP destination_map;
     MOVING_UNIT_MAP moving_unit_map;
     MapAndUnits::UNIT_AND_ORDER *unit {nullptr};
-    MapAndUnits::COAST_SET *adjacent_coasts {nullptr};
+    const MapAndUnits::COAST_SET *adjacent_coasts {nullptr};
 
     // Put our units into a random order. This is one of the ways in which DumbBot is made non-deterministic -
     // the order the units are considered in can affect the orders selected
@@ -424,7 +420,7 @@ void DumbBot::generate_movement_orders() {
 
         // Put all the adjacent coasts into the destination map
         adjacent_coasts = &(m_map_and_units->game_map[unit_itr->second]
-                            .coast_info[unit->coast_id.coast_token]
+                            .coast_info.at(unit->coast_id.coast_token)
                             .adjacent_coasts);
 
         for (const auto & adjacent_coast : *adjacent_coasts) {
@@ -566,7 +562,7 @@ void DumbBot::check_for_wasted_holds(MOVING_UNIT_MAP &moving_unit_map) {
     MapAndUnits::PROVINCE_INDEX destination {-1};
     MapAndUnits::PROVINCE_INDEX source {-1};
     MapAndUnits::UNIT_AND_ORDER *unit {nullptr};
-    MapAndUnits::COAST_SET *adjacent_coasts {nullptr};
+    const MapAndUnits::COAST_SET *adjacent_coasts {nullptr};
 
     // For each unit, if it is ordered to hold
     for (int our_unit : m_map_and_units->our_units) {
@@ -576,7 +572,7 @@ void DumbBot::check_for_wasted_holds(MOVING_UNIT_MAP &moving_unit_map) {
 
             // Consider every province we can move to
             adjacent_coasts = &(m_map_and_units->game_map[unit->coast_id.province_index]
-                                .coast_info[unit->coast_id.coast_token]
+                                .coast_info.at(unit->coast_id.coast_token)
                                 .adjacent_coasts);
             max_destination_value = 0;
 
@@ -795,7 +791,7 @@ void DumbBot::generate_build_orders(int build_count) {
     int builds_remaining = build_count;
     MapAndUnits::COAST_ID coast_id {-1};
     DESTINATION_MAP build_map {};
-    MapAndUnits::PROVINCE_COASTS *province_coasts {nullptr};
+    const MapAndUnits::PROVINCE_COASTS *province_coasts {nullptr};
 
     // Put all the coasts of all the home centres into a map
     for (int open_home_centre : m_map_and_units->open_home_centres) {
@@ -900,6 +896,7 @@ bool DumbBot::extract_parameters(const std::string &command_line_a, DAIDE::COMMA
     parameters.port_specified = false;
     parameters.log_level_specified = false;
     parameters.reconnection_specified = false;
+    parameters.metrics_specified = false;
 
     std::string m_command_line = command_line_a;
 
@@ -980,11 +977,27 @@ bool DumbBot::extract_parameters(const std::string &command_line_a, DAIDE::COMMA
                 break;
             }
 
+            case 'm': {
+                char *port_end {nullptr};
+                long metrics_port = strtol(parameter.c_str(), &port_end, 10);
+
+                if ((port_end != parameter.c_str()) && (*port_end == '\0')
+                    && (metrics_port >= 1) && (metrics_port <= 65535)) {
+                    parameters.metrics_specified = true;
+                    parameters.metrics_port = static_cast<uint16_t>(metrics_port);
+                } else {
+                    std::cout << "-m should be followed by a port number from 1 to 65535" << std::endl;
+                    extracted_ok = false;
+                }
+
+                break;
+            }
+
             default: {
                 std::cout << std::string(BOT_FAMILY) << " - version " << std::string(BOT_GENERATION) << std::endl;
                 std::cout << "Usage: " << std::string(BOT_FAMILY) <<
                              " [-sServerName|-iIPAddress] [-pPortNumber] "
-                             "[-lLogLevel] [-rPOW:passcode] [-d]" << std::endl;
+                             "[-lLogLevel] [-rPOW:passcode] [-mMetricsPort] [-d]" << std::endl;
                 extracted_ok = false;
             }
         }
@@ -41,7 +41,7 @@ public:
 
 private:
     using WEIGHTING = int64_t;
-    using ADJACENT_PROVINCE_SET = std::set<DAIDE::MapAndUnits::PROVINCE_INDEX>;
+    using ADJACENT_PROVINCE_SET = DAIDE::MapAndUnits::PROVINCE_SET;
     using PROXIMITY_MAP = std::map<DAIDE::MapAndUnits::COAST_ID, WEIGHTING>;
     using RANDOM_UNIT_MAP = std::multimap<int, DAIDE::MapAndUnits::PROVINCE_INDEX, std::greater<>>;
     using DESTINATION_MAP = std::map<WEIGHTING, DAIDE::MapAndUnits::COAST_ID, std::greater<>>;
@@ -41,8 +41,8 @@ void RandBot::process_now_message(const TokenMessage & /*incoming_message*/) {
     MapAndUnits::COAST_ID move_destination {-1};
     MapAndUnits::COAST_ID build_location {-1};
     MapAndUnits::UNIT_AND_ORDER *unit_info {nullptr};
-    MapAndUnits::COAST_DETAILS *province_coast_info {nullptr};
-    MapAndUnits::PROVINCE_COASTS *build_coast_info {nullptr};
+    const MapAndUnits::COAST_DETAILS *province_coast_info {nullptr};
+    const MapAndUnits::PROVINCE_COASTS *build_coast_info {nullptr};
 
     if (!m_map_and_units->game_over) {
 
@@ -53,7 +53,7 @@ void RandBot::process_now_message(const TokenMessage & /*incoming_message*/) {
             for (int our_unit : m_map_and_units->our_units) {
                 unit_info = &(m_map_and_units->units[our_unit]);
                 province_coast_info = &(m_map_and_units->game_map[unit_info->coast_id.province_index]
-                                        .coast_info[unit_info->coast_id.coast_token]);
+                                        .coast_info.at(unit_info->coast_id.coast_token));
                 move_destination = get_random_set_member<MapAndUnits::COAST_SET>(province_coast_info->adjacent_coasts);
                 m_map_and_units->set_move_order(our_unit, move_destination);
             }
@@ -0,0 +1,197 @@
+/**
+ * Diplomacy AI Client - Part of the DAIDE project.
+ *
+ * Adjudication Pool. A pool of worker threads which adjudicate positions.
+ *
+ * Release 8~3
+ **/
+
+#include <algorithm>
+
+#include "daide_client/adjudication_pool.h"
+#include "daide_client/metrics.h"
+
+using DAIDE::AdjudicationPool;
+
+namespace {
+
+// The pool and worker the current thread belongs to, if it is a worker
+thread_local const AdjudicationPool *current_pool {nullptr};
+thread_local int current_worker {0};
+
+// A batch which has been split into several tasks. The last task to finish sets the result.
+using BATCH_STATE = struct {
+    std::promise<bool> promise;
+    std::atomic<int> chunks_left;
+    std::atomic<bool> succeeded;
+};
+
+} // namespace
+
+AdjudicationPool::AdjudicationPool(const std::shared_ptr<const MapTopology> &topology, int number_of_threads)
+    : m_topology(topology) {
+
+    if (number_of_threads <= 0) {
+        number_of_threads = std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+    }
+
+    // Every queue must be in place before any worker starts stealing
+    for (int worker_ctr = 0; worker_ctr < number_of_threads; worker_ctr++) {
+        m_queues.emplace_back(new WORKER_QUEUE);
+    }
+    for (int worker_ctr = 0; worker_ctr < number_of_threads; worker_ctr++) {
+        m_threads.emplace_back(&AdjudicationPool::run, this, worker_ctr);
+    }
+}
+
+AdjudicationPool::~AdjudicationPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_sleep_mutex);
+        m_stopping = true;
+        m_tasks_available.notify_all();
+    }
+
+    for (auto &thread : m_threads) {
+        thread.join();
+    }
+}
+
+void AdjudicationPool::submit(TASK task) {
+    int queue = (current_pool == this)
+                    ? current_worker
+                    : static_cast<int>(m_next_queue.fetch_add(1, std::memory_order_relaxed) % m_queues.size());
+
+    {
+        std::lock_guard<std::mutex> lock(m_queues[queue]->mutex);
+        m_queues[queue]->tasks.push_back(std::move(task));
+    }
+    m_tasks_waiting.fetch_add(1);
+
+    // Taking the lock makes sure a worker which has just found nothing to do is either woken, or sees the task
+    std::lock_guard<std::mutex> lock(m_sleep_mutex);
+    m_tasks_available.notify_one();
+}
+
+std::future<DAIDE::GamePosition> AdjudicationPool::adjudicate(const GamePosition &position, bool apply_results) {
+    auto promise = std::make_shared<std::promise<GamePosition>>();
+    std::future<GamePosition> result = promise->get_future();
+
+    adjudicate(position, apply_results, [promise](const GamePosition &adjudicated_position) {
+        promise->set_value(adjudicated_position);
+    });
+    return result;
+}
+
+void AdjudicationPool::adjudicate(const GamePosition &position, bool apply_results, COMPLETION on_completion) {
+    auto shared_position = std::make_shared<const GamePosition>(position);
+
+    submit([shared_position, apply_results, on_completion](WORKER_SCRATCH &scratch) {
+        MapAndUnits &map_and_units = scratch.map_and_units;
+
+        map_and_units.set_position(*shared_position);
+        map_and_units.adjudicate();
+        if (apply_results) { map_and_units.apply_adjudication(); }
+
+        on_completion(map_and_units.get_position());
+    });
+}
+
+std::future<bool> AdjudicationPool::adjudicate_batch(const GamePosition &position,
+                                                     const LegalOrders &legal_orders,
+                                                     const BatchAdjudicator::ORDER_CHOICE order_sets[],
+                                                     int number_of_order_sets,
+                                                     BatchAdjudicator::UNIT_RESULT results[],
+                                                     PROVINCE_SET bounce_locations[]) {
+    auto shared_position = std::make_shared<const GamePosition>(position);
+    auto batch = std::make_shared<BATCH_STATE>();
+    std::future<bool> result = batch->promise.get_future();
+    const LegalOrders *batch_legal_orders = &legal_orders;
+    int number_of_units = legal_orders.get_number_of_units();
+    int number_of_chunks = (number_of_order_sets + BATCH_CHUNK_SIZE - 1) / BATCH_CHUNK_SIZE;
+
+    if (number_of_chunks <= 0) {
+        batch->promise.set_value(true);
+        return result;
+    }
+
+    batch->chunks_left = number_of_chunks;
+    batch->succeeded = true;
+
+    for (int chunk_ctr = 0; chunk_ctr < number_of_chunks; chunk_ctr++) {
+        int first_set = chunk_ctr * BATCH_CHUNK_SIZE;
+        int number_of_sets = std::min(static_cast<int>(BATCH_CHUNK_SIZE), number_of_order_sets - first_set);
+        const BatchAdjudicator::ORDER_CHOICE *chunk_order_sets = order_sets + first_set * number_of_units;
+        BatchAdjudicator::UNIT_RESULT *chunk_results = results + first_set * number_of_units;
+        PROVINCE_SET *chunk_bounce_locations = (bounce_locations == nullptr) ? nullptr : bounce_locations + first_set;
+
+        submit([=](WORKER_SCRATCH &scratch) {
+            if (!scratch.batch_adjudicator.adjudicate_batch(*shared_position, *batch_legal_orders, chunk_order_sets,
+                                                            number_of_sets, chunk_results, chunk_bounce_locations)) {
+                batch->succeeded = false;
+            }
+
+            if (batch->chunks_left.fetch_sub(1) == 1) {
+                batch->promise.set_value(batch->succeeded.load());
+            }
+        });
+    }
+    return result;
+}
+
+void AdjudicationPool::run(int worker) {
+    static MetricsHistogram &adjudication_time = MetricsRegistry::instance()->histogram(
+            "daide_adjudication_seconds", "Time taken by MapAndUnits::adjudicate()");
+    MetricsHistogram worker_adjudication_time(adjudication_time.get_upper_bounds());
+    WORKER_SCRATCH scratch(m_topology);
+    int tasks_since_histogram_added {0};
+    TASK task;
+
+    current_pool = this;
+    current_worker = worker;
+    scratch.map_and_units.set_adjudication_histogram(&worker_adjudication_time);
+
+    while (true) {
+        if (take_task(worker, &task)) {
+            task(scratch);
+            task = nullptr;
+
+            if (++tasks_since_histogram_added >= HISTOGRAM_INTERVAL) {
+                adjudication_time.add_and_clear(worker_adjudication_time);
+                tasks_since_histogram_added = 0;
+            }
+            continue;
+        }
+
+        // Nothing to do, so bring the shared histogram up to date and sleep until there is
+        adjudication_time.add_and_clear(worker_adjudication_time);
+        tasks_since_histogram_added = 0;
+
+        std::unique_lock<std::mutex> lock(m_sleep_mutex);
+        m_tasks_available.wait(lock, [this] { return m_stopping || (m_tasks_waiting.load() > 0); });
+        if (m_stopping && (m_tasks_waiting.load() == 0)) { break; }
+    }
+
+    current_pool = nullptr;
+}
+
+bool AdjudicationPool::take_task(int worker, TASK *task) {
+    int number_of_queues = static_cast<int>(m_queues.size());
+
+    for (int queue_ctr = 0; queue_ctr < number_of_queues; queue_ctr++) {
+        WORKER_QUEUE &queue = *m_queues[(worker + queue_ctr) % number_of_queues];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+
+        if (!queue.tasks.empty()) {
+            if (queue_ctr == 0) {
+                *task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+            } else {
+                *task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+            }
+            m_tasks_waiting.fetch_sub(1);
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,115 @@
+/**
+ * Diplomacy AI Client - Part of the DAIDE project.
+ *
+ * Adjudication Pool. A pool of worker threads which adjudicate positions, so a bot can use every core for lookahead.
+ *
+ * Each worker has its own queue of tasks. A worker takes its newest task first, and when its queue is empty it steals
+ * the oldest task from another worker, so the load evens out without a queue which every thread contends for. Tasks
+ * submitted from outside the pool are dealt out to the queues in turn, and tasks submitted by a task go on its own
+ * worker's queue.
+ *
+ * Each worker keeps its own MapAndUnits, BatchAdjudicator and OrderGenerator on the pool's map, and reuses them from
+ * task to task.
+ * Its adjudication times are kept in its own histogram, and added to the shared one every so often.
+ *
+ * Release 8~3
+ **/
+
+#ifndef _DAIDE_CLIENT_DAIDE_CLIENT_ADJUDICATION_POOL_H
+#define _DAIDE_CLIENT_DAIDE_CLIENT_ADJUDICATION_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "daide_client/batch_adjudicator.h"
+#include "daide_client/game_position.h"
+#include "daide_client/map_and_units.h"
+#include "daide_client/map_topology.h"
+#include "daide_client/order_generator.h"
+
+namespace DAIDE {
+
+class AdjudicationPool : public MapTypes {
+public:
+    // The number of order sets in each task a batch is split into
+    enum { BATCH_CHUNK_SIZE = 64 };
+
+    // What a worker keeps from task to task
+    using WORKER_SCRATCH = struct tag_worker_scratch {
+        explicit tag_worker_scratch(const std::shared_ptr<const MapTopology> &topology) : map_and_units(topology) {}
+
+        MapAndUnits map_and_units;
+        BatchAdjudicator batch_adjudicator;
+        OrderGenerator order_generator;
+    };
+
+    // A task, run on one of the workers with its scratch. Tasks must not throw.
+    using TASK = std::function<void(WORKER_SCRATCH &scratch)>;
+
+    // Called on the worker with the adjudicated position
+    using COMPLETION = std::function<void(const GamePosition &adjudicated_position)>;
+
+    // Start the workers, one per hardware thread if number_of_threads is 0
+    explicit AdjudicationPool(const std::shared_ptr<const MapTopology> &topology, int number_of_threads = 0);
+
+    AdjudicationPool(const AdjudicationPool &other) = delete;
+    AdjudicationPool& operator=(const AdjudicationPool &other) = delete;
+
+    // Runs every task already submitted, then stops the workers
+    ~AdjudicationPool();
+
+    int get_number_of_threads() const { return static_cast<int>(m_threads.size()); }
+
+    void submit(TASK task);
+
+    // Adjudicate the orders in a position. The result is the position with the results set in its units and winter
+    // orders, or if apply_results is set, the position of the next turn.
+    std::future<GamePosition> adjudicate(const GamePosition &position, bool apply_results = false);
+
+    void adjudicate(const GamePosition &position, bool apply_results, COMPLETION on_completion);
+
+    // BatchAdjudicator::adjudicate_batch(), split across the workers. The legal orders and the arrays must be kept
+    // until the result is ready.
+    std::future<bool> adjudicate_batch(const GamePosition &position,
+                                       const LegalOrders &legal_orders,
+                                       const BatchAdjudicator::ORDER_CHOICE order_sets[],
+                                       int number_of_order_sets,
+                                       BatchAdjudicator::UNIT_RESULT results[],
+                                       PROVINCE_SET bounce_locations[] = nullptr);
+
+private:
+    // The number of adjudications a worker makes between adding its histogram to the shared one
+    enum { HISTOGRAM_INTERVAL = 256 };
+
+    using WORKER_QUEUE = struct {
+        std::mutex mutex;
+        std::deque<TASK> tasks;
+    };
+
+    void run(int worker);
+
+    // The newest task on the worker's own queue, else the oldest on another queue
+    bool take_task(int worker, TASK *task);
+
+    std::shared_ptr<const MapTopology> m_topology;
+    std::vector<std::unique_ptr<WORKER_QUEUE>> m_queues;
+    std::vector<std::thread> m_threads;
+    std::atomic<unsigned> m_next_queue {0};
+
+    // The workers sleep while there are no tasks waiting
+    std::atomic<int> m_tasks_waiting {0};
+    std::mutex m_sleep_mutex;
+    std::condition_variable m_tasks_available;
+    bool m_stopping {false};
+};
+
+} // namespace DAIDE
+
+#endif // _DAIDE_CLIENT_DAIDE_CLIENT_ADJUDICATION_POOL_H
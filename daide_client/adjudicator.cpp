@@ -12,11 +12,20 @@
  * Release 8~3
  **/
 
+#include <algorithm>
+#include <functional>
+#include <utility>
+
 #include "daide_client/map_and_units.h"
+#include "daide_client/metrics.h"
 
 using DAIDE::MapAndUnits;
 
 void MapAndUnits::adjudicate() {
+    static MetricsHistogram &adjudication_time = MetricsRegistry::instance()->histogram(
+            "daide_adjudication_seconds", "Time taken by MapAndUnits::adjudicate()");
+    MetricsTimer adjudication_timer(adjudication_histogram != nullptr ? *adjudication_histogram : adjudication_time);
+
     if ((current_season == TOKEN_SEASON_SPR) || (current_season == TOKEN_SEASON_FAL)) {
         adjudicate_moves();
     } else if ((current_season == TOKEN_SEASON_SUM) || (current_season == TOKEN_SEASON_AUT)) {
@@ -31,6 +40,19 @@ void MapAndUnits::adjudicate_moves() {
     bool futile_convoys_checked {false};
     bool futile_and_indomtiable_convoys_checked {false};
 
+    if (move_adjudicator == INCREMENTAL_MOVE_ADJUDICATOR) {
+        adjudicate_moves_incrementally();
+        return;
+    }
+
+    // Nothing is kept for the incremental adjudicator to build on
+    adjudicated_units_valid = false;
+
+    if (move_adjudicator == DEPENDENCY_MOVE_ADJUDICATOR) {
+        adjudicate_moves_by_dependency();
+        return;
+    }
+
     initialise_move_adjudication();
 
     if (check_orders_on_adjudication) {
@@ -66,10 +88,9 @@ void MapAndUnits::adjudicate_moves() {
 }
 
 void MapAndUnits::initialise_move_adjudication() {
-    UNIT_AND_ORDER *unit {nullptr};
 
     // Clear all lists of units
-    attacker_map.clear();
+    attacker_lists.clear();
     supporting_units.clear();
     convoying_units.clear();
     convoyed_units.clear();
@@ -79,53 +100,54 @@ void MapAndUnits::initialise_move_adjudication() {
     unbalanced_head_to_heads.clear();
     bounce_locations.clear();
 
-    // Set up units to start adjudicating
     for (auto &unit_itr : units) {
-        unit = &(unit_itr.second);
-
-        unit->order_type_copy = unit->order_type;
-        unit->supports.clear();
-        unit->no_of_supports_to_dislodge = 0;
-        unit->is_support_to_dislodge = false;
-        unit->no_convoy = false;
-        unit->no_army_to_convoy = false;
-        unit->convoy_broken = false;
-        unit->support_void = false;
-        unit->support_cut = false;
-        unit->bounce = false;
-        unit->dislodged = false;
-        unit->unit_moves = false;
-        unit->move_number = NO_MOVE_NUMBER;
-        unit->illegal_order = false;
-
-        // Add unit to set according to action type
-        switch (unit->order_type) {
-
-            // Add to the attacker map
-            case MOVE_ORDER: {
-                attacker_map.insert(ATTACKER_MAP::value_type(unit->move_dest.province_index, unit_itr.first));
-                break;
-            }
+        initialise_unit_adjudication(unit_itr.first, &(unit_itr.second));
+    }
+}
 
-            case SUPPORT_TO_HOLD_ORDER:
-            case SUPPORT_TO_MOVE_ORDER: {
-                supporting_units.insert(unit_itr.first);
-                break;
-            }
+void MapAndUnits::initialise_unit_adjudication(PROVINCE_INDEX unit_province, UNIT_AND_ORDER *unit) {
+
+    // Set up the unit to start adjudicating, resetting its working state (all zero, i.e. no supports)
+    adjudication_of(unit) = UNIT_ADJUDICATION {};
+    adjudication_of(unit).order_type_copy = unit->order_type;
+    unit->no_convoy = false;
+    unit->no_army_to_convoy = false;
+    unit->convoy_broken = false;
+    unit->support_void = false;
+    unit->support_cut = false;
+    unit->bounce = false;
+    unit->dislodged = false;
+    unit->unit_moves = false;
+    adjudication_of(unit).move_number = NO_MOVE_NUMBER;
+    unit->illegal_order = false;
+
+    // Add unit to set according to action type
+    switch (unit->order_type) {
+
+        // Add to the attacker lists
+        case MOVE_ORDER: {
+            attacker_lists.insert(unit->move_dest.province_index, unit_province);
+            break;
+        }
 
-            case CONVOY_ORDER: {
-                convoying_units.insert(unit_itr.first);
-                break;
-            }
+        case SUPPORT_TO_HOLD_ORDER:
+        case SUPPORT_TO_MOVE_ORDER: {
+            supporting_units.insert(unit_province);
+            break;
+        }
 
-            case MOVE_BY_CONVOY_ORDER: {
-                convoyed_units.insert(unit_itr.first);
-                break;
-            }
+        case CONVOY_ORDER: {
+            convoying_units.insert(unit_province);
+            break;
+        }
 
-            default:
-                break;
+        case MOVE_BY_CONVOY_ORDER: {
+            convoyed_units.insert(unit_province);
+            break;
         }
+
+        default:
+            break;
     }
 }
 
@@ -147,7 +169,7 @@ void MapAndUnits::check_for_illegal_move_orders() {
 
             case MOVE_ORDER:
                 if (!can_move_to(unit_record, unit_record->move_dest)) {
-                    unit_record->order_type_copy = HOLD_ORDER;
+                    adjudication_of(unit_record).order_type_copy = HOLD_ORDER;
                     unit_record->illegal_order = true;
                     unit_record->illegal_reason = TOKEN_ORDER_NOTE_FAR;
                 }
@@ -157,13 +179,13 @@ void MapAndUnits::check_for_illegal_move_orders() {
                 supported_unit = &(units[unit_record->other_source_province]);
 
                 if (!can_move_to_province(unit_record, supported_unit->coast_id.province_index)) {
-                    unit_record->order_type_copy = HOLD_ORDER;
+                    adjudication_of(unit_record).order_type_copy = HOLD_ORDER;
                     unit_record->illegal_order = true;
                     unit_record->illegal_reason = TOKEN_ORDER_NOTE_FAR;
 
                 // Check it isn't trying to support itself
                 } else if (supported_unit->coast_id.province_index == unit_record->coast_id.province_index) {
-                    unit_record->order_type_copy = HOLD_ORDER;
+                    adjudication_of(unit_record).order_type_copy = HOLD_ORDER;
                     unit_record->illegal_order = true;
                     unit_record->illegal_reason = TOKEN_ORDER_NOTE_FAR;
                 }
@@ -171,13 +193,13 @@ void MapAndUnits::check_for_illegal_move_orders() {
 
             case SUPPORT_TO_MOVE_ORDER:
                 if (!can_move_to_province(unit_record, unit_record->other_dest_province)) {
-                    unit_record->order_type_copy = HOLD_ORDER;
+                    adjudication_of(unit_record).order_type_copy = HOLD_ORDER;
                     unit_record->illegal_order = true;
                     unit_record->illegal_reason = TOKEN_ORDER_NOTE_FAR;
 
                 // Check it isn't trying to support itself
                 } else if (supported_unit->coast_id.province_index == unit_record->coast_id.province_index) {
-                    unit_record->order_type_copy = HOLD_ORDER;
+                    adjudication_of(unit_record).order_type_copy = HOLD_ORDER;
                     unit_record->illegal_order = true;
                     unit_record->illegal_reason = TOKEN_ORDER_NOTE_FAR;
                 }
@@ -187,15 +209,15 @@ void MapAndUnits::check_for_illegal_move_orders() {
                 convoyed_unit = &(units[unit_record->other_source_province]);
 
                 if (unit_record->unit_type != TOKEN_UNIT_FLT) {
-                    unit_record->order_type_copy = HOLD_ORDER;
+                    adjudication_of(unit_record).order_type_copy = HOLD_ORDER;
                     unit_record->illegal_order = true;
                     unit_record->illegal_reason = TOKEN_ORDER_NOTE_NSF;
                 } else if (game_map[unit_record->coast_id.province_index].is_land) {
-                    unit_record->order_type_copy = HOLD_ORDER;
+                    adjudication_of(unit_record).order_type_copy = HOLD_ORDER;
                     unit_record->illegal_order = true;
                     unit_record->illegal_reason = TOKEN_ORDER_NOTE_NAS;
                 } else if (convoyed_unit->unit_type != TOKEN_UNIT_AMY) {
-                    unit_record->order_type_copy = HOLD_ORDER;
+                    adjudication_of(unit_record).order_type_copy = HOLD_ORDER;
                     unit_record->illegal_order = true;
                     unit_record->illegal_reason = TOKEN_ORDER_NOTE_NSA;
                 }
@@ -206,7 +228,7 @@ void MapAndUnits::check_for_illegal_move_orders() {
 
                 // Armies can't move by convoy
                 if (unit_record->unit_type != TOKEN_UNIT_AMY) {
-                    unit_record->order_type_copy = HOLD_ORDER;
+                    adjudication_of(unit_record).order_type_copy = HOLD_ORDER;
                     unit_record->illegal_order = true;
                     unit_record->illegal_reason = TOKEN_ORDER_NOTE_NSA;
 
@@ -227,15 +249,15 @@ void MapAndUnits::check_for_illegal_move_orders() {
                         }
 
                         if (convoying_unit == nullptr) {
-                            unit_record->order_type_copy = HOLD_ORDER;
+                            adjudication_of(unit_record).order_type_copy = HOLD_ORDER;
                             unit_record->illegal_order = true;
                             unit_record->illegal_reason = TOKEN_ORDER_NOTE_NSF;
                         } else if (game_map[convoying_unit->coast_id.province_index].is_land) {
-                            unit_record->order_type_copy = HOLD_ORDER;
+                            adjudication_of(unit_record).order_type_copy = HOLD_ORDER;
                             unit_record->illegal_order = true;
                             unit_record->illegal_reason = TOKEN_ORDER_NOTE_NAS;
                         } else if (!can_move_to_province(convoying_unit, previous_province)) {
-                            unit_record->order_type_copy = HOLD_ORDER;
+                            adjudication_of(unit_record).order_type_copy = HOLD_ORDER;
                             unit_record->illegal_order = true;
                             unit_record->illegal_reason = TOKEN_ORDER_NOTE_FAR;
                         }
@@ -244,7 +266,7 @@ void MapAndUnits::check_for_illegal_move_orders() {
 
                 if (!unit_record->illegal_order) {
                     if (!can_move_to_province(convoying_unit, unit_record->other_dest_province)) {
-                        unit_record->order_type_copy = HOLD_ORDER;
+                        adjudication_of(unit_record).order_type_copy = HOLD_ORDER;
                         unit_record->illegal_order = true;
                         unit_record->illegal_reason = TOKEN_ORDER_NOTE_FAR;
                     }
@@ -252,7 +274,7 @@ void MapAndUnits::check_for_illegal_move_orders() {
 
                 if (!unit_record->illegal_order) {
                     if (unit_record->move_dest.province_index == unit_record->coast_id.province_index) {
-                        unit_record->order_type_copy = HOLD_ORDER;
+                        adjudication_of(unit_record).order_type_copy = HOLD_ORDER;
                         unit_record->illegal_order = true;
                         unit_record->illegal_reason = TOKEN_ORDER_NOTE_FAR;
                     }
@@ -261,7 +283,7 @@ void MapAndUnits::check_for_illegal_move_orders() {
 
             // Otherwise, it becomes a hold order
             default:
-                unit_record->order_type_copy = HOLD_ORDER;
+                adjudication_of(unit_record).order_type_copy = HOLD_ORDER;
                 break;
         }
     }
@@ -289,7 +311,7 @@ void MapAndUnits::cancel_inconsistent_convoys() {
             } else {
                 convoying_unit = &(unit_itr->second);
 
-                if ((convoying_unit->order_type_copy != CONVOY_ORDER)
+                if ((adjudication_of(convoying_unit).order_type_copy != CONVOY_ORDER)
                     || (convoying_unit->other_source_province != convoyed_unit->coast_id.province_index)
                     || (convoying_unit->other_dest_province != convoyed_unit->move_dest.province_index)) {
                     order_ok = false;
@@ -298,7 +320,7 @@ void MapAndUnits::cancel_inconsistent_convoys() {
         }
 
         if (!order_ok) {
-            convoyed_unit->order_type_copy = HOLD_NO_SUPPORT_ORDER;
+            adjudication_of(convoyed_unit).order_type_copy = HOLD_NO_SUPPORT_ORDER;
             convoyed_unit->no_convoy = true;
             convoyed_unit_itr = convoyed_units.erase(convoyed_unit_itr);
         } else {
@@ -324,7 +346,7 @@ void MapAndUnits::cancel_inconsistent_convoys() {
                 || (convoyed_unit->move_dest.province_index != convoying_unit->other_dest_province)) {
                 convoying_unit->no_army_to_convoy = true;
                 order_ok = false;
-            } else if (convoyed_unit->order_type_copy != MOVE_BY_CONVOY_ORDER) {
+            } else if (adjudication_of(convoyed_unit).order_type_copy != MOVE_BY_CONVOY_ORDER) {
                 // Army was ordered to convoy, but other fleets failed to make up the chain.
                 order_ok = false;
             }
@@ -332,7 +354,7 @@ void MapAndUnits::cancel_inconsistent_convoys() {
 
         if (!order_ok) {
             convoying_unit->no_army_to_convoy = true;
-            convoying_unit->order_type_copy = HOLD_ORDER;
+            adjudication_of(convoying_unit).order_type_copy = HOLD_ORDER;
             convoying_unit_itr = convoying_units.erase(convoying_unit_itr);
         } else {
             convoying_unit_itr++;
@@ -364,10 +386,10 @@ void MapAndUnits::cancel_inconsistent_supports() {
         } else {
             supported_unit = &(supported_unit_itr->second);
 
-            if (supporting_unit->order_type_copy == SUPPORT_TO_HOLD_ORDER) {
-                if ((supported_unit->order_type_copy == MOVE_ORDER)
-                    || (supported_unit->order_type_copy == MOVE_BY_CONVOY_ORDER)
-                    || (supported_unit->order_type_copy == HOLD_NO_SUPPORT_ORDER)) {
+            if (adjudication_of(supporting_unit).order_type_copy == SUPPORT_TO_HOLD_ORDER) {
+                if ((adjudication_of(supported_unit).order_type_copy == MOVE_ORDER)
+                    || (adjudication_of(supported_unit).order_type_copy == MOVE_BY_CONVOY_ORDER)
+                    || (adjudication_of(supported_unit).order_type_copy == HOLD_NO_SUPPORT_ORDER)) {
                     order_ok = false;
                     supporting_unit->support_void = true;
                 }
@@ -377,8 +399,8 @@ void MapAndUnits::cancel_inconsistent_supports() {
                     || (supported_unit->move_dest.province_index != supporting_unit->other_dest_province)) {
                     order_ok = false;
                     supporting_unit->support_void = true;
-                } else if ((supported_unit->order_type_copy != MOVE_ORDER)
-                           && (supported_unit->order_type_copy != MOVE_BY_CONVOY_ORDER)) {
+                } else if ((adjudication_of(supported_unit).order_type_copy != MOVE_ORDER)
+                           && (adjudication_of(supported_unit).order_type_copy != MOVE_BY_CONVOY_ORDER)) {
                     // Unit was ordered to move correctly, but move already failed
                     order_ok = false;
                 }
@@ -386,7 +408,7 @@ void MapAndUnits::cancel_inconsistent_supports() {
         }
 
         if (!order_ok) {
-            supporting_unit->order_type_copy = HOLD_ORDER;
+            adjudication_of(supporting_unit).order_type_copy = HOLD_ORDER;
             supporting_unit_itr = supporting_units.erase(supporting_unit_itr);
         } else {
             supporting_unit_itr++;
@@ -399,22 +421,24 @@ void MapAndUnits::direct_attacks_cut_support() {
     UNIT_AND_ORDER *attacked_unit {nullptr};
 
     // For each moving unit, find the unit it is attacking
-    for (auto &moving_unit_itr : attacker_map) {
-        moving_unit = &(units[moving_unit_itr.second]);
-        auto attacked_unit_itr = units.find(moving_unit->move_dest.province_index);
+    for (PROVINCE_INDEX attacked_province : attacker_lists.get_attacked_provinces()) {
+        for (PROVINCE_INDEX moving_unit_province : attacker_lists.get_attackers(attacked_province)) {
+            moving_unit = &(units[moving_unit_province]);
+            auto attacked_unit_itr = units.find(moving_unit->move_dest.province_index);
 
-        if (attacked_unit_itr != units.end()) {
-            attacked_unit = &(attacked_unit_itr->second);
+            if (attacked_unit_itr != units.end()) {
+                attacked_unit = &(attacked_unit_itr->second);
 
-            // If there is an attacked unit, and it is supporting, then consider cutting support
-            if (attacked_unit->nationality != moving_unit->nationality) {
-                if ((attacked_unit->order_type_copy == SUPPORT_TO_HOLD_ORDER)
-                    || ((attacked_unit->order_type_copy == SUPPORT_TO_MOVE_ORDER)
-                        && (attacked_unit->other_dest_province != moving_unit->coast_id.province_index))) {
-                    // Support is cut
-                    attacked_unit->support_cut = true;
-                    attacked_unit->order_type_copy = HOLD_ORDER;
-                    supporting_units.erase(attacked_unit->coast_id.province_index);
+                // If there is an attacked unit, and it is supporting, then consider cutting support
+                if (attacked_unit->nationality != moving_unit->nationality) {
+                    if ((adjudication_of(attacked_unit).order_type_copy == SUPPORT_TO_HOLD_ORDER)
+                        || ((adjudication_of(attacked_unit).order_type_copy == SUPPORT_TO_MOVE_ORDER)
+                            && (attacked_unit->other_dest_province != moving_unit->coast_id.province_index))) {
+                        // Support is cut
+                        attacked_unit->support_cut = true;
+                        adjudication_of(attacked_unit).order_type_copy = HOLD_ORDER;
+                        supporting_units.erase(attacked_unit->coast_id.province_index);
+                    }
                 }
             }
         }
@@ -431,22 +455,22 @@ void MapAndUnits::build_support_lists() {
 
         supporting_unit = &(units[supporting_unit_itr]);
         supported_unit = &(units[supporting_unit->other_source_province]);
-        supported_unit->supports.insert(supporting_unit_itr);
+        adjudication_of(supported_unit).supports.insert(supporting_unit_itr);
 
         // Check if the support is valid for dislodgement
-        if (supporting_unit->order_type_copy == SUPPORT_TO_MOVE_ORDER) {
+        if (adjudication_of(supporting_unit).order_type_copy == SUPPORT_TO_MOVE_ORDER) {
             auto attacked_unit_itr = units.find(supporting_unit->other_dest_province);
 
             if (attacked_unit_itr == units.end()) {
-                supporting_unit->is_support_to_dislodge = true;
-                supported_unit->no_of_supports_to_dislodge++;
+                adjudication_of(supporting_unit).is_support_to_dislodge = true;
+                adjudication_of(supported_unit).no_of_supports_to_dislodge++;
             } else {
                 attacked_unit = &(attacked_unit_itr->second);
 
                 if ((supporting_unit->nationality != attacked_unit->nationality)
                     && (supported_unit->nationality != attacked_unit->nationality)) {
-                    supporting_unit->is_support_to_dislodge = true;
-                    supported_unit->no_of_supports_to_dislodge++;
+                    adjudication_of(supporting_unit).is_support_to_dislodge = true;
+                    adjudication_of(supported_unit).no_of_supports_to_dislodge++;
                 }
             }
         }
@@ -480,22 +504,24 @@ void MapAndUnits::build_convoy_subversion_list() {
             attacked_unit = &(attacked_unit_itr->second);
 
             if (attacked_unit->nationality != convoyed_unit->nationality) {
-                if (attacked_unit->order_type_copy == SUPPORT_TO_HOLD_ORDER) {
+                if (adjudication_of(attacked_unit).order_type_copy == SUPPORT_TO_HOLD_ORDER) {
                     supported_unit = &(units[attacked_unit->other_source_province]);
 
                     // We have subversion
-                    if (supported_unit->order_type_copy == CONVOY_ORDER) {
+                    if ((adjudication_of(supported_unit).order_type_copy == CONVOY_ORDER)
+                        && is_on_convoy_route(supported_unit)) {
                         convoy_subversion.subverted_convoy_army = supported_unit->other_source_province;
                     }
 
-                } else if (attacked_unit->order_type_copy == SUPPORT_TO_MOVE_ORDER) {
+                } else if (adjudication_of(attacked_unit).order_type_copy == SUPPORT_TO_MOVE_ORDER) {
                     auto support_against_itr = units.find(attacked_unit->other_dest_province);
 
                     if (support_against_itr != units.end()) {
                         support_against_unit = &(support_against_itr->second);
 
                         // We have subversion
-                        if (support_against_unit->order_type_copy == CONVOY_ORDER) {
+                        if ((adjudication_of(support_against_unit).order_type_copy == CONVOY_ORDER)
+                            && is_on_convoy_route(support_against_unit)) {
                             convoy_subversion.subverted_convoy_army = support_against_unit->other_source_province;
                         }
                     }
@@ -552,23 +578,22 @@ bool MapAndUnits::resolve_attacks_on_non_subverted_convoys() {
             if (convoy_broken) {
                 for (int &convoying_fleet_itr : convoyed_army->convoy_step_list) {
                     convoying_fleet = &(units[convoying_fleet_itr]);
-                    convoying_fleet->order_type_copy = HOLD_ORDER;
+                    adjudication_of(convoying_fleet).order_type_copy = HOLD_ORDER;
                 }
 
-                convoyed_army->order_type_copy = HOLD_NO_SUPPORT_ORDER;
+                adjudication_of(convoyed_army).order_type_copy = HOLD_NO_SUPPORT_ORDER;
                 convoyed_army->convoy_broken = true;
 
                 // All supports for this army are now invalid
-                convoyed_army->supports.clear();
-                convoyed_army->no_of_supports_to_dislodge = 0;
+                adjudication_of(convoyed_army).supports.clear();
+                adjudication_of(convoyed_army).no_of_supports_to_dislodge = 0;
 
             } else {
                 // Convoy is not broken, so cut any support it is attacking
-                cut_support(convoyed_army->move_dest.province_index);
+                convoyed_attack_cuts_support(convoyed_army);
 
                 // Add convoyed attack to list of attacks on destination province
-                attacker_map.insert(ATTACKER_MAP::value_type(convoyed_army->move_dest.province_index,
-                                                             convoyed_army->coast_id.province_index));
+                attacker_lists.insert(convoyed_army->move_dest.province_index, convoyed_army->coast_id.province_index);
             }
 
             // If the convoy was subverting another, then it doesn't any more
@@ -619,7 +644,7 @@ bool MapAndUnits::check_for_futile_convoys() {
             convoyed_army = &(units[convoyed_army_province]);
             attacked_unit = &(units[convoyed_army->move_dest.province_index]);
 
-            if (attacked_unit->order_type_copy == SUPPORT_TO_HOLD_ORDER) {
+            if (adjudication_of(attacked_unit).order_type_copy == SUPPORT_TO_HOLD_ORDER) {
                 subverted_province = attacked_unit->other_source_province;
             } else {
                 subverted_province = attacked_unit->other_dest_province;
@@ -643,15 +668,15 @@ bool MapAndUnits::check_for_futile_convoys() {
             if (convoy_broken) {
                 for (int & convoying_fleet_itr : subverted_convoy_army->convoy_step_list) {
                     convoying_fleet = &(units[convoying_fleet_itr]);
-                    convoying_fleet->order_type_copy = HOLD_ORDER;
+                    adjudication_of(convoying_fleet).order_type_copy = HOLD_ORDER;
                 }
 
-                subverted_convoy_army->order_type_copy = HOLD_NO_SUPPORT_ORDER;
+                adjudication_of(subverted_convoy_army).order_type_copy = HOLD_NO_SUPPORT_ORDER;
                 subverted_convoy_army->convoy_broken = true;
 
                 // All supports for this army are now invalid
-                subverted_convoy_army->supports.clear();
-                subverted_convoy_army->no_of_supports_to_dislodge = 0;
+                adjudication_of(subverted_convoy_army).supports.clear();
+                adjudication_of(subverted_convoy_army).no_of_supports_to_dislodge = 0;
 
                 // Find the convoy this convoy was subverting. It is no longer subverted.
                 broken_convoy_subversion_record = &(convoy_subversions[subverted_convoy_army_index]);
@@ -703,7 +728,7 @@ bool MapAndUnits::check_for_indomitable_and_futile_convoys() {
             convoyed_army = &(units[convoyed_army_province]);
             attacked_unit = &(units[convoyed_army->move_dest.province_index]);
 
-            if (attacked_unit->order_type_copy == SUPPORT_TO_HOLD_ORDER) {
+            if (adjudication_of(attacked_unit).order_type_copy == SUPPORT_TO_HOLD_ORDER) {
                 subverted_province = attacked_unit->other_source_province;
                 supported_fleet = &(units[subverted_province]);
             } else {
@@ -719,18 +744,18 @@ bool MapAndUnits::check_for_indomitable_and_futile_convoys() {
             dislodging_unit_if_not_cut = find_dislodging_unit(subverted_province);
 
             // Temporarily remove the support of the attacked unit
-            supported_fleet->supports.erase(attacked_unit->coast_id.province_index);
-            if (attacked_unit->is_support_to_dislodge) {
-                supported_fleet->no_of_supports_to_dislodge--;
+            adjudication_of(supported_fleet).supports.erase(attacked_unit->coast_id.province_index);
+            if (adjudication_of(attacked_unit).is_support_to_dislodge) {
+                adjudication_of(supported_fleet).no_of_supports_to_dislodge--;
             }
 
             // Find the dislodging unit with support cut
             dislodging_unit_if_cut = find_dislodging_unit(subverted_province);
 
             // Reinstate the support of the attacked unit
-            supported_fleet->supports.insert(attacked_unit->coast_id.province_index);
-            if (attacked_unit->is_support_to_dislodge) {
-                supported_fleet->no_of_supports_to_dislodge++;
+            adjudication_of(supported_fleet).supports.insert(attacked_unit->coast_id.province_index);
+            if (adjudication_of(attacked_unit).is_support_to_dislodge) {
+                adjudication_of(supported_fleet).no_of_supports_to_dislodge++;
             }
 
             if (dislodging_unit_if_not_cut != NO_DISLODGING_UNIT) {
@@ -739,15 +764,15 @@ bool MapAndUnits::check_for_indomitable_and_futile_convoys() {
                     // Convoy is futile
                     for (int & convoying_fleet_itr : subverted_convoy_army->convoy_step_list) {
                         convoying_fleet = &(units[convoying_fleet_itr]);
-                        convoying_fleet->order_type_copy = HOLD_ORDER;
+                        adjudication_of(convoying_fleet).order_type_copy = HOLD_ORDER;
                     }
 
-                    subverted_convoy_army->order_type_copy = HOLD_NO_SUPPORT_ORDER;
+                    adjudication_of(subverted_convoy_army).order_type_copy = HOLD_NO_SUPPORT_ORDER;
                     subverted_convoy_army->convoy_broken = true;
 
                     // All supports for this army are now invalid
-                    subverted_convoy_army->supports.clear();
-                    subverted_convoy_army->no_of_supports_to_dislodge = 0;
+                    adjudication_of(subverted_convoy_army).supports.clear();
+                    adjudication_of(subverted_convoy_army).no_of_supports_to_dislodge = 0;
 
                     // Find the convoy this convoy was subverting. It is no longer subverted.
                     broken_convoy_subversion_record = &(convoy_subversions[subverted_convoy_army_index]);
@@ -777,11 +802,11 @@ bool MapAndUnits::check_for_indomitable_and_futile_convoys() {
                 // Convoy is indomitable
                 } else {
                     // Convoy is not broken, so cut any support it is attacking
-                    cut_support(subverted_convoy_army->move_dest.province_index);
+                    convoyed_attack_cuts_support(subverted_convoy_army);
 
                     // Add convoyed attack to list of attacks on destination province
-                    attacker_map.insert(ATTACKER_MAP::value_type(subverted_convoy_army->move_dest.province_index,
-                                                                 subverted_convoy_army->coast_id.province_index));
+                    attacker_lists.insert(subverted_convoy_army->move_dest.province_index,
+                                          subverted_convoy_army->coast_id.province_index);
 
                     // Find the convoy this convoy was subverting. It is no longer subverted.
                     broken_convoy_subversion_record = &(convoy_subversions[subverted_convoy_army_index]);
@@ -843,21 +868,19 @@ void MapAndUnits::resolve_circles_of_subversion() {
 
                 for (int &convoying_fleet_itr : convoyed_army->convoy_step_list) {
 
-                    for (auto attacking_unit_itr = attacker_map.lower_bound(convoying_fleet_itr);
-                         attacking_unit_itr != attacker_map.upper_bound(convoying_fleet_itr);
-                         attacking_unit_itr++) {
+                    for (PROVINCE_INDEX attacking_unit_province : attacker_lists.get_attackers(convoying_fleet_itr)) {
 
                         // For all attacking units, reset to hold, and cancel all supports
-                        attacking_unit = &(units[attacking_unit_itr->second]);
+                        attacking_unit = &(units[attacking_unit_province]);
 
-                        attacking_unit->order_type_copy = HOLD_NO_SUPPORT_ORDER;
-                        attacking_unit->supports.clear();
-                        attacking_unit->no_of_supports_to_dislodge = 0;
+                        adjudication_of(attacking_unit).order_type_copy = HOLD_NO_SUPPORT_ORDER;
+                        adjudication_of(attacking_unit).supports.clear();
+                        adjudication_of(attacking_unit).no_of_supports_to_dislodge = 0;
                         attacking_unit->bounce = true;
                     }
 
-                    // Remove these attacks from the attacker map
-                    attacker_map.erase(convoying_fleet_itr);
+                    // Remove these attacks from the attacker lists
+                    attacker_lists.erase(convoying_fleet_itr);
                 }
 
                 // Move to the next item in the chain
@@ -876,15 +899,15 @@ void MapAndUnits::resolve_circles_of_subversion() {
 
             for (int & convoying_fleet_itr : convoyed_army->convoy_step_list) {
                 convoying_fleet = &(units[convoying_fleet_itr]);
-                convoying_fleet->order_type_copy = HOLD_ORDER;
+                adjudication_of(convoying_fleet).order_type_copy = HOLD_ORDER;
             }
 
-            convoyed_army->order_type_copy = HOLD_NO_SUPPORT_ORDER;
+            adjudication_of(convoyed_army).order_type_copy = HOLD_NO_SUPPORT_ORDER;
             convoyed_army->convoy_broken = true;
 
             // All supports for this army are now invalid
-            convoyed_army->supports.clear();
-            convoyed_army->no_of_supports_to_dislodge = 0;
+            adjudication_of(convoyed_army).supports.clear();
+            adjudication_of(convoyed_army).no_of_supports_to_dislodge = 0;
 
             // Move to the next item in the chain, and delete this one
             next_convoyed_army = convoy_subversion_itr->second.subverted_convoy_army;
@@ -909,68 +932,73 @@ void MapAndUnits::identify_rings_of_attack_and_head_to_head_battles() {
     UNIT_AND_ORDER *moving_unit {nullptr};
     UNIT_AND_ORDER *other_moving_unit {nullptr};
 
-    // Go through each unit in the attacker map
-    for (auto &moving_unit_itr : attacker_map) {
-        moving_unit = &(units[moving_unit_itr.second]);
-        chain_start = move_ctr;
-        last_convoy = NO_MOVE_NUMBER;
-        chain_end_found = false;
-        loop_found = false;
-
-        // Follow the chain of unit attacking another unit
-        while (!chain_end_found) {
-            // If we find a unit with a number, we've branched into a chain we've already considered
-            if (moving_unit->move_number != NO_MOVE_NUMBER) {
-                chain_end_found = true;
-
-                // If it is this chain, we have a loop
-                if (moving_unit->move_number >= chain_start) {
-                    loop_found = true;
-                }
+    // Go through each unit in the attacker lists
+    for (PROVINCE_INDEX attacked_province : attacker_lists.get_attacked_provinces()) {
+        for (PROVINCE_INDEX moving_unit_province : attacker_lists.get_attackers(attacked_province)) {
+            moving_unit = &(units[moving_unit_province]);
+            chain_start = move_ctr;
+            last_convoy = NO_MOVE_NUMBER;
+            chain_end_found = false;
+            loop_found = false;
+
+            // Follow the chain of unit attacking another unit
+            while (!chain_end_found) {
+                // If we find a unit with a number, we've branched into a chain we've already considered
+                if (adjudication_of(moving_unit).move_number != NO_MOVE_NUMBER) {
+                    chain_end_found = true;
 
-            // If we find a non-moving unit, it is the end of the chain
-            } else if ((moving_unit->order_type_copy != MOVE_ORDER)
-                       && (moving_unit->order_type_copy != MOVE_BY_CONVOY_ORDER)) {
-                chain_end_found = true;
+                    // If it is this chain, we have a loop
+                    if (adjudication_of(moving_unit).move_number >= chain_start) {
+                        loop_found = true;
+                    }
 
-            } else {
-                // Number the move so we know which chain it is in
-                moving_unit->move_number = move_ctr;
+                // If we find a non-moving unit, it is the end of the chain
+                } else if ((adjudication_of(moving_unit).order_type_copy != MOVE_ORDER)
+                           && (adjudication_of(moving_unit).order_type_copy != MOVE_BY_CONVOY_ORDER)) {
+                    chain_end_found = true;
 
-                if (moving_unit->order_type_copy == MOVE_BY_CONVOY_ORDER) {
-                    last_convoy = move_ctr;
-                }
+                } else {
+                    // Number the move so we know which chain it is in
+                    adjudication_of(moving_unit).move_number = move_ctr;
 
-                move_ctr++;
+                    if (adjudication_of(moving_unit).order_type_copy == MOVE_BY_CONVOY_ORDER) {
+                        last_convoy = move_ctr;
+                    }
 
-                // Find the next unit in the chain
-                auto next_unit_itr = units.find(moving_unit->move_dest.province_index);
+                    move_ctr++;
 
-                // If there isn't one, chain ends
-                if (next_unit_itr == units.end()) {
-                    chain_end_found = true;
-                } else {
-                    moving_unit = &(next_unit_itr->second);
+                    // Find the next unit in the chain
+                    auto next_unit_itr = units.find(moving_unit->move_dest.province_index);
+
+                    // If there isn't one, chain ends
+                    if (next_unit_itr == units.end()) {
+                        chain_end_found = true;
+                    } else {
+                        moving_unit = &(next_unit_itr->second);
+                    }
                 }
             }
-        }
 
-        if (loop_found) {
+            if (loop_found) {
 
-            // Ring of attacks
-            if ((move_ctr - moving_unit->move_number >= 3) || (last_convoy >= moving_unit->move_number)) {
-                rings_of_attack.insert(moving_unit->coast_id.province_index);
+                // Ring of attacks
+                if ((move_ctr - adjudication_of(moving_unit).move_number >= 3)
+                    || (last_convoy >= adjudication_of(moving_unit).move_number)) {
+                    rings_of_attack.insert(moving_unit->coast_id.province_index);
 
-            // Head to head. Determine if balanced or unbalanced
-            } else {
-                other_moving_unit = &(units[moving_unit->move_dest.province_index]);
-
-                if (moving_unit->no_of_supports_to_dislodge > other_moving_unit->supports.size()) {
-                    unbalanced_head_to_heads.insert(moving_unit->coast_id.province_index);
-                } else if (other_moving_unit->no_of_supports_to_dislodge > moving_unit->supports.size()) {
-                    unbalanced_head_to_heads.insert(other_moving_unit->coast_id.province_index);
+                // Head to head. Determine if balanced or unbalanced
                 } else {
-                    balanced_head_to_heads.insert(moving_unit->coast_id.province_index);
+                    other_moving_unit = &(units[moving_unit->move_dest.province_index]);
+
+                    if (adjudication_of(moving_unit).no_of_supports_to_dislodge
+                        > number_of_supports(other_moving_unit)) {
+                        unbalanced_head_to_heads.insert(moving_unit->coast_id.province_index);
+                    } else if (adjudication_of(other_moving_unit).no_of_supports_to_dislodge
+                               > number_of_supports(moving_unit)) {
+                        unbalanced_head_to_heads.insert(other_moving_unit->coast_id.province_index);
+                    } else {
+                        balanced_head_to_heads.insert(moving_unit->coast_id.province_index);
+                    }
                 }
             }
         }
@@ -981,32 +1009,34 @@ void MapAndUnits::advance_rings_of_attack() {
     int first_province {-1};
     const PROVINCE_INDEX NO_RING_BREAKER {-1};
     PROVINCE_INDEX ring_breaking_unit {-1};
-    UNIT_LIST units_in_ring {};
-    UNIT_LIST::iterator ring_breaking_unit_itr;
+    PROVINCE_INDEX units_in_ring[MAX_PROVINCES];
+    int number_of_units_in_ring {0};
+    int ring_breaking_unit_ctr {0};
     UNIT_AND_ORDER *ring_unit {nullptr};
 
     // For each ring of attack
     for (int ring_set_itr : rings_of_attack) {
 
-        // Build the list of units in the ring, in reverse order, and work out the status of each
+        // Build the list of units in the ring, in order, and work out the status of each. Working backwards
+        // through the ring is then working down the list.
         first_province = ring_set_itr;
         ring_unit = &(units[first_province]);
 
-        units_in_ring.clear();
+        number_of_units_in_ring = 0;
         ring_breaking_unit = NO_RING_BREAKER;
 
         do {
-            units_in_ring.push_front(ring_unit->coast_id.province_index);
+            units_in_ring[number_of_units_in_ring++] = ring_unit->coast_id.province_index;
 
-            ring_unit->ring_unit_status = determine_ring_status(ring_unit->move_dest.province_index,
+            adjudication_of(ring_unit).ring_unit_status = determine_ring_status(ring_unit->move_dest.province_index,
                                                                 ring_unit->coast_id.province_index);
 
             // If this unit can't advance, then it is the ring breaker
-            if ((ring_unit->ring_unit_status != RING_ADVANCES_REGARDLESS)
-                 && (ring_unit->ring_unit_status != RING_ADVANCES_IF_VACANT)) {
+            if ((adjudication_of(ring_unit).ring_unit_status != RING_ADVANCES_REGARDLESS)
+                 && (adjudication_of(ring_unit).ring_unit_status != RING_ADVANCES_IF_VACANT)) {
 
                 ring_breaking_unit = ring_unit->coast_id.province_index;
-                ring_breaking_unit_itr = units_in_ring.begin();
+                ring_breaking_unit_ctr = number_of_units_in_ring - 1;
             }
 
             ring_unit = &(units[ring_unit->move_dest.province_index]);
@@ -1014,54 +1044,50 @@ void MapAndUnits::advance_rings_of_attack() {
 
         // Every unit in the ring advances
         if (ring_breaking_unit == NO_RING_BREAKER) {
-            for (int & ring_itr : units_in_ring) {
-                advance_unit(ring_itr);
+            for (int ring_ctr = number_of_units_in_ring - 1; ring_ctr >= 0; ring_ctr--) {
+                advance_unit(units_in_ring[ring_ctr]);
             }
 
         // Check on the ring status of the ring breaker
         } else {
             ring_unit = &(units[ring_breaking_unit]);
 
-            if (ring_unit->ring_unit_status == STANDOFF_REGARDLESS) {
+            if (adjudication_of(ring_unit).ring_unit_status == STANDOFF_REGARDLESS) {
                 bounce_all_attacks_on_province(ring_unit->move_dest.province_index);
-            } else if (ring_unit->ring_unit_status == SIDE_ADVANCES_REGARDLESS) {
+            } else if (adjudication_of(ring_unit).ring_unit_status == SIDE_ADVANCES_REGARDLESS) {
                 bounce_attack(ring_unit);
 
             // We don't know what happens in province this unit is moving into. Work backwards
             } else {
-                ring_breaking_unit_itr++;
-
-                if (ring_breaking_unit_itr == units_in_ring.end()) {
-                    ring_breaking_unit_itr = units_in_ring.begin();
+                if (--ring_breaking_unit_ctr < 0) {
+                    ring_breaking_unit_ctr = number_of_units_in_ring - 1;
                 }
 
-                ring_unit = &(units[*ring_breaking_unit_itr]);
+                ring_unit = &(units[units_in_ring[ring_breaking_unit_ctr]]);
 
                 // We know the unit ahead of this one is not moving. Determine what happens to this one
-                if (ring_unit->ring_unit_status == SIDE_ADVANCES_REGARDLESS) {
+                if (adjudication_of(ring_unit).ring_unit_status == SIDE_ADVANCES_REGARDLESS) {
                     bounce_attack(ring_unit);
-                } else if (ring_unit->ring_unit_status != RING_ADVANCES_REGARDLESS) {
+                } else if (adjudication_of(ring_unit).ring_unit_status != RING_ADVANCES_REGARDLESS) {
                     bounce_all_attacks_on_province(ring_unit->move_dest.province_index);
 
                 // This unit will advance. Work backwards until we find one that won't
                 } else {
                     do {
-                        ring_breaking_unit_itr++;
-
-                        if (ring_breaking_unit_itr == units_in_ring.end()) {
-                            ring_breaking_unit_itr = units_in_ring.begin();
+                        if (--ring_breaking_unit_ctr < 0) {
+                            ring_breaking_unit_ctr = number_of_units_in_ring - 1;
                         }
 
-                        ring_unit = &(units[*ring_breaking_unit_itr]);
+                        ring_unit = &(units[units_in_ring[ring_breaking_unit_ctr]]);
 
-                        if ((ring_unit->ring_unit_status == SIDE_ADVANCES_REGARDLESS)
-                            || (ring_unit->ring_unit_status == SIDE_ADVANCES_IF_VACANT)) {
+                        if ((adjudication_of(ring_unit).ring_unit_status == SIDE_ADVANCES_REGARDLESS)
+                            || (adjudication_of(ring_unit).ring_unit_status == SIDE_ADVANCES_IF_VACANT)) {
                             bounce_attack(ring_unit);
-                        } else if (ring_unit->ring_unit_status == STANDOFF_REGARDLESS) {
+                        } else if (adjudication_of(ring_unit).ring_unit_status == STANDOFF_REGARDLESS) {
                             bounce_all_attacks_on_province(ring_unit->move_dest.province_index);
                         }
-                    } while ((ring_unit->ring_unit_status == RING_ADVANCES_IF_VACANT)
-                             || (ring_unit->ring_unit_status == RING_ADVANCES_REGARDLESS));
+                    } while ((adjudication_of(ring_unit).ring_unit_status == RING_ADVANCES_IF_VACANT)
+                             || (adjudication_of(ring_unit).ring_unit_status == RING_ADVANCES_REGARDLESS));
                 }
             }
         }
@@ -1078,19 +1104,16 @@ MapAndUnits::determine_ring_status(PROVINCE_INDEX province, PROVINCE_INDEX ring_
     UNIT_AND_ORDER *attacking_unit {nullptr};
 
     // Find the strength of the most supported and second most supported unit
-    for (auto attacking_unit_itr = attacker_map.lower_bound(province);
-         attacking_unit_itr != attacker_map.upper_bound(province);
-         attacking_unit_itr++) {
+    for (PROVINCE_INDEX attacking_unit_province : attacker_lists.get_attackers(province)) {
+        attacking_unit = &(units[attacking_unit_province]);
 
-        attacking_unit = &(units[attacking_unit_itr->second]);
-
-        if (attacking_unit->supports.size() > most_supports) {
+        if (number_of_supports(attacking_unit) > most_supports) {
             second_most_supports = most_supports;
-            most_supports = attacking_unit->supports.size();
-            most_supports_to_dislodge = attacking_unit->no_of_supports_to_dislodge;
-            most_supported_unit = attacking_unit_itr->second;
-        } else if (attacking_unit->supports.size() > second_most_supports) {
-            second_most_supports = attacking_unit->supports.size();
+            most_supports = number_of_supports(attacking_unit);
+            most_supports_to_dislodge = adjudication_of(attacking_unit).no_of_supports_to_dislodge;
+            most_supported_unit = attacking_unit_province;
+        } else if (number_of_supports(attacking_unit) > second_most_supports) {
+            second_most_supports = number_of_supports(attacking_unit);
         }
     }
 
@@ -1125,39 +1148,33 @@ void MapAndUnits::advance_unit(PROVINCE_INDEX unit_to_advance) {
     moving_unit->unit_moves = true;
 
     // Cancel all other moves into the province it is moving into
-    for (auto attacker_itr = attacker_map.lower_bound(attacked_province);
-         attacker_itr != attacker_map.upper_bound(attacked_province);
-         attacker_itr++) {
-
-        bounced_unit = &(units[attacker_itr->second]);
+    for (PROVINCE_INDEX attacking_unit_province : attacker_lists.get_attackers(attacked_province)) {
+        bounced_unit = &(units[attacking_unit_province]);
 
         if (bounced_unit->coast_id.province_index != unit_to_advance) {
-            bounced_unit->order_type_copy = HOLD_NO_SUPPORT_ORDER;
-            bounced_unit->supports.clear();
-            bounced_unit->no_of_supports_to_dislodge = 0;
+            adjudication_of(bounced_unit).order_type_copy = HOLD_NO_SUPPORT_ORDER;
+            adjudication_of(bounced_unit).supports.clear();
+            adjudication_of(bounced_unit).no_of_supports_to_dislodge = 0;
             bounced_unit->bounce = true;
         }
     }
-    attacker_map.erase(attacked_province);
+    attacker_lists.erase(attacked_province);
 }
 
 void MapAndUnits::bounce_all_attacks_on_province(PROVINCE_INDEX province_index) {
     UNIT_AND_ORDER *bounced_unit {nullptr};
 
     // Bounce all the attacks on the given province.
-    for (auto attacker_itr = attacker_map.lower_bound(province_index);
-         attacker_itr != attacker_map.upper_bound(province_index);
-         attacker_itr++) {
-
-        bounced_unit = &(units[attacker_itr->second]);
-        bounced_unit->order_type_copy = HOLD_NO_SUPPORT_ORDER;
-        bounced_unit->supports.clear();
-        bounced_unit->no_of_supports_to_dislodge = 0;
+    for (PROVINCE_INDEX attacking_unit_province : attacker_lists.get_attackers(province_index)) {
+        bounced_unit = &(units[attacking_unit_province]);
+        adjudication_of(bounced_unit).order_type_copy = HOLD_NO_SUPPORT_ORDER;
+        adjudication_of(bounced_unit).supports.clear();
+        adjudication_of(bounced_unit).no_of_supports_to_dislodge = 0;
         bounced_unit->bounce = true;
     }
 
-    // Remove them all from the attacker map
-    attacker_map.erase(province_index);
+    // Remove them all from the attacker lists
+    attacker_lists.erase(province_index);
 
     // Add to the list of provinces containing a bounce
     bounce_locations.insert(province_index);
@@ -1166,20 +1183,13 @@ void MapAndUnits::bounce_all_attacks_on_province(PROVINCE_INDEX province_index)
 void MapAndUnits::bounce_attack(UNIT_AND_ORDER *unit) {
 
     // Bounce the given unit out of the province it is attacking
-    unit->order_type_copy = HOLD_NO_SUPPORT_ORDER;
-    unit->supports.clear();
-    unit->no_of_supports_to_dislodge = 0;
+    adjudication_of(unit).order_type_copy = HOLD_NO_SUPPORT_ORDER;
+    adjudication_of(unit).supports.clear();
+    adjudication_of(unit).no_of_supports_to_dislodge = 0;
     unit->bounce = true;
 
-    // Remove from attacker map
-    auto attacker_itr = attacker_map.lower_bound(unit->move_dest.province_index);
-    while (attacker_itr != attacker_map.upper_bound(unit->move_dest.province_index)) {
-        if (attacker_itr->second == unit->coast_id.province_index) {
-            attacker_itr = attacker_map.erase(attacker_itr);
-        } else {
-            attacker_itr++;
-        }
-    }
+    // Remove from attacker lists
+    attacker_lists.erase(unit->move_dest.province_index, unit->coast_id.province_index);
 }
 
 void MapAndUnits::resolve_unbalanced_head_to_head_battles() {
@@ -1286,12 +1296,15 @@ void MapAndUnits::resolve_balanced_head_to_head_battles() {
 }
 
 void MapAndUnits::fight_ordinary_battles() {
-    // Just run through the attacker map, resolving each entry (each entry is removed
-    // from the map once resolved, so we just keep resolving the first entry until
+    // Just run through the attacker lists, resolving each province (each is removed
+    // from the lists once resolved, so we just keep resolving the first province until
     // there are none left)
-    while (!attacker_map.empty()) {
-        auto attacker_itr = attacker_map.begin();
-        resolve_attacks_on_province(attacker_itr->first);
+    //
+    // The strongest attacks are searched for one province at a time, as each is resolved. Finding them for every
+    // province at once, in packed tables, costs more than it saves: few provinces have more than one attacker by now,
+    // and the support counts change as supports are cut, so the tables would have to be kept up to date.
+    while (!attacker_lists.empty()) {
+        resolve_attacks_on_province(*attacker_lists.get_attacked_provinces().begin());
     }
 }
 
@@ -1306,8 +1319,8 @@ void MapAndUnits::resolve_attacks_on_province(PROVINCE_INDEX province) {
         // There is. If it is moving and hasn't been resolved yet, then resolve that unit first
         occupying_unit = &(occupying_unit_itr->second);
 
-        if ((   (occupying_unit->order_type_copy == MOVE_ORDER)
-                 || (occupying_unit->order_type_copy == MOVE_BY_CONVOY_ORDER)
+        if ((   (adjudication_of(occupying_unit).order_type_copy == MOVE_ORDER)
+                 || (adjudication_of(occupying_unit).order_type_copy == MOVE_BY_CONVOY_ORDER)
             ) && !occupying_unit->unit_moves) {
 
             resolve_attacks_on_province(occupying_unit->move_dest.province_index);
@@ -1368,6 +1381,52 @@ bool MapAndUnits::resolve_attacks_on_occupied_province(PROVINCE_INDEX attacked_p
     return unit_dislodged;
 }
 
+bool MapAndUnits::is_on_convoy_route(UNIT_AND_ORDER *convoying_fleet) {
+    // A fleet may be ordered to convoy an army which goes by another route, and then the army doesn't depend on it
+    const UNIT_LIST &convoy_steps = units[convoying_fleet->other_source_province].convoy_step_list;
+
+    return std::find(convoy_steps.begin(), convoy_steps.end(), convoying_fleet->coast_id.province_index)
+           != convoy_steps.end();
+}
+
+void MapAndUnits::convoyed_attack_cuts_support(UNIT_AND_ORDER *convoyed_army) {
+    UNIT_AND_ORDER *attacked_unit {nullptr};
+    CONVOY_SUBVERSION *subverted_convoy {nullptr};
+
+    // As for a direct attack, support isn't cut by its own side, or from where it is directed
+    auto attacked_unit_itr = units.find(convoyed_army->move_dest.province_index);
+    if (attacked_unit_itr != units.end()) {
+        attacked_unit = &(attacked_unit_itr->second);
+
+        if ((attacked_unit->nationality != convoyed_army->nationality)
+            && ((adjudication_of(attacked_unit).order_type_copy != SUPPORT_TO_MOVE_ORDER)
+                || (attacked_unit->other_dest_province != convoyed_army->coast_id.province_index))) {
+            cut_support(attacked_unit->coast_id.province_index);
+
+            // Any other convoy attacking the support no longer subverts the convoy it supported. Otherwise that convoy
+            // would be resolved as if the support could still be cut, and the support counted again.
+            for (auto &convoy_subversion : convoy_subversions) {
+                if ((convoy_subversion.first != convoyed_army->coast_id.province_index)
+                    && (convoy_subversion.second.subverted_convoy_army != DOES_NOT_SUBVERT)
+                    && (units[convoy_subversion.first].move_dest.province_index
+                        == attacked_unit->coast_id.province_index)) {
+
+                    auto subverted_convoy_itr = convoy_subversions.find(convoy_subversion.second.subverted_convoy_army);
+                    if (subverted_convoy_itr != convoy_subversions.end()) {
+                        subverted_convoy = &(subverted_convoy_itr->second);
+                        subverted_convoy->number_of_subversions--;
+
+                        if (subverted_convoy->number_of_subversions == 0) {
+                            subverted_convoy->subversion_type = NOT_SUBVERTED_CONVOY;
+                        }
+                    }
+                    convoy_subversion.second.subverted_convoy_army = DOES_NOT_SUBVERT;
+                }
+            }
+        }
+    }
+}
+
 void MapAndUnits::cut_support(PROVINCE_INDEX attacked_province) {
     UNIT_AND_ORDER *cut_unit {nullptr};
     UNIT_AND_ORDER *supported_unit {nullptr};
@@ -1377,22 +1436,22 @@ void MapAndUnits::cut_support(PROVINCE_INDEX attacked_province) {
         cut_unit = &(cut_unit_itr->second);
 
         // Subtract the support from the supported units total
-        if ((cut_unit->order_type_copy == SUPPORT_TO_HOLD_ORDER)
-            || (cut_unit->order_type_copy == SUPPORT_TO_MOVE_ORDER)) {
+        if ((adjudication_of(cut_unit).order_type_copy == SUPPORT_TO_HOLD_ORDER)
+            || (adjudication_of(cut_unit).order_type_copy == SUPPORT_TO_MOVE_ORDER)) {
             supported_unit = &(units[cut_unit->other_source_province]);
         } else {
             supported_unit = nullptr;
         }
 
         if (supported_unit != nullptr) {
-            supported_unit->supports.erase(cut_unit->coast_id.province_index);
+            adjudication_of(supported_unit).supports.erase(cut_unit->coast_id.province_index);
 
-            if (cut_unit->is_support_to_dislodge) {
-                supported_unit->no_of_supports_to_dislodge--;
+            if (adjudication_of(cut_unit).is_support_to_dislodge) {
+                adjudication_of(supported_unit).no_of_supports_to_dislodge--;
             }
 
             // Cut the support for the supporting unit
-            cut_unit->order_type_copy = HOLD_ORDER;
+            adjudication_of(cut_unit).order_type_copy = HOLD_ORDER;
             cut_unit->support_cut = true;
         }
     }
@@ -1408,19 +1467,16 @@ MapAndUnits::find_dislodging_unit(PROVINCE_INDEX attacked_province, bool ignore_
     UNIT_AND_ORDER *occupying_unit {nullptr};
 
     // Find the strength of the most supported and second most supported unit
-    for (auto attacking_unit_itr = attacker_map.lower_bound(attacked_province);
-         attacking_unit_itr != attacker_map.upper_bound(attacked_province);
-         attacking_unit_itr++) {
+    for (PROVINCE_INDEX attacking_unit_province : attacker_lists.get_attackers(attacked_province)) {
+        attacking_unit = &(units[attacking_unit_province]);
 
-        attacking_unit = &(units[attacking_unit_itr->second]);
-
-        if (attacking_unit->supports.size() > most_supports) {
+        if (number_of_supports(attacking_unit) > most_supports) {
             second_most_supports = most_supports;
-            most_supports = attacking_unit->supports.size();
-            most_supports_to_dislodge = attacking_unit->no_of_supports_to_dislodge;
-            most_supported_unit = attacking_unit_itr->second;
-        } else if (attacking_unit->supports.size() > second_most_supports) {
-            second_most_supports = attacking_unit->supports.size();
+            most_supports = number_of_supports(attacking_unit);
+            most_supports_to_dislodge = adjudication_of(attacking_unit).no_of_supports_to_dislodge;
+            most_supported_unit = attacking_unit_province;
+        } else if (number_of_supports(attacking_unit) > second_most_supports) {
+            second_most_supports = number_of_supports(attacking_unit);
         }
     }
 
@@ -1428,8 +1484,8 @@ MapAndUnits::find_dislodging_unit(PROVINCE_INDEX attacked_province, bool ignore_
     if (!ignore_occupying_unit) {
         occupying_unit = &(units[attacked_province]);
 
-        if (occupying_unit->supports.size() > second_most_supports) {
-            second_most_supports = occupying_unit->supports.size();
+        if (number_of_supports(occupying_unit) > second_most_supports) {
+            second_most_supports = number_of_supports(occupying_unit);
         }
     }
 
@@ -1449,18 +1505,15 @@ MapAndUnits::PROVINCE_INDEX MapAndUnits::find_successful_attack_on_empty_provinc
     UNIT_AND_ORDER *attacking_unit {nullptr};
 
     // Find the strength of the most supported and second most supported unit
-    for (auto attacking_unit_itr = attacker_map.lower_bound(attacked_province);
-         attacking_unit_itr != attacker_map.upper_bound(attacked_province);
-         attacking_unit_itr++) {
-
-        attacking_unit = &(units[attacking_unit_itr->second]);
+    for (PROVINCE_INDEX attacking_unit_province : attacker_lists.get_attackers(attacked_province)) {
+        attacking_unit = &(units[attacking_unit_province]);
 
-        if (attacking_unit->supports.size() > most_supports) {
+        if (number_of_supports(attacking_unit) > most_supports) {
             second_most_supports = most_supports;
-            most_supports = attacking_unit->supports.size();
-            most_supported_unit = attacking_unit_itr->second;
-        } else if (attacking_unit->supports.size() > second_most_supports) {
-            second_most_supports = attacking_unit->supports.size();
+            most_supports = number_of_supports(attacking_unit);
+            most_supported_unit = attacking_unit_province;
+        } else if (number_of_supports(attacking_unit) > second_most_supports) {
+            second_most_supports = number_of_supports(attacking_unit);
         }
     }
 
@@ -1473,14 +1526,14 @@ MapAndUnits::PROVINCE_INDEX MapAndUnits::find_successful_attack_on_empty_provinc
 }
 
 void MapAndUnits::adjudicate_retreats() {
-    ATTACKER_MAP retreat_map;
+    RETREAT_MAP retreat_map;
     UNIT_AND_ORDER *unit {nullptr};
     UNIT_AND_ORDER *bouncing_unit {nullptr};
 
     // Set up units to start adjudicating
     for (auto &dislodged_unit : dislodged_units) {
         unit = &(dislodged_unit.second);
-        unit->order_type_copy = unit->order_type;
+        adjudication_of(unit).order_type_copy = unit->order_type;
         unit->bounce = false;
         unit->unit_moves = false;
     }
@@ -1494,7 +1547,7 @@ void MapAndUnits::adjudicate_retreats() {
         unit = &(dislodged_unit.second);
 
         // It's retreating. Check if we know of another unit retreating to its space
-        if (unit->order_type_copy == RETREAT_ORDER) {
+        if (adjudication_of(unit).order_type_copy == RETREAT_ORDER) {
             auto bouncing_unit_itr = retreat_map.find(unit->move_dest.province_index);
 
             // Found one, so bounce both of them
@@ -1506,8 +1559,8 @@ void MapAndUnits::adjudicate_retreats() {
 
             // No bounce found, so assume unit moves for now.
             } else {
-                retreat_map.insert(ATTACKER_MAP::value_type(unit->move_dest.province_index,
-                                                            unit->coast_id.province_index));
+                retreat_map.insert(RETREAT_MAP::value_type(unit->move_dest.province_index,
+                                                           unit->coast_id.province_index));
                 unit->unit_moves = true;
             }
 
@@ -1523,13 +1576,13 @@ void MapAndUnits::check_for_illegal_retreat_orders() {
         unit_record = &(dislodged_unit.second);
 
         if (!can_move_to(unit_record, unit_record->move_dest)) {
-            unit_record->order_type_copy = HOLD_ORDER;
+            adjudication_of(unit_record).order_type_copy = HOLD_ORDER;
             unit_record->illegal_order = true;
             unit_record->illegal_reason = TOKEN_ORDER_NOTE_FAR;
         } else if ((bounce_locations.find(unit_record->move_dest.province_index) != bounce_locations.end())
                    || (units.find(unit_record->move_dest.province_index) != units.end())
                    || (unit_record->dislodged_from == unit_record->move_dest.province_index)) {
-            unit_record->order_type_copy = HOLD_ORDER;
+            adjudication_of(unit_record).order_type_copy = HOLD_ORDER;
             unit_record->illegal_order = true;
             unit_record->illegal_reason = TOKEN_ORDER_NOTE_NVR;
         }
@@ -1539,8 +1592,10 @@ void MapAndUnits::check_for_illegal_retreat_orders() {
 void MapAndUnits::adjudicate_builds() {
     WINTER_ORDERS_FOR_POWER *orders {nullptr};
 
-    // For each power, check if they have ordered enough builds/disbands
+    // For each power, check if they have ordered enough builds/disbands. The orders are logged first, as the waives,
+    // civil disorder disbands and results written here are taken back by undo_to() too.
     for (POWER_INDEX power_index = 0; power_index < number_of_powers; power_index++) {
+        log_winter_orders(power_index);
         orders = &(winter_orders[power_index]);
 
         if (orders->is_building) {
@@ -1565,88 +1620,109 @@ void MapAndUnits::adjudicate_builds() {
 }
 
 void MapAndUnits::generate_cd_disbands(POWER_INDEX power_index, WINTER_ORDERS_FOR_POWER *orders) {
-    using DISTANCE_FROM_HOME_MAP = std::multimap<int, PROVINCE_INDEX>;
-    DISTANCE_FROM_HOME_MAP distance_from_home_map;
+    int disband_keys[MAX_PROVINCES];
+    int number_of_units {0};
 
+    // Each unit keyed by its distance from home, then its province, so sorting them puts the furthest from home first,
+    // and of units as far, the one in the highest province
     for (auto &unit : units) {
         if (unit.second.nationality == power_index) {
-            distance_from_home_map.insert(
-                    DISTANCE_FROM_HOME_MAP::value_type(get_distance_from_home(unit.second), unit.first));
+            disband_keys[number_of_units++] = get_distance_from_home(unit.second) * MAX_PROVINCES + unit.first;
         }
     }
 
-    for (auto distance_itr = distance_from_home_map.rbegin();
-         distance_itr != distance_from_home_map.rend();
-         distance_itr++) {
+    std::sort(disband_keys, disband_keys + number_of_units, std::greater<int>());
 
-        if ((orders->builds_or_disbands.size() < orders->number_of_orders_required)
-             && (orders->builds_or_disbands.find(units[distance_itr->second].coast_id)
-                 == orders->builds_or_disbands.end())) {
+    for (int unit_ctr = 0;
+         (unit_ctr < number_of_units) && (orders->builds_or_disbands.size() < orders->number_of_orders_required);
+         unit_ctr++) {
 
-            orders->builds_or_disbands.insert(
-                    BUILDS_OR_DISBANDS::value_type(units[distance_itr->second].coast_id, TOKEN_ORDER_NOTE_MBV));
+        const COAST_ID &coast_id = units[disband_keys[unit_ctr] % MAX_PROVINCES].coast_id;
+
+        if (orders->builds_or_disbands.find(coast_id) == orders->builds_or_disbands.end()) {
+            orders->builds_or_disbands.insert(BUILDS_OR_DISBANDS::value_type(coast_id, TOKEN_ORDER_NOTE_MBV));
         }
     }
 }
 
 int MapAndUnits::get_distance_from_home(UNIT_AND_ORDER &unit) {
-    using DISTANCE_MAP = std::map<PROVINCE_INDEX, int>;
-
-    bool home_centre_found {false};
-    int best_current_distance {0};
-    DISTANCE_MAP distance_map;
-    DISTANCE_MAP current_distances;
-    DISTANCE_MAP new_distances;
-    HOME_CENTRE_SET *home_centre_set {nullptr};
-    PROVINCE_COASTS *coast_details {nullptr};
-
-    home_centre_set = &(game_map[unit.coast_id.province_index].home_centre_set);
+    // The distance ignores the unit type, as armies and fleets are disbanded alike
+    return topology->get_distance_to_home(unit.nationality, unit.coast_id.province_index);
+}
 
-    // If the unit is not already in a home centre
-    if (home_centre_set->find(unit.nationality) == home_centre_set->end()) {
+int MapAndUnits::get_move_results(UNIT_RESULT results[]) const {
+    PROVINCE_SET occupied_provinces = get_provinces_occupied_after_moves();
+    int unit_ctr {0};
 
-        // Put this one province in the current distances
-        current_distances.insert(DISTANCE_MAP::value_type(unit.coast_id.province_index, 0));
+    for (const auto &unit_itr : units) {
+        get_move_result(unit_itr.first, unit_itr.second, occupied_provinces, &(results[unit_ctr]));
+        unit_ctr++;
+    }
+    return unit_ctr;
+}
 
-        // While a home centre is not found
-        while (!home_centre_found) {
-            best_current_distance++;
+uint16_t MapAndUnits::get_result_flags(const UNIT_AND_ORDER &unit) {
+    return (unit.unit_moves ? RESULT_MOVES : 0)
+           | (unit.bounce ? RESULT_BOUNCE : 0)
+           | (unit.dislodged ? RESULT_DISLODGED : 0)
+           | (unit.support_cut ? RESULT_SUPPORT_CUT : 0)
+           | (unit.support_void ? RESULT_SUPPORT_VOID : 0)
+           | (unit.no_convoy ? RESULT_NO_CONVOY : 0)
+           | (unit.convoy_broken ? RESULT_CONVOY_BROKEN : 0)
+           | (unit.no_army_to_convoy ? RESULT_NO_ARMY_TO_CONVOY : 0)
+           | (unit.illegal_order ? RESULT_ILLEGAL : 0);
+}
 
-            for (auto distance_itr = current_distances.begin();
-                 distance_itr != current_distances.end();
-                 distance_itr++) {
+void MapAndUnits::get_move_result(PROVINCE_INDEX unit_province,
+                                  const UNIT_AND_ORDER &unit,
+                                  const PROVINCE_SET &occupied_provinces,
+                                  UNIT_RESULT *result) const {
+    result->province = static_cast<int16_t>(unit_province);
+    result->location = static_cast<int16_t>(topology->get_coast_index(unit.unit_moves ? unit.move_dest
+                                                                                      : unit.coast_id));
+    result->dislodged_from = static_cast<int16_t>(unit.dislodged ? unit.dislodged_from
+                                                                 : static_cast<int>(NO_PROVINCE));
+    result->flags = get_result_flags(unit);
+    result->illegal_reason = unit.illegal_order ? unit.illegal_reason : Token();
+    result->retreat_options = unit.dislodged ? get_retreat_options(unit, occupied_provinces) : 0;
+}
 
-                coast_details = &(game_map[distance_itr->first].coast_info);
+MapAndUnits::PROVINCE_SET MapAndUnits::get_provinces_occupied_after_moves() const {
+    PROVINCE_SET occupied_provinces;
 
-                for (auto &coast_detail : *coast_details) {
+    // A dislodged unit's province is taken by the unit which dislodged it
+    for (const auto &unit_itr : units) {
+        if (unit_itr.second.unit_moves) {
+            occupied_provinces.insert(unit_itr.second.move_dest.province_index);
+        } else if (!unit_itr.second.dislodged) {
+            occupied_provinces.insert(unit_itr.first);
+        }
+    }
+    return occupied_provinces;
+}
 
-                    for (const auto &adjacent_coast : coast_detail.second.adjacent_coasts) {
+uint32_t MapAndUnits::get_retreat_options(const UNIT_AND_ORDER &unit, const PROVINCE_SET &occupied_provinces) const {
+    COAST_INDEX dislodged_coast = topology->get_coast_index(unit.coast_id);
+    uint32_t retreat_options {0};
+    int adjacent_ctr {0};
 
-                        if ((distance_map.find(adjacent_coast.province_index) == distance_map.end())
-                            && (current_distances.find(adjacent_coast.province_index) == current_distances.end())) {
+    if (dislodged_coast == NO_COAST) { return 0; }
 
-                            new_distances.insert(
-                                    DISTANCE_MAP::value_type(adjacent_coast.province_index, best_current_distance));
-                            home_centre_set = &(game_map[adjacent_coast.province_index].home_centre_set);
+    // As for the retreat options set by apply_moves()
+    for (COAST_INDEX adjacent_coast_index : topology->get_coast_adjacencies(dislodged_coast)) {
+        PROVINCE_INDEX adjacent_province = topology->get_coast(adjacent_coast_index).province_index;
 
-                            if (home_centre_set->find(unit.nationality) != home_centre_set->end()) {
-                                home_centre_found = true;
-                            }
-                        }
-                    }
-                }
-            }
+        if (adjacent_ctr == MAX_RETREAT_OPTIONS) { break; }
 
-            for (auto &current_distance : current_distances) {
-                distance_map.insert(current_distance);
-            }
+        if ((adjacent_province != unit.dislodged_from)
+            && !occupied_provinces.contains(adjacent_province)
+            && !bounce_locations.contains(adjacent_province)) {
 
-            current_distances = new_distances;
-            new_distances.clear();
+            retreat_options |= (1U << adjacent_ctr);
         }
+        adjacent_ctr++;
     }
-
-    return best_current_distance;
+    return retreat_options;
 }
 
 bool MapAndUnits::apply_adjudication() {
@@ -1663,23 +1739,30 @@ bool MapAndUnits::apply_adjudication() {
 void MapAndUnits::apply_moves() {
     UNITS moved_units {};
     UNIT_AND_ORDER *unit {nullptr};
-    COAST_SET *adjacency_list {nullptr};
+    COAST_INDEX dislodged_coast {NO_COAST};
 
     // Move all the moved units aside. Move all the dislodged units into the dislodged units map
+    for (auto &dislodged_unit : dislodged_units) { log_unit(UNDO_DISLODGED_UNIT, dislodged_unit.first); }
+    position_hash ^= get_units_hash(dislodged_units, true);
     dislodged_units.clear();
 
     auto unit_itr = units.begin();
     while (unit_itr != units.end()) {
         unit = &(unit_itr->second);
+        log_unit(UNDO_UNIT, unit_itr->first);
 
         // Clear the units order
+        order_hash ^= get_order_key(*unit, false);
         unit->order_type = NO_ORDER;
 
         if (unit->unit_moves) {
+            position_hash ^= get_unit_key(*unit, false);
             moved_units.insert(UNITS::value_type(unit->move_dest.province_index, *unit));
             unit_itr = units.erase(unit_itr);
 
         } else if (unit->dislodged) {
+            position_hash ^= get_unit_key(*unit, false) ^ get_unit_key(*unit, true);
+            log_unit(UNDO_DISLODGED_UNIT, unit->coast_id.province_index);
             dislodged_units.insert(UNITS::value_type(unit->coast_id.province_index, *unit));
             unit_itr = units.erase(unit_itr);
 
@@ -1692,22 +1775,26 @@ void MapAndUnits::apply_moves() {
     for (auto &moved_unit : moved_units) {
         unit = &(moved_unit.second);
         unit->coast_id = unit->move_dest;
-        units.insert(UNITS::value_type(unit->move_dest.province_index, *unit));
+        log_unit(UNDO_UNIT, unit->move_dest.province_index);
+        if (units.insert(UNITS::value_type(unit->move_dest.province_index, *unit)).second) {
+            position_hash ^= get_unit_key(*unit, false);
+        }
     }
 
     // For each dislodged unit, set its retreat options
     for (auto &dislodged_unit : dislodged_units) {
         dislodged_unit.second.retreat_options.clear();
-        adjacency_list = &(game_map[dislodged_unit.second.coast_id.province_index]
-                           .coast_info[dislodged_unit.second.coast_id.coast_token]
-                           .adjacent_coasts);
+        dislodged_coast = topology->get_coast_index(dislodged_unit.second.coast_id);
+        if (dislodged_coast == NO_COAST) { continue; }
 
-        for (const auto &adjacency_itr : *adjacency_list) {
-            if ((adjacency_itr.province_index != dislodged_unit.second.dislodged_from)
-                 && (units.find(adjacency_itr.province_index) == units.end())
-                 && (bounce_locations.find(adjacency_itr.province_index) == bounce_locations.end())) {
+        for (COAST_INDEX adjacent_coast_index : topology->get_coast_adjacencies(dislodged_coast)) {
+            const COAST_ID &adjacent_coast = topology->get_coast(adjacent_coast_index);
 
-                dislodged_unit.second.retreat_options.insert(adjacency_itr);
+            if ((adjacent_coast.province_index != dislodged_unit.second.dislodged_from)
+                 && (units.find(adjacent_coast.province_index) == units.end())
+                 && (bounce_locations.find(adjacent_coast.province_index) == bounce_locations.end())) {
+
+                dislodged_unit.second.retreat_options.insert(adjacent_coast);
             }
         }
     }
@@ -1719,13 +1806,19 @@ void MapAndUnits::apply_retreats() {
     // Move all the moved units aside. Move all the dislodged units into the dislodged units map
     for (auto &dislodged_unit : dislodged_units) {
         unit = &(dislodged_unit.second);
+        log_unit(UNDO_DISLODGED_UNIT, dislodged_unit.first);
 
         // Clear the units order
+        order_hash ^= get_order_key(*unit, true);
         unit->order_type = NO_ORDER;
+        position_hash ^= get_unit_key(*unit, true);
 
         if (unit->unit_moves) {
             unit->coast_id = unit->move_dest;
-            units.insert(UNITS::value_type(unit->move_dest.province_index, *unit));
+            log_unit(UNDO_UNIT, unit->move_dest.province_index);
+            if (units.insert(UNITS::value_type(unit->move_dest.province_index, *unit)).second) {
+                position_hash ^= get_unit_key(*unit, false);
+            }
         }
     }
     dislodged_units.clear();
@@ -1751,12 +1844,17 @@ void MapAndUnits::apply_builds() {
                     new_unit.unit_type = TOKEN_UNIT_FLT;
                 }
 
-                units.insert(UNITS::value_type(new_unit.coast_id.province_index, new_unit));
+                log_unit(UNDO_UNIT, new_unit.coast_id.province_index);
+                if (units.insert(UNITS::value_type(new_unit.coast_id.province_index, new_unit)).second) {
+                    position_hash ^= get_unit_key(new_unit, false);
+                }
             }
 
         // Remove a unit from the unit map
         } else {
             for (auto &builds_or_disband : orders->builds_or_disbands) {
+                log_unit(UNDO_UNIT, builds_or_disband.first.province_index);
+                remove_unit_from_hash(units, builds_or_disband.first.province_index, false);
                 units.erase(builds_or_disband.first.province_index);
             }
         }
@@ -1767,13 +1865,14 @@ bool MapAndUnits::move_to_next_turn() {
     bool new_turn_found {false};
     bool send_sco {false};              // Whether SCO should be sent if server.
 
+    log_turn();
+
     // Step through the turns until we find one which has something to do
     while (!new_turn_found) {
         if (current_season == TOKEN_SEASON_WIN) {
-            current_season = TOKEN_SEASON_SPR;
-            current_year++;
+            set_turn(TOKEN_SEASON_SPR, current_year + 1);
         } else {
-            current_season = current_season.get_token() + 1;
+            set_turn(current_season.get_token() + 1, current_year);
         }
 
         // Movement turns always happen
@@ -1815,19 +1914,21 @@ bool MapAndUnits::update_sc_ownership() {
     // Update the ownership of all occupied provinces, and count units
     for (auto &unit_itr : units) {
         unit = &(unit_itr.second);
-        game_map[unit->coast_id.province_index].owner = Token(CATEGORY_POWER, unit->nationality);
+        log_province_owner(unit->coast_id.province_index);
+        set_province_owner(unit->coast_id.province_index, Token(CATEGORY_POWER, unit->nationality));
         unit_count[unit->nationality]++;
     }
 
     // Count SCs
     for (PROVINCE_INDEX province_index = 0; province_index < number_of_provinces; province_index++) {
-        if ((game_map[province_index].is_supply_centre) && (game_map[province_index].owner != TOKEN_PARAMETER_UNO)) {
-            sc_count[game_map[province_index].owner.get_subtoken()]++;
+        if ((game_map[province_index].is_supply_centre) && (province_owner[province_index] != TOKEN_PARAMETER_UNO)) {
+            sc_count[province_owner[province_index].get_subtoken()]++;
         }
     }
 
     // Work out who is building and who is disbanding
     for (int power_ctr = 0; power_ctr < number_of_powers; power_ctr++) {
+        log_winter_orders(power_ctr);
         orders = &(winter_orders[power_ctr]);
 
         if (sc_count[power_ctr] > unit_count[power_ctr]) {
@@ -1848,3 +1949,94 @@ bool MapAndUnits::update_sc_ownership() {
 
     return orders_required;
 }
+
+MapAndUnits::UNDO_ENTRY &MapAndUnits::add_undo_entry(UNDO_TYPE type, int index) {
+    if (undo_log_size == static_cast<int>(undo_log.size())) {
+        undo_log.emplace_back();
+    }
+
+    UNDO_ENTRY &entry = undo_log[undo_log_size++];
+    entry.type = type;
+    entry.index = index;
+    return entry;
+}
+
+void MapAndUnits::log_unit(UNDO_TYPE type, PROVINCE_INDEX province_index) {
+    if (!undo_logging) { return; }
+
+    UNITS &unit_set = (type == UNDO_DISLODGED_UNIT) ? dislodged_units : units;
+    UNDO_ENTRY &entry = add_undo_entry(type, province_index);
+
+    // Assigning into the old entry reuses its storage
+    auto unit_itr = unit_set.find(province_index);
+    entry.was_present = (unit_itr != unit_set.end());
+    if (entry.was_present) {
+        entry.unit = unit_itr->second;
+    }
+}
+
+void MapAndUnits::log_province_owner(PROVINCE_INDEX province_index) {
+    if (!undo_logging) { return; }
+
+    add_undo_entry(UNDO_OWNER, province_index).token = province_owner[province_index];
+}
+
+void MapAndUnits::log_turn() {
+    if (!undo_logging) { return; }
+
+    UNDO_ENTRY &entry = add_undo_entry(UNDO_TURN, 0);
+    entry.token = current_season;
+    entry.year = current_year;
+}
+
+void MapAndUnits::log_winter_orders(POWER_INDEX power_index) {
+    if (!undo_logging) { return; }
+
+    UNDO_ENTRY &entry = add_undo_entry(UNDO_WINTER_ORDERS, power_index);
+    auto winter_itr = winter_orders.find(power_index);
+    entry.was_present = (winter_itr != winter_orders.end());
+    if (entry.was_present) {
+        entry.winter_orders = winter_itr->second;
+    }
+}
+
+void MapAndUnits::undo_to(UNDO_MARK mark) {
+    // Most recent first, so a province changed twice ends up with its first value
+    while (undo_log_size > mark) {
+        UNDO_ENTRY &entry = undo_log[--undo_log_size];
+
+        switch (entry.type) {
+            case UNDO_UNIT:
+            case UNDO_DISLODGED_UNIT: {
+                bool is_dislodged = (entry.type == UNDO_DISLODGED_UNIT);
+                UNITS &unit_set = is_dislodged ? dislodged_units : units;
+
+                remove_unit_from_hash(unit_set, entry.index, is_dislodged);
+                if (entry.was_present) {
+                    std::swap(unit_set[entry.index], entry.unit);
+                    position_hash ^= get_unit_key(unit_set[entry.index], is_dislodged);
+                    order_hash ^= get_order_key(unit_set[entry.index], is_dislodged);
+                } else {
+                    unit_set.erase(entry.index);
+                }
+                break;
+            }
+
+            case UNDO_OWNER:
+                set_province_owner(entry.index, entry.token);
+                break;
+
+            case UNDO_TURN:
+                set_turn(entry.token, entry.year);
+                break;
+
+            case UNDO_WINTER_ORDERS:
+                if (entry.was_present) {
+                    std::swap(winter_orders[entry.index], entry.winter_orders);
+                } else {
+                    winter_orders.erase(entry.index);
+                }
+                break;
+        }
+    }
+}
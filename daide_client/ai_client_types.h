@@ -32,6 +32,8 @@ typedef struct {
     bool reconnection_specified;    // Whether the reconnection parameters have been provided
     std::string reconnect_power;    // Power to reconnect as
     int reconnect_passcode;         // Passcode to reconnect as
+    bool metrics_specified;         // Whether a metrics port was specified
+    uint16_t metrics_port;          // Loopback port to serve metrics on
 } COMMAND_LINE_PARAMETERS;
 
 } // namespace DAIDE
@@ -0,0 +1,124 @@
+/**
+ * Diplomacy AI Client - Part of the DAIDE project.
+ *
+ * Attacker Lists. For each province, the units attacking it, in the order they were added. Used by the adjudicator in
+ * place of a multimap from attacked province to attacking unit, and iterates in the same order as one would: by
+ * attacked province, then by when the attack was added.
+ *
+ * A unit attacks at most one province, so the lists are linked through fixed tables indexed by the province of the
+ * attacking unit, and nothing is allocated. Clearing only empties the set of attacked provinces.
+ *
+ * Release 8~3
+ **/
+
+#ifndef _DAIDE_CLIENT_DAIDE_CLIENT_ATTACKER_LISTS_H
+#define _DAIDE_CLIENT_DAIDE_CLIENT_ATTACKER_LISTS_H
+
+#include <cstddef>
+#include <iterator>
+
+#include "daide_client/province_set.h"
+
+namespace DAIDE {
+
+class AttackerLists {
+public:
+    enum { CAPACITY = ProvinceSet::CAPACITY };
+    enum { NO_ATTACKER = -1 };
+
+    // The attackers of one province. Iterate it like a container.
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = int;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const int *;
+        using reference = int;
+
+        const_iterator(const AttackerLists *lists, int attacker) : m_lists(lists), m_attacker(attacker) {}
+
+        int operator*() const { return m_attacker; }
+
+        const_iterator &operator++() {
+            m_attacker = m_lists->m_next_attacker[m_attacker];
+            return *this;
+        }
+
+        bool operator==(const const_iterator &other) const { return m_attacker == other.m_attacker; }
+        bool operator!=(const const_iterator &other) const { return m_attacker != other.m_attacker; }
+
+    private:
+        const AttackerLists *m_lists;
+        int m_attacker;
+    };
+
+    using ATTACKERS = struct {
+        const_iterator first;
+        const_iterator last;
+
+        const_iterator begin() const { return first; }
+        const_iterator end() const { return last; }
+    };
+
+    void clear() { m_attacked_provinces.clear(); }
+
+    bool empty() const { return m_attacked_provinces.empty(); }
+
+    // The provinces under attack, in ascending order
+    const ProvinceSet &get_attacked_provinces() const { return m_attacked_provinces; }
+
+    ATTACKERS get_attackers(int province) const {
+        int first_attacker = m_attacked_provinces.contains(province) ? m_first_attacker[province] : NO_ATTACKER;
+        return ATTACKERS {const_iterator(this, first_attacker), const_iterator(this, NO_ATTACKER)};
+    }
+
+    // Add an attack at the end of the province's list. The attacker must not already be in a list.
+    void insert(int province, int attacker) {
+        m_next_attacker[attacker] = NO_ATTACKER;
+
+        if (m_attacked_provinces.contains(province)) {
+            m_next_attacker[m_last_attacker[province]] = attacker;
+        } else {
+            m_first_attacker[province] = attacker;
+            m_attacked_provinces.insert(province);
+        }
+        m_last_attacker[province] = attacker;
+    }
+
+    // Remove all the attacks on a province
+    void erase(int province) { m_attacked_provinces.erase(province); }
+
+    // Remove one attack on a province
+    void erase(int province, int attacker) {
+        if (!m_attacked_provinces.contains(province)) { return; }
+
+        int previous_attacker {NO_ATTACKER};
+        for (int list_attacker = m_first_attacker[province];
+             list_attacker != NO_ATTACKER;
+             list_attacker = m_next_attacker[list_attacker]) {
+
+            if (list_attacker == attacker) {
+                if (previous_attacker == NO_ATTACKER) {
+                    m_first_attacker[province] = m_next_attacker[attacker];
+                } else {
+                    m_next_attacker[previous_attacker] = m_next_attacker[attacker];
+                }
+
+                if (m_last_attacker[province] == attacker) { m_last_attacker[province] = previous_attacker; }
+                if (m_first_attacker[province] == NO_ATTACKER) { m_attacked_provinces.erase(province); }
+                return;
+            }
+            previous_attacker = list_attacker;
+        }
+    }
+
+private:
+    ProvinceSet m_attacked_provinces;           // The provinces whose lists are in use
+    int m_first_attacker[CAPACITY];             // For each attacked province
+    int m_last_attacker[CAPACITY];
+    int m_next_attacker[CAPACITY];              // For each attacking unit, the next in its list
+};
+
+} // namespace DAIDE
+
+#endif // _DAIDE_CLIENT_DAIDE_CLIENT_ATTACKER_LISTS_H
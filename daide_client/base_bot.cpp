@@ -14,16 +14,19 @@
  * Release 8~3
  **/
 
+#include <cstdlib>
 #include <iostream>
 #include <memory>
 #include "daide_client/ai_client.h"
 #include "daide_client/base_bot.h"
 #include "daide_client/error_log.h"
 #include "daide_client/map_and_units.h"
+#include "daide_client/metrics.h"
 #include "daide_client/socket.h"
 #include "daide_client/token_text_map.h"
 
 using DAIDE::BaseBot;
+using DAIDE::MetricsRegistry;
 
 BaseBot::BaseBot() {
     log_error("Started");               // not an error, but indicates start of logging; also writes to normal log
@@ -73,6 +76,11 @@ bool BaseBot::initialize(const std::string &command_line_a) {
         parameters.port_number = DEFAULT_PORT_NUMBER;
     }
 
+    // Serve metrics. Not fatal if the port is taken; the bot can still play.
+    if (parameters.metrics_specified && !m_metrics_server.start(parameters.metrics_port)) {
+        log_error("Failed to serve metrics on port %d", parameters.metrics_port);
+    }
+
     // Connection failure
     if (!m_socket.Connect(parameters.server_name, parameters.port_number)) {
         log_error("Failed to connect to server");
@@ -176,6 +184,14 @@ void BaseBot::process_message(const Socket::MessagePtr &message) {
     char* content = get_message_content<char>(message);                 // Message Content of the received message
     unsigned short error_code;                                          // Error code from an error message
 
+    static MetricsCounter &messages_processed = MetricsRegistry::instance()->counter(
+            "daide_bot_processed_messages_total", "Messages processed by the bot");
+    static MetricsHistogram &processing_time = MetricsRegistry::instance()->histogram(
+            "daide_bot_message_processing_seconds", "Time taken to process each message from the server");
+    MetricsTimer processing_timer(processing_time);
+
+    messages_processed.increment();
+
     switch (header->type) {
 
         // Initial Message. Nothing to do.
@@ -339,6 +355,15 @@ void BaseBot::process_hlo(const TokenMessage &incoming_msg) {
     m_map_and_units->variant = incoming_msg.get_submessage(3);
     m_map_and_units->game_started = true;
 
+    // From now on, log to files named after the game
+    std::string power_name = power_submessage.get_message_as_text();
+    power_name.erase(power_name.find_last_not_of(' ') + 1);
+    set_log_identity(std::string(BOT_FAMILY) + "_" + power_name + "_" + std::to_string(m_map_and_units->passcode));
+
+    static MetricsCounter &games_started = MetricsRegistry::instance()->counter(
+            "daide_bot_games_started_total", "Games joined (HLO messages received)");
+    games_started.increment();
+
     // Pass the message on
     process_hlo_message(incoming_msg);
 }
@@ -399,8 +424,13 @@ void BaseBot::process_mdf(const TokenMessage &incoming_msg) {
     }
 }
 
-// Process the NOW message. Store the position and pass on
+// Process the NOW message. Store the position and pass on. This is where bots decide their orders, so the time
+// taken is the decision latency.
 void BaseBot::process_now(const TokenMessage &incoming_msg) {
+    static MetricsHistogram &decision_time = MetricsRegistry::instance()->histogram(
+            "daide_bot_decision_seconds", "Time from receiving a NOW message to finishing processing it");
+    MetricsTimer decision_timer(decision_time);
+
     m_map_and_units->set_units(incoming_msg);
     process_now_message(incoming_msg);
 }
@@ -618,6 +648,10 @@ void BaseBot::process_rej_nme_message(const TokenMessage & /*incoming_msg*/, con
 
     // Send an IAM message
     if (attempt_reconnect) {
+        static MetricsCounter &reconnects = MetricsRegistry::instance()->counter(
+                "daide_bot_reconnects_total", "Attempts to rejoin a game with IAM");
+        reconnects.increment();
+
         passcode_token.set_number(passcode);
         send_message_to_server(TOKEN_COMMAND_IAM & power_token & passcode_token);
 
@@ -631,7 +665,7 @@ void BaseBot::process_rej_nme_message(const TokenMessage & /*incoming_msg*/, con
 // Determine whether to try and reconnect to game. Default uses values passed on command line.
 bool BaseBot::get_reconnect_details(Token &power, int &passcode) {
     if (m_parameters.reconnection_specified) {
-        power = TokenTextMap::instance()->m_text_to_token_map[m_parameters.reconnect_power];
+        if (!TokenTextMap::instance()->get_token(m_parameters.reconnect_power, &power)) { power = Token(); }
         passcode = m_parameters.reconnect_passcode;
     }
     return m_parameters.reconnection_specified;
@@ -801,6 +835,7 @@ bool BaseBot::extract_parameters(const std::string &command_line_a, COMMAND_LINE
     parameters.port_specified = false;
     parameters.log_level_specified = false;
     parameters.reconnection_specified = false;
+    parameters.metrics_specified = false;
 
     // Getting parameters
     std::string m_command_line = command_line_a;
@@ -867,10 +902,25 @@ bool BaseBot::extract_parameters(const std::string &command_line_a, COMMAND_LINE
                 }
                 break;
 
+            case 'm': {
+                char *port_end {nullptr};
+                long metrics_port = strtol(parameter.c_str(), &port_end, 10);
+
+                if ((port_end != parameter.c_str()) && (*port_end == '\0')
+                    && (metrics_port >= 1) && (metrics_port <= 65535)) {
+                    parameters.metrics_specified = true;
+                    parameters.metrics_port = static_cast<uint16_t>(metrics_port);
+                } else {
+                    std::cout << "-m should be followed by a port number from 1 to 65535" << std::endl;
+                    extracted_ok = false;
+                }
+                break;
+            }
+
             default:
                 std::cout << std::string(BOT_FAMILY) << " - version " << std::string(BOT_GENERATION) << std::endl;
                 std::cout << "Usage: " << std::string(BOT_FAMILY)
-                          << " [-sServerName|-iIPAddress] [-pPortNumber] [-lLogLevel] [-rPOW:passcode]" << std::endl;
+                          << " [-sServerName|-iIPAddress] [-pPortNumber] [-lLogLevel] [-rPOW:passcode] [-mMetricsPort]" << std::endl;
                 extracted_ok = false;
         }
         param_start = m_command_line.find('-', search_start);
@@ -20,6 +20,7 @@
 #include "daide_client/ai_client_types.h"
 #include "daide_client/error_log.h"
 #include "daide_client/map_and_units.h"
+#include "daide_client/metrics.h"
 #include "daide_client/socket.h"
 #include "daide_client/token_message.h"
 
@@ -41,6 +42,7 @@ class MapAndUnits;            // The map and units class
 class BaseBot {
 public:
     Socket m_socket;
+    MetricsServer m_metrics_server;             // Serves metrics if a metrics port was given on the command line
 
     BaseBot();
     BaseBot(const BaseBot &other) = delete;                 // Copy constructor
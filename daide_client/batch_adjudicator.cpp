@@ -0,0 +1,146 @@
+/**
+ * Diplomacy AI Client - Part of the DAIDE project.
+ *
+ * Batch Adjudicator. Adjudicates many sets of orders for one movement position.
+ *
+ * Release 8~3
+ **/
+
+#include "daide_client/batch_adjudicator.h"
+#include "daide_client/metrics.h"
+
+using DAIDE::BatchAdjudicator;
+
+bool BatchAdjudicator::adjudicate_batch(const GamePosition &position,
+                                        const LegalOrders &legal_orders,
+                                        const ORDER_CHOICE order_sets[],
+                                        int number_of_order_sets,
+                                        UNIT_RESULT results[],
+                                        PROVINCE_SET bounce_locations[]) {
+    static MetricsHistogram &batch_time = MetricsRegistry::instance()->histogram(
+            "daide_batch_adjudication_seconds", "Time taken by BatchAdjudicator::adjudicate_batch()");
+    MetricsTimer batch_timer(batch_time);
+
+    int number_of_units = legal_orders.get_number_of_units();
+
+    if (!set_up_position(position, legal_orders)) { return false; }
+
+    for (int set_ctr = 0; set_ctr < number_of_order_sets; set_ctr++) {
+        if (!set_orders(legal_orders, order_sets + set_ctr * number_of_units)) { return false; }
+
+        board.adjudicate_moves();
+
+        get_results(results + set_ctr * number_of_units);
+        if (bounce_locations != nullptr) { bounce_locations[set_ctr] = board.bounce_locations; }
+    }
+    return true;
+}
+
+bool BatchAdjudicator::set_up_position(const GamePosition &position, const LegalOrders &legal_orders) {
+    const std::shared_ptr<const MapTopology> &topology = legal_orders.get_topology();
+    int number_of_units = legal_orders.get_number_of_units();
+
+    if ((topology == nullptr)
+        || ((position.current_season != TOKEN_SEASON_SPR) && (position.current_season != TOKEN_SEASON_FAL))
+        || (position.current_season != legal_orders.get_season())) {
+        return false;
+    }
+
+    if (board.get_topology() != topology) { board.set_topology(topology); }
+    board.set_position(position);
+
+    // The orders are legal by construction, so they are not checked
+    board.set_order_checking(false, false);
+
+    // Units which have no entry in the legal orders hold
+    for (auto &unit : board.units) {
+        unit.second.order_type = HOLD_ORDER;
+    }
+
+    unit_records.resize(number_of_units);
+    unit_coasts.resize(number_of_units);
+    unit_orders.resize(number_of_units);
+
+    for (int unit_ctr = 0; unit_ctr < number_of_units; unit_ctr++) {
+        auto unit_itr = board.units.find(legal_orders.get_all_units()[unit_ctr].unit);
+        if (unit_itr == board.units.end()) { return false; }
+
+        unit_records[unit_ctr] = &(unit_itr->second);
+        unit_coasts[unit_ctr] = topology->get_coast_index(unit_itr->second.coast_id);
+    }
+    return true;
+}
+
+bool BatchAdjudicator::set_orders(const LegalOrders &legal_orders, const ORDER_CHOICE choices[]) {
+    const MapTopology &topology = *legal_orders.get_topology();
+    LegalOrders::UNIT_ORDERS_LIST units = legal_orders.get_all_units();
+
+    for (int unit_ctr = 0; unit_ctr < units.size(); unit_ctr++) {
+        if (choices[unit_ctr] >= units[unit_ctr].number_of_orders) { return false; }
+
+        const LegalOrders::LEGAL_ORDER &order = legal_orders.get_orders(units[unit_ctr])[choices[unit_ctr]];
+        UNIT_AND_ORDER *unit = unit_records[unit_ctr];
+
+        unit_orders[unit_ctr] = &order;
+        unit->order_type = order.order_type;
+
+        // Every field the adjudicator may read is written, so nothing is left over from the previous order set
+        switch (order.order_type) {
+            case MOVE_ORDER:
+                unit->move_dest = topology.get_coast(order.destination);
+                break;
+
+            case SUPPORT_TO_HOLD_ORDER:
+            case SUPPORT_TO_MOVE_ORDER:
+            case CONVOY_ORDER:
+                unit->other_source_province = order.other_source_province;
+                unit->other_dest_province = order.other_dest_province;
+                break;
+
+            case MOVE_BY_CONVOY_ORDER: {
+                INDEX_LIST steps = legal_orders.get_convoy_steps(order);
+
+                unit->move_dest.province_index = topology.get_coast(order.destination).province_index;
+                unit->move_dest.coast_token = TOKEN_UNIT_AMY;
+                unit->convoy_step_list.assign(steps.begin(), steps.end());
+                break;
+            }
+
+            default:
+                break;
+        }
+    }
+    return true;
+}
+
+void BatchAdjudicator::get_results(UNIT_RESULT results[]) const {
+    PROVINCE_SET occupied_provinces;
+    bool any_dislodged {false};
+
+    for (int unit_ctr = 0; unit_ctr < static_cast<int>(unit_records.size()); unit_ctr++) {
+        const UNIT_AND_ORDER *unit = unit_records[unit_ctr];
+        UNIT_RESULT &result = results[unit_ctr];
+
+        result.province = static_cast<int16_t>(unit->coast_id.province_index);
+        result.location = static_cast<int16_t>(unit->unit_moves ? unit_orders[unit_ctr]->destination
+                                                                : unit_coasts[unit_ctr]);
+        result.dislodged_from = static_cast<int16_t>(unit->dislodged ? unit->dislodged_from
+                                                                     : static_cast<int>(NO_PROVINCE));
+        result.flags = MapAndUnits::get_result_flags(*unit);
+        result.illegal_reason = Token();
+        result.retreat_options = 0;
+
+        if (unit->dislodged) { any_dislodged = true; }
+    }
+
+    // Only worked out when a unit has to retreat, as it takes a pass over all the units
+    if (!any_dislodged) { return; }
+
+    occupied_provinces = board.get_provinces_occupied_after_moves();
+    for (int unit_ctr = 0; unit_ctr < static_cast<int>(unit_records.size()); unit_ctr++) {
+        if (unit_records[unit_ctr]->dislodged) {
+            results[unit_ctr].retreat_options = board.get_retreat_options(*(unit_records[unit_ctr]),
+                                                                          occupied_provinces);
+        }
+    }
+}
@@ -0,0 +1,65 @@
+/**
+ * Diplomacy AI Client - Part of the DAIDE project.
+ *
+ * Batch Adjudicator. Adjudicates many sets of orders for one movement position, for bots which search over orders.
+ *
+ * Each order set gives every unit one of the orders listed for it by the OrderGenerator. As those orders are all
+ * legal, the orders are not checked again, and the work which depends only on the position is done once for the
+ * whole batch: the position is copied in, and each unit is found, once. Each order set is then written straight into
+ * the units and adjudicated, and the outcome for each unit is written to a small result record, so no TokenMessages
+ * are built.
+ *
+ * Release 8~3
+ **/
+
+#ifndef _DAIDE_CLIENT_DAIDE_CLIENT_BATCH_ADJUDICATOR_H
+#define _DAIDE_CLIENT_DAIDE_CLIENT_BATCH_ADJUDICATOR_H
+
+#include <cstdint>
+#include <vector>
+
+#include "daide_client/game_position.h"
+#include "daide_client/map_and_units.h"
+#include "daide_client/order_generator.h"
+
+namespace DAIDE {
+
+class BatchAdjudicator : public MapTypes {
+public:
+    // The order given to a unit: the index of the order in LegalOrders::get_orders() for the unit
+    using ORDER_CHOICE = uint16_t;
+
+    // Adjudicate a batch of order sets for a movement position, with the legal orders generated for it. The order
+    // sets are held one after another, each with a choice for every unit of legal_orders.get_all_units() in turn.
+    // The results are written in the same layout, one UNIT_RESULT per unit per order set. If bounce_locations is
+    // given, the provinces with a standoff (where no unit may retreat to) are also written for each order set.
+    // Returns false, having stopped, if the position is not a movement turn, does not match the legal orders, or an
+    // order set holds a choice which is out of range.
+    bool adjudicate_batch(const GamePosition &position,
+                          const LegalOrders &legal_orders,
+                          const ORDER_CHOICE order_sets[],
+                          int number_of_order_sets,
+                          UNIT_RESULT results[],
+                          PROVINCE_SET bounce_locations[] = nullptr);
+
+private:
+    // Copy in the position and find the unit for each entry of the legal orders
+    bool set_up_position(const GamePosition &position, const LegalOrders &legal_orders);
+
+    // Write the chosen orders into the units
+    bool set_orders(const LegalOrders &legal_orders, const ORDER_CHOICE choices[]);
+
+    void get_results(UNIT_RESULT results[]) const;
+
+    // The working copy, on which each order set is adjudicated
+    MapAndUnits board;
+
+    // For each unit of the legal orders, its record and coast on the board, and the order it has been given
+    std::vector<UNIT_AND_ORDER *> unit_records;
+    std::vector<COAST_INDEX> unit_coasts;
+    std::vector<const LegalOrders::LEGAL_ORDER *> unit_orders;
+};
+
+} // namespace DAIDE
+
+#endif // _DAIDE_CLIENT_DAIDE_CLIENT_BATCH_ADJUDICATOR_H
@@ -0,0 +1,159 @@
+/**
+ * Diplomacy AI Client - Part of the DAIDE project.
+ *
+ * Convoy Reachability. Where armies can be convoyed to, given the fleets at sea.
+ *
+ * Release 8~3
+ **/
+
+#include <algorithm>
+
+#include "daide_client/convoy_reachability.h"
+
+using DAIDE::ConvoyReachability;
+
+void ConvoyReachability::set_topology(const std::shared_ptr<const MapTopology> &new_topology) {
+    int number_of_provinces = std::max(new_topology->number_of_provinces, 0);
+
+    topology = new_topology;
+
+    sea_provinces.clear();
+    for (PROVINCE_INDEX province_ctr = 0; province_ctr < number_of_provinces; province_ctr++) {
+        if (!topology->game_map[province_ctr].is_land) { sea_provinces.insert(province_ctr); }
+    }
+
+    // There is never more than one component per sea
+    fleets_at_sea.clear();
+    component_of.assign(MAX_PROVINCES, NO_COMPONENT);
+    component_fleets.assign(number_of_provinces, PROVINCE_SET {});
+    component_coasts.assign(number_of_provinces, PROVINCE_SET {});
+    free_components.clear();
+    for (int component_ctr = number_of_provinces - 1; component_ctr >= 0; component_ctr--) {
+        free_components.push_back(component_ctr);
+    }
+
+    convoy_destinations.assign(number_of_provinces, PROVINCE_SET {});
+    destinations_found.clear();
+}
+
+void ConvoyReachability::update(const PROVINCE_SET &occupied_provinces) {
+    PROVINCE_SET new_fleets_at_sea = occupied_provinces & sea_provinces;
+
+    if (new_fleets_at_sea == fleets_at_sea) { return; }
+
+    // Take out the fleets which have gone before adding the new ones, so a component is never split up after a fleet
+    // has joined it
+    for (PROVINCE_INDEX sea_province : fleets_at_sea - new_fleets_at_sea) {
+        fleets_at_sea.erase(sea_province);
+        remove_fleet(sea_province);
+    }
+    for (PROVINCE_INDEX sea_province : new_fleets_at_sea - fleets_at_sea) {
+        fleets_at_sea.insert(sea_province);
+        add_fleet(sea_province);
+    }
+
+    destinations_found.clear();
+}
+
+const DAIDE::ProvinceSet &ConvoyReachability::get_convoy_destinations(PROVINCE_INDEX army_province) {
+    PROVINCE_SET &destinations = convoy_destinations[army_province];
+
+    if (!destinations_found.contains(army_province)) {
+        destinations.clear();
+        for (PROVINCE_INDEX adjacent_province : topology->get_province_adjacencies(army_province)) {
+            if (component_of[adjacent_province] != NO_COMPONENT) {
+                destinations |= component_coasts[component_of[adjacent_province]];
+            }
+        }
+        destinations.erase(army_province);
+        destinations_found.insert(army_province);
+    }
+    return destinations;
+}
+
+void ConvoyReachability::add_fleet(PROVINCE_INDEX sea_province) {
+    int component {NO_COMPONENT};
+
+    // Join the components next to the sea, merging them if there are more than one
+    for (PROVINCE_INDEX adjacent_province : topology->get_province_adjacencies(sea_province)) {
+        int adjacent_component = component_of[adjacent_province];
+
+        if ((adjacent_component == NO_COMPONENT) || (adjacent_component == component)) { continue; }
+
+        if (component == NO_COMPONENT) {
+            component = adjacent_component;
+        } else {
+            for (PROVINCE_INDEX fleet_province : component_fleets[adjacent_component]) {
+                component_of[fleet_province] = component;
+            }
+            component_fleets[component] |= component_fleets[adjacent_component];
+            component_coasts[component] |= component_coasts[adjacent_component];
+            free_component(adjacent_component);
+        }
+    }
+
+    if (component == NO_COMPONENT) {
+        build_component(sea_province);
+    } else {
+        component_of[sea_province] = component;
+        component_fleets[component].insert(sea_province);
+        for (PROVINCE_INDEX adjacent_province : topology->get_province_adjacencies(sea_province)) {
+            if (topology->game_map[adjacent_province].is_land) { component_coasts[component].insert(adjacent_province); }
+        }
+    }
+}
+
+void ConvoyReachability::remove_fleet(PROVINCE_INDEX sea_province) {
+    int component = component_of[sea_province];
+    PROVINCE_SET remaining_fleets = component_fleets[component];
+
+    // The rest of the component may now be in several pieces, so build them again
+    remaining_fleets.erase(sea_province);
+    for (PROVINCE_INDEX fleet_province : component_fleets[component]) {
+        component_of[fleet_province] = NO_COMPONENT;
+    }
+    free_component(component);
+
+    for (PROVINCE_INDEX fleet_province : remaining_fleets) {
+        if (component_of[fleet_province] == NO_COMPONENT) { build_component(fleet_province); }
+    }
+}
+
+void ConvoyReachability::build_component(PROVINCE_INDEX sea_province) {
+    int component = allocate_component();
+    PROVINCE_SET &fleets = component_fleets[component];
+    PROVINCE_SET &coasts = component_coasts[component];
+    PROVINCE_INDEX provinces_to_check[MAX_PROVINCES];
+    int number_to_check {0};
+
+    fleets.clear();
+    coasts.clear();
+
+    component_of[sea_province] = component;
+    fleets.insert(sea_province);
+    provinces_to_check[number_to_check++] = sea_province;
+
+    while (number_to_check > 0) {
+        PROVINCE_INDEX province_being_checked = provinces_to_check[--number_to_check];
+
+        for (PROVINCE_INDEX adjacent_province : topology->get_province_adjacencies(province_being_checked)) {
+            if (topology->game_map[adjacent_province].is_land) {
+                coasts.insert(adjacent_province);
+            } else if (fleets_at_sea.contains(adjacent_province) && (component_of[adjacent_province] == NO_COMPONENT)) {
+                component_of[adjacent_province] = component;
+                fleets.insert(adjacent_province);
+                provinces_to_check[number_to_check++] = adjacent_province;
+            }
+        }
+    }
+}
+
+int ConvoyReachability::allocate_component() {
+    int component = free_components.back();
+    free_components.pop_back();
+    return component;
+}
+
+void ConvoyReachability::free_component(int component) {
+    free_components.push_back(component);
+}
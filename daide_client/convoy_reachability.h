@@ -0,0 +1,83 @@
+/**
+ * Diplomacy AI Client - Part of the DAIDE project.
+ *
+ * Convoy Reachability. Where armies can be convoyed to, given the fleets at sea.
+ *
+ * The fleets at sea are split into connected components (groups of occupied sea provinces which are adjacent to each
+ * other), each with the set of land provinces it touches. An army can be convoyed to any land province touched by a
+ * component next to it, so once the components are known, a query is a bitmap test.
+ *
+ * The components are kept up to date from the set of occupied provinces. Only the seas which have gained or lost a
+ * fleet since the last update are processed: a new fleet joins (and perhaps merges) the components next to it, and a
+ * fleet leaving a sea only splits up its own component.
+ *
+ * Release 8~3
+ **/
+
+#ifndef _DAIDE_CLIENT_DAIDE_CLIENT_CONVOY_REACHABILITY_H
+#define _DAIDE_CLIENT_DAIDE_CLIENT_CONVOY_REACHABILITY_H
+
+#include <memory>
+#include <vector>
+
+#include "daide_client/map_topology.h"
+#include "daide_client/map_types.h"
+
+namespace DAIDE {
+
+class ConvoyReachability : public MapTypes {
+public:
+    enum { NO_COMPONENT = -1 };
+
+    // Start again with no fleets, on the given map
+    void set_topology(const std::shared_ptr<const MapTopology> &new_topology);
+
+    // Bring the components up to date with the occupied provinces. Only the sea provinces among them count.
+    void update(const PROVINCE_SET &occupied_provinces);
+
+    const PROVINCE_SET &get_fleets_at_sea() const { return fleets_at_sea; }
+
+    // The component a sea province belongs to (NO_COMPONENT if it has no fleet), its fleets and the land provinces
+    // it touches
+    int get_component(PROVINCE_INDEX sea_province) const { return component_of[sea_province]; }
+
+    const PROVINCE_SET &get_component_fleets(int component) const { return component_fleets[component]; }
+
+    const PROVINCE_SET &get_component_coasts(int component) const { return component_coasts[component]; }
+
+    // The land provinces an army in the given province can be convoyed to, not including its own. Worked out when
+    // first asked for after each change to the fleets.
+    const PROVINCE_SET &get_convoy_destinations(PROVINCE_INDEX army_province);
+
+    bool can_convoy(PROVINCE_INDEX army_province, PROVINCE_INDEX destination) {
+        return get_convoy_destinations(army_province).contains(destination);
+    }
+
+private:
+    void add_fleet(PROVINCE_INDEX sea_province);
+
+    void remove_fleet(PROVINCE_INDEX sea_province);
+
+    // Make a new component of the fleet in a sea province and all the fleets connected to it
+    void build_component(PROVINCE_INDEX sea_province);
+
+    int allocate_component();
+
+    void free_component(int component);
+
+    std::shared_ptr<const MapTopology> topology;
+    PROVINCE_SET sea_provinces;
+    PROVINCE_SET fleets_at_sea;
+
+    std::vector<int> component_of;                      // For each province
+    std::vector<PROVINCE_SET> component_fleets;         // For each component
+    std::vector<PROVINCE_SET> component_coasts;
+    std::vector<int> free_components;
+
+    std::vector<PROVINCE_SET> convoy_destinations;      // For each army province, once worked out
+    PROVINCE_SET destinations_found;                    // The army provinces whose destinations are up to date
+};
+
+} // namespace DAIDE
+
+#endif // _DAIDE_CLIENT_DAIDE_CLIENT_CONVOY_REACHABILITY_H
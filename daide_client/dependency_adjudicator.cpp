@@ -0,0 +1,453 @@
+/**
+ * Diplomacy AI Client - Part of the DAIDE project.
+ *
+ * Dependency Adjudicator. Adjudicates a movement turn one order at a time. Each order is resolved from the strengths
+ * of the orders it depends on, which are resolved in turn, so only orders which interact are visited.
+ *
+ * Where the orders depend on each other in a cycle, the order the cycle was entered from is guessed to fail and then
+ * to succeed. If both guesses give the same result it is kept. Otherwise the cycle is a ring of attack, in which every
+ * move is made, or a convoy paradox, in which the convoys in the cycle fail (the Szykman rule).
+ *
+ * The orders are checked, and the supports counted, as by the phased adjudicator, so the results are the same.
+ *
+ * Release 8~3
+ **/
+
+#include <algorithm>
+
+#include "daide_client/map_and_units.h"
+
+using DAIDE::MapAndUnits;
+
+void MapAndUnits::adjudicate_moves_by_dependency() {
+    initialise_move_adjudication();
+
+    if (check_orders_on_adjudication) {
+        check_for_illegal_move_orders();
+    }
+
+    resolve_orders_by_dependency(units.get_provinces());
+}
+
+void MapAndUnits::resolve_orders_by_dependency(const UNIT_SET &units_to_resolve) {
+    UNIT_AND_ORDER *unit {nullptr};
+
+    cancel_inconsistent_convoys();
+    cancel_inconsistent_supports();
+    build_support_lists();
+
+    // Every move still ordered attacks its destination, whether it is convoyed or not
+    attacker_lists.clear();
+    for (PROVINCE_INDEX unit_province : units_to_resolve) {
+        unit = &(units[unit_province]);
+
+        if (is_moving(unit)) {
+            attacker_lists.insert(unit->move_dest.province_index, unit_province);
+        }
+    }
+
+    number_of_dependencies = 0;
+    resolution_depth = 0;
+    shallowest_guess_used = NO_GUESS_USED;
+
+    // Resolve every order which has a result of its own
+    for (PROVINCE_INDEX unit_province : units_to_resolve) {
+        switch (unit_adjudication[unit_province].order_type_copy) {
+            case MOVE_ORDER:
+            case MOVE_BY_CONVOY_ORDER:
+            case SUPPORT_TO_HOLD_ORDER:
+            case SUPPORT_TO_MOVE_ORDER:
+            case CONVOY_ORDER:
+                resolve_order(unit_province);
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    set_dependency_results(units_to_resolve);
+}
+
+bool MapAndUnits::resolve_order(PROVINCE_INDEX unit_province) {
+    UNIT_ADJUDICATION &adjudication = unit_adjudication[unit_province];
+    int first_dependency {number_of_dependencies};
+    int guess_used_before {shallowest_guess_used};
+    int guess_used {NO_GUESS_USED};
+    bool first_result {false};
+    bool second_result {false};
+
+    if (adjudication.resolution_state == RESOLVED) {
+        return adjudication.order_succeeds;
+    }
+
+    // Already being resolved, so this is a cycle. Use the guess, and note which guess the result depends on.
+    if (adjudication.resolution_state == GUESSING) {
+        shallowest_guess_used = std::min(shallowest_guess_used, adjudication.guess_depth);
+        return adjudication.order_succeeds;
+    }
+
+    // Guess that the order fails
+    adjudication.guess_depth = ++resolution_depth;
+    adjudication.order_succeeds = false;
+    adjudication.resolution_state = GUESSING;
+    shallowest_guess_used = NO_GUESS_USED;
+    first_result = adjudicate_order(unit_province);
+    guess_used = shallowest_guess_used;
+
+    // No guess was used, so the result stands
+    if (guess_used == NO_GUESS_USED) {
+        adjudication.order_succeeds = first_result;
+        adjudication.resolution_state = RESOLVED;
+
+    // The result depends on the guess for an order further out. Leave it to that order to settle.
+    } else if (guess_used < adjudication.guess_depth) {
+        dependencies[number_of_dependencies++] = unit_province;
+        adjudication.guess_depth = guess_used;
+        adjudication.order_succeeds = first_result;
+
+    // The result depends on the guess for this order. Start the cycle again, guessing that it succeeds.
+    } else {
+        for (int dependency_ctr = first_dependency; dependency_ctr < number_of_dependencies; dependency_ctr++) {
+            unit_adjudication[dependencies[dependency_ctr]].resolution_state = UNRESOLVED;
+        }
+        number_of_dependencies = first_dependency;
+
+        adjudication.order_succeeds = true;
+        second_result = adjudicate_order(unit_province);
+
+        // Both guesses give the same result, so it is the only one
+        if (first_result == second_result) {
+            for (int dependency_ctr = first_dependency; dependency_ctr < number_of_dependencies; dependency_ctr++) {
+                unit_adjudication[dependencies[dependency_ctr]].resolution_state = UNRESOLVED;
+            }
+            number_of_dependencies = first_dependency;
+
+            adjudication.order_succeeds = first_result;
+            adjudication.resolution_state = RESOLVED;
+
+        // Either both results are consistent or neither is. Settle the cycle by rule, then resolve the order again.
+        } else {
+            dependencies[number_of_dependencies++] = unit_province;
+            apply_backup_rule(first_dependency);
+            resolve_order(unit_province);
+        }
+    }
+
+    // Pass on any guess further out that the result still depends on
+    resolution_depth--;
+    shallowest_guess_used = guess_used_before;
+    if (adjudication.resolution_state == GUESSING) {
+        shallowest_guess_used = std::min(shallowest_guess_used, adjudication.guess_depth);
+    }
+
+    return adjudication.order_succeeds;
+}
+
+bool MapAndUnits::adjudicate_order(PROVINCE_INDEX unit_province) {
+    UNIT_AND_ORDER *unit = &(units[unit_province]);
+    bool order_succeeds {false};
+
+    switch (adjudication_of(unit).order_type_copy) {
+        case MOVE_ORDER:
+        case MOVE_BY_CONVOY_ORDER:
+            order_succeeds = adjudicate_move_order(unit);
+            break;
+
+        case SUPPORT_TO_HOLD_ORDER:
+        case SUPPORT_TO_MOVE_ORDER:
+            order_succeeds = adjudicate_support_order(unit);
+            break;
+
+        case CONVOY_ORDER:
+            order_succeeds = adjudicate_convoy_order(unit);
+            break;
+
+        default:
+            break;
+    }
+
+    return order_succeeds;
+}
+
+bool MapAndUnits::adjudicate_move_order(UNIT_AND_ORDER *unit) {
+    PROVINCE_INDEX destination = unit->move_dest.province_index;
+    UNIT_AND_ORDER *opponent {nullptr};
+    int attack_strength {0};
+
+    if ((adjudication_of(unit).order_type_copy == MOVE_BY_CONVOY_ORDER) && !convoy_route_holds(unit)) {
+        return false;
+    }
+
+    // The attack must beat the unit it is moving against
+    attack_strength = get_attack_strength(unit);
+    opponent = find_head_to_head_opponent(unit);
+
+    if (opponent != nullptr) {
+        if (attack_strength <= get_defend_strength(opponent)) {
+            return false;
+        }
+    } else if (attack_strength <= get_hold_strength(destination)) {
+        return false;
+    }
+
+    // And every other unit trying to move to the same place
+    for (PROVINCE_INDEX attacking_unit_province : attacker_lists.get_attackers(destination)) {
+        if ((attacking_unit_province != unit->coast_id.province_index)
+            && (attack_strength <= get_prevent_strength(&(units[attacking_unit_province])))) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool MapAndUnits::adjudicate_support_order(UNIT_AND_ORDER *unit) {
+    UNIT_AND_ORDER *attacking_unit {nullptr};
+
+    // Support is cut by an attack from another power, unless it comes from where the support is directed. A convoyed
+    // attack only cuts it if the convoy gets through.
+    for (PROVINCE_INDEX attacking_unit_province : attacker_lists.get_attackers(unit->coast_id.province_index)) {
+        attacking_unit = &(units[attacking_unit_province]);
+
+        if ((attacking_unit->nationality == unit->nationality)
+            || ((adjudication_of(unit).order_type_copy == SUPPORT_TO_MOVE_ORDER)
+                && (attacking_unit_province == unit->other_dest_province))) {
+            continue;
+        }
+
+        if ((adjudication_of(attacking_unit).order_type_copy == MOVE_ORDER) || convoy_route_holds(attacking_unit)) {
+            return false;
+        }
+    }
+
+    // Or by the supporting unit being dislodged
+    for (PROVINCE_INDEX attacking_unit_province : attacker_lists.get_attackers(unit->coast_id.province_index)) {
+        if (resolve_order(attacking_unit_province)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool MapAndUnits::adjudicate_convoy_order(UNIT_AND_ORDER *unit) {
+
+    // The convoy is kept up unless the fleet is dislodged
+    for (PROVINCE_INDEX attacking_unit_province : attacker_lists.get_attackers(unit->coast_id.province_index)) {
+        if (resolve_order(attacking_unit_province)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void MapAndUnits::apply_backup_rule(int first_dependency) {
+    bool convoy_in_cycle {false};
+    UNIT_AND_ORDER *unit {nullptr};
+
+    for (int dependency_ctr = first_dependency; dependency_ctr < number_of_dependencies; dependency_ctr++) {
+        if (unit_adjudication[dependencies[dependency_ctr]].order_type_copy == CONVOY_ORDER) {
+            convoy_in_cycle = true;
+        }
+    }
+
+    for (int dependency_ctr = first_dependency; dependency_ctr < number_of_dependencies; dependency_ctr++) {
+        unit = &(units[dependencies[dependency_ctr]]);
+        UNIT_ADJUDICATION &adjudication = adjudication_of(unit);
+
+        // A convoy paradox. The convoys fail, and the rest is resolved again without them.
+        if (convoy_in_cycle) {
+            if (adjudication.order_type_copy == CONVOY_ORDER) {
+                adjudication.order_succeeds = false;
+                adjudication.resolution_state = RESOLVED;
+            } else {
+                adjudication.resolution_state = UNRESOLVED;
+            }
+
+        // A ring of attack. Every unit moves.
+        } else {
+            if (is_moving(unit)) {
+                adjudication.order_succeeds = true;
+                adjudication.resolution_state = RESOLVED;
+            } else {
+                adjudication.resolution_state = UNRESOLVED;
+            }
+        }
+    }
+
+    number_of_dependencies = first_dependency;
+}
+
+bool MapAndUnits::convoy_route_holds(UNIT_AND_ORDER *army) {
+    for (PROVINCE_INDEX convoying_fleet : army->convoy_step_list) {
+        if (!resolve_order(convoying_fleet)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool MapAndUnits::is_moving(UNIT_AND_ORDER *unit) {
+    return (adjudication_of(unit).order_type_copy == MOVE_ORDER)
+           || (adjudication_of(unit).order_type_copy == MOVE_BY_CONVOY_ORDER);
+}
+
+MapAndUnits::UNIT_AND_ORDER *MapAndUnits::find_head_to_head_opponent(UNIT_AND_ORDER *unit) {
+    UNIT_AND_ORDER *opponent {nullptr};
+
+    // Units swapping places by convoy don't meet
+    if (adjudication_of(unit).order_type_copy != MOVE_ORDER) {
+        return nullptr;
+    }
+
+    auto opponent_itr = units.find(unit->move_dest.province_index);
+    if (opponent_itr != units.end()) {
+        opponent = &(opponent_itr->second);
+
+        if ((adjudication_of(opponent).order_type_copy != MOVE_ORDER)
+            || (opponent->move_dest.province_index != unit->coast_id.province_index)) {
+            opponent = nullptr;
+        }
+    }
+
+    return opponent;
+}
+
+int MapAndUnits::count_supports_given(UNIT_AND_ORDER *unit, bool supports_to_dislodge_only) {
+    int supports_given {0};
+
+    for (PROVINCE_INDEX supporting_unit_province : adjudication_of(unit).supports) {
+        if ((!supports_to_dislodge_only || unit_adjudication[supporting_unit_province].is_support_to_dislodge)
+            && resolve_order(supporting_unit_province)) {
+            supports_given++;
+        }
+    }
+
+    return supports_given;
+}
+
+int MapAndUnits::get_hold_strength(PROVINCE_INDEX province) {
+    UNIT_AND_ORDER *occupying_unit {nullptr};
+
+    auto occupying_unit_itr = units.find(province);
+    if (occupying_unit_itr == units.end()) {
+        return 0;
+    }
+
+    // A unit ordered to move has no support to hold, and leaves the province empty if it goes
+    occupying_unit = &(occupying_unit_itr->second);
+    if (is_moving(occupying_unit)) {
+        return resolve_order(province) ? 0 : 1;
+    }
+
+    return 1 + count_supports_given(occupying_unit, false);
+}
+
+int MapAndUnits::get_attack_strength(UNIT_AND_ORDER *unit) {
+    UNIT_AND_ORDER *occupying_unit {nullptr};
+
+    auto occupying_unit_itr = units.find(unit->move_dest.province_index);
+    if (occupying_unit_itr == units.end()) {
+        return 1 + count_supports_given(unit, false);
+    }
+
+    // Moving into a province as its occupant leaves it
+    occupying_unit = &(occupying_unit_itr->second);
+    if (is_moving(occupying_unit)
+        && (find_head_to_head_opponent(unit) == nullptr)
+        && resolve_order(occupying_unit_itr->first)) {
+        return 1 + count_supports_given(unit, false);
+    }
+
+    // A unit can't dislodge its own side, and can't be helped to dislodge a unit of the supporting power
+    if (occupying_unit->nationality == unit->nationality) {
+        return 0;
+    }
+
+    return 1 + count_supports_given(unit, true);
+}
+
+int MapAndUnits::get_defend_strength(UNIT_AND_ORDER *unit) {
+    return 1 + count_supports_given(unit, false);
+}
+
+int MapAndUnits::get_prevent_strength(UNIT_AND_ORDER *unit) {
+    UNIT_AND_ORDER *opponent {nullptr};
+
+    if ((adjudication_of(unit).order_type_copy == MOVE_BY_CONVOY_ORDER) && !convoy_route_holds(unit)) {
+        return 0;
+    }
+
+    // A unit beaten in a head to head battle doesn't stop anyone else
+    opponent = find_head_to_head_opponent(unit);
+    if ((opponent != nullptr) && resolve_order(opponent->coast_id.province_index)) {
+        return 0;
+    }
+
+    return 1 + count_supports_given(unit, false);
+}
+
+void MapAndUnits::set_dependency_results(const UNIT_SET &units_resolved) {
+    UNIT_AND_ORDER *unit {nullptr};
+    UNIT_AND_ORDER *attacking_unit {nullptr};
+    PROVINCE_INDEX dislodging_unit {-1};
+    bool province_contested {false};
+
+    for (PROVINCE_INDEX unit_province : units_resolved) {
+        unit = &(units[unit_province]);
+
+        switch (adjudication_of(unit).order_type_copy) {
+            case MOVE_ORDER:
+            case MOVE_BY_CONVOY_ORDER:
+                if (adjudication_of(unit).order_succeeds) {
+                    unit->unit_moves = true;
+                } else if ((adjudication_of(unit).order_type_copy == MOVE_BY_CONVOY_ORDER)
+                           && !convoy_route_holds(unit)) {
+                    unit->convoy_broken = true;
+                } else {
+                    unit->bounce = true;
+                }
+                break;
+
+            case SUPPORT_TO_HOLD_ORDER:
+            case SUPPORT_TO_MOVE_ORDER:
+                if (!adjudication_of(unit).order_succeeds) {
+                    unit->support_cut = true;
+                }
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    // Dislodge the units which were moved into, and note where units stood each other off
+    for (PROVINCE_INDEX attacked_province : attacker_lists.get_attacked_provinces()) {
+        dislodging_unit = NO_DISLODGING_UNIT;
+        province_contested = false;
+
+        for (PROVINCE_INDEX attacking_unit_province : attacker_lists.get_attackers(attacked_province)) {
+            attacking_unit = &(units[attacking_unit_province]);
+
+            if (attacking_unit->unit_moves) {
+                dislodging_unit = attacking_unit_province;
+            } else if (get_prevent_strength(attacking_unit) > 0) {
+                province_contested = true;
+            }
+        }
+
+        if (dislodging_unit != NO_DISLODGING_UNIT) {
+            auto occupying_unit_itr = units.find(attacked_province);
+
+            if ((occupying_unit_itr != units.end()) && !occupying_unit_itr->second.unit_moves) {
+                occupying_unit_itr->second.dislodged = true;
+                occupying_unit_itr->second.dislodged_from = dislodging_unit;
+            }
+        } else if (province_contested) {
+            bounce_locations.insert(attacked_province);
+        }
+    }
+}
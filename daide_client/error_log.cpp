@@ -16,53 +16,230 @@
 
 #include <cstdarg>
 #include <cstdio>
+#include <condition_variable>
+#include <ctime>
+#include <deque>
+#include <mutex>
+#include <thread>
 #include <vector>
+
+#include <unistd.h>
+
 #include "daide_client/error_log.h"
 
-// TODO - REWRITE completely
-// Avoid using variadic functions
-// Also log to file
+// TODO - Avoid using variadic functions
 
 using namespace DAIDE;
 
-static FILE *bad_log = nullptr;
-static FILE *big_log = nullptr;
-static bool logging_enabled = true;
+namespace {
 
-static const char *BAD_LOG_FILENAME = "badlog.txt";
-static const char *BIG_LOG_FILENAME = "biglog.txt";
+const char *BAD_LOG_BASENAME = "badlog";
+const char *BIG_LOG_BASENAME = "biglog";
 
-void DAIDE::enable_logging(bool enable) { logging_enabled = enable; }
+const size_t DEFAULT_MAX_FILE_SIZE = 10 * 1024 * 1024;
+const int DEFAULT_MAX_FILE_AGE_SECONDS = 0;                 // No time based rotation
+const int DEFAULT_MAX_ROTATED_FILES = 5;
 
-FILE *DAIDE::open(const char *filename, const char *mode) { return fopen(filename, mode); }
+using LOG_FILE = enum { BAD_LOG, BIG_LOG, NUMBER_OF_LOG_FILES };
+
+// One line waiting to be written
+using LOG_LINE = struct {
+    LOG_FILE log_file;
+    std::string text;
+};
+
+// An open log file and what is needed to decide when to rotate it
+using OPEN_LOG = struct {
+    FILE *file;
+    std::string filename;
+    size_t size;
+    time_t opened_at;
+};
 
-FILE *_get_bad_log() {
-    if (bad_log == nullptr) {
-        bad_log = open(BAD_LOG_FILENAME, "w");
+// Owns the log files. Callers only format their line and queue it; the files are opened, written, rotated and closed
+// on a background thread, so the message loop never waits on the disk.
+class LogWriter {
+public:
+    LogWriter() {
+        for (auto &open_log : m_open_logs) {
+            open_log = OPEN_LOG {nullptr, std::string(), 0, 0};
+        }
     }
-    return bad_log;
-}
 
-FILE *_get_big_log() {
-    if (logging_enabled && big_log == nullptr) {
-        big_log = open(BIG_LOG_FILENAME, "w");
+    LogWriter(const LogWriter &other) = delete;
+    LogWriter& operator=(const LogWriter &other) = delete;
+
+    ~LogWriter() { stop(); }
+
+    void write(LOG_FILE log_file, std::string &&text) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (!m_thread.joinable()) {
+            m_stopping = false;
+            m_thread = std::thread(&LogWriter::run, this);
+        }
+        m_queue.push_back(LOG_LINE {log_file, std::move(text)});
+        m_queue_changed.notify_one();
     }
-    return big_log;
-}
 
-void _log(FILE *file, const char *log, const std::string &prefix = "== ")
-{
-    if (file != nullptr) {
-        fprintf(file, (prefix + "%s\n").c_str(), log);
-        fflush(file);
+    void set_identity(const std::string &identity) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_identity = identity;
+        m_identity_changed = true;
+        m_queue_changed.notify_one();
+    }
+
+    void set_rotation(size_t max_file_size, int max_file_age_seconds, int max_rotated_files) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_max_file_size = max_file_size;
+        m_max_file_age_seconds = max_file_age_seconds;
+        m_max_rotated_files = max_rotated_files;
+    }
+
+    // Write out everything queued, then close the files. Logging again restarts the writer.
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_thread.joinable()) { return; }
+            m_stopping = true;
+            m_queue_changed.notify_one();
+        }
+        m_thread.join();
+    }
+
+private:
+    void run() {
+        std::vector<LOG_LINE> lines;
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        while (true) {
+            // Wake up now and again, so logs are rotated on time even when nothing is being logged
+            m_queue_changed.wait_for(lock, std::chrono::seconds(1), [this] {
+                return m_stopping || m_identity_changed || !m_queue.empty();
+            });
+
+            lines.assign(std::make_move_iterator(m_queue.begin()), std::make_move_iterator(m_queue.end()));
+            m_queue.clear();
+            bool reopen = m_identity_changed;
+            m_identity_changed = false;
+            bool stopping = m_stopping;
+            std::string identity = m_identity;
+            size_t max_file_size = m_max_file_size;
+            int max_file_age_seconds = m_max_file_age_seconds;
+            int max_rotated_files = m_max_rotated_files;
+
+            // File operations are done without the lock, so callers are never held up by them
+            lock.unlock();
+
+            if (reopen) {
+                close_files();
+            }
+
+            for (auto &line : lines) {
+                OPEN_LOG &open_log = get_open_log(line.log_file, identity);
+                if (open_log.file != nullptr) {
+                    fputs(line.text.c_str(), open_log.file);
+                    open_log.size += line.text.size();
+
+                    if ((max_file_size > 0) && (open_log.size >= max_file_size)) {
+                        rotate(open_log, max_rotated_files);
+                    }
+                }
+            }
+            lines.clear();
+
+            for (auto &open_log : m_open_logs) {
+                if (open_log.file != nullptr) {
+                    fflush(open_log.file);
+
+                    if ((max_file_age_seconds > 0) && (time(nullptr) - open_log.opened_at >= max_file_age_seconds)) {
+                        rotate(open_log, max_rotated_files);
+                    }
+                }
+            }
+
+            lock.lock();
+            if (stopping && m_queue.empty()) { break; }
+        }
+
+        lock.unlock();
+        close_files();
+    }
+
+    // The open log for the given file, opening it if necessary. Files are named after the game once it is known,
+    // and after the process until then.
+    OPEN_LOG &get_open_log(LOG_FILE log_file, const std::string &identity) {
+        OPEN_LOG &open_log = m_open_logs[log_file];
+
+        if (open_log.file == nullptr) {
+            open_log.filename = std::string(log_file == BAD_LOG ? BAD_LOG_BASENAME : BIG_LOG_BASENAME) + "_"
+                                + (identity.empty() ? std::to_string(getpid()) : identity) + ".txt";
+
+            // Append, so a bot rejoining a game carries on with the same file
+            open_log.file = open(open_log.filename.c_str(), "a");
+            open_log.size = 0;
+            open_log.opened_at = time(nullptr);
+
+            if (open_log.file != nullptr) {
+                fseek(open_log.file, 0, SEEK_END);
+                open_log.size = static_cast<size_t>(ftell(open_log.file));
+            }
+        }
+        return open_log;
     }
+
+    // Close the file and shift it to .1, .1 to .2 and so on, dropping the oldest. It is reopened on the next write.
+    static void rotate(OPEN_LOG &open_log, int max_rotated_files) {
+        fclose(open_log.file);
+        open_log.file = nullptr;
+
+        if (max_rotated_files <= 0) {
+            remove(open_log.filename.c_str());
+            return;
+        }
+
+        remove((open_log.filename + "." + std::to_string(max_rotated_files)).c_str());
+        for (int file_ctr = max_rotated_files - 1; file_ctr >= 1; file_ctr--) {
+            rename((open_log.filename + "." + std::to_string(file_ctr)).c_str(),
+                   (open_log.filename + "." + std::to_string(file_ctr + 1)).c_str());
+        }
+        rename(open_log.filename.c_str(), (open_log.filename + ".1").c_str());
+    }
+
+    void close_files() {
+        for (auto &open_log : m_open_logs) {
+            if (open_log.file != nullptr) {
+                fclose(open_log.file);
+                open_log.file = nullptr;
+            }
+        }
+    }
+
+    std::mutex m_mutex;
+    std::condition_variable m_queue_changed;
+    std::deque<LOG_LINE> m_queue;
+    std::thread m_thread;
+    bool m_stopping {false};
+
+    std::string m_identity;
+    bool m_identity_changed {false};
+    size_t m_max_file_size {DEFAULT_MAX_FILE_SIZE};
+    int m_max_file_age_seconds {DEFAULT_MAX_FILE_AGE_SECONDS};
+    int m_max_rotated_files {DEFAULT_MAX_ROTATED_FILES};
+
+    // Only touched by the writer thread
+    OPEN_LOG m_open_logs[NUMBER_OF_LOG_FILES];
+};
+
+// Constructed on first use, so it is available to (and outlives) bots constructed during static initialisation
+LogWriter &log_writer() {
+    static LogWriter writer;
+    return writer;
 }
 
-void DAIDE::log(const char *format, ...) {
-    // initialize use of the variable argument array
-    va_list arg_list;
-    va_start(arg_list, format);
+bool logging_enabled = true;
 
+std::string format_message(const char *format, va_list arg_list) {
     // reliably acquire the size from a copy of
     // the variable argument array
     // and a functionally reliable call
@@ -78,49 +255,56 @@ void DAIDE::log(const char *format, ...) {
     // or platform specific behavior
     std::vector<char> buffer(length + 1);
     std::vsnprintf(buffer.data(), buffer.size(), format, arg_list);
-    va_end(arg_list);
+    return std::string(buffer.data(), length);
+}
 
-    _log(_get_big_log(), buffer.data(), "== ");
+void _log(LOG_FILE log_file, const std::string &log, const std::string &prefix = "== ") {
+    log_writer().write(log_file, prefix + log + "\n");
 }
 
-void DAIDE::log_error(const char* format, ...) {
+} // namespace
+
+void DAIDE::enable_logging(bool enable) { logging_enabled = enable; }
+
+FILE *DAIDE::open(const char *filename, const char *mode) { return fopen(filename, mode); }
+
+void DAIDE::set_log_identity(const std::string &identity) { log_writer().set_identity(identity); }
+
+void DAIDE::set_log_rotation(size_t max_file_size, int max_file_age_seconds, int max_rotated_files) {
+    log_writer().set_rotation(max_file_size, max_file_age_seconds, max_rotated_files);
+}
+
+void DAIDE::log(const char *format, ...) {
+    if (!logging_enabled) { return; }
+
     // initialize use of the variable argument array
     va_list arg_list;
     va_start(arg_list, format);
+    std::string message = format_message(format, arg_list);
+    va_end(arg_list);
 
-    // reliably acquire the size from a copy of
-    // the variable argument array
-    // and a functionally reliable call
-    // to mock the formatting
-    va_list vaCopy;
-    va_copy(vaCopy, arg_list);
-    const size_t length = static_cast<size_t>(std::vsnprintf(nullptr, 0, format, vaCopy));
-    va_end(vaCopy);
+    _log(BIG_LOG, message, "== ");
+}
 
-    // return a formatted string without
-    // risking memory mismanagement
-    // and without assuming any compiler
-    // or platform specific behavior
-    std::vector<char> buffer(length + 1);
-    std::vsnprintf(buffer.data(), buffer.size(), format, arg_list);
+void DAIDE::log_error(const char* format, ...) {
+    // initialize use of the variable argument array
+    va_list arg_list;
+    va_start(arg_list, format);
+    std::string message = format_message(format, arg_list);
     va_end(arg_list);
 
-    _log(_get_bad_log(), buffer.data(), "");
-    _log(_get_big_log(), buffer.data(), "== ");
+    _log(BAD_LOG, message, "");
+    if (logging_enabled) {
+        _log(BIG_LOG, message, "== ");
+    }
 }
 
 void DAIDE::log_daide_message(bool is_incoming, const DAIDE::TokenMessage &message) {
-    _log(_get_big_log(), message.get_message_as_text().c_str(), is_incoming ? ">> " : "<< ");
+    if (!logging_enabled) { return; }
+
+    _log(BIG_LOG, message.get_message_as_text(), is_incoming ? ">> " : "<< ");
 }
 
 void DAIDE::close_logs() {
-    if (bad_log != nullptr) {
-        fclose(bad_log);
-        bad_log = nullptr;
-    }
-
-    if (big_log != nullptr) {
-        fclose(big_log);
-        bad_log = nullptr;
-    }
+    log_writer().stop();
 }
@@ -31,6 +31,14 @@ void log_error(const char *format, ...);
 
 void log_daide_message(bool is_incoming, const TokenMessage &message);
 
+// Name the log files after the bot and game (e.g. "DumbBot_FRA_1234"), so several bots can share a directory.
+// Until this is called, the files are named after the process id.
+void set_log_identity(const std::string &identity);
+
+// Rotate each log file once it reaches max_file_size bytes, or has been open for max_file_age_seconds (0 disables
+// either check), keeping up to max_rotated_files older copies (.1 being the newest).
+void set_log_rotation(size_t max_file_size, int max_file_age_seconds, int max_rotated_files);
+
 void close_logs();
 
 } // namespace DAIDE
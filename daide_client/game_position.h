@@ -0,0 +1,42 @@
+/**
+ * Diplomacy AI Client - Part of the DAIDE project.
+ *
+ * Game Position. Everything which changes from turn to turn: the units, the centre ownership, the season and the
+ * orders. It holds no map data, so it is cheap to copy. Take a copy to look ahead, and set it back to undo.
+ * The hashes identify the position, e.g. as the key of a cache, and are copied with it.
+ *
+ * (C) David Norman 2002 david@ellought.demon.co.uk
+ *
+ * This software may be reused for non-commercial purposes without charge, and
+ * without notifying the author. Use of any part of this software for commercial
+ * purposes without permission from the Author is prohibited.
+ *
+ * Release 8~3
+ **/
+
+#ifndef _DAIDE_CLIENT_DAIDE_CLIENT_GAME_POSITION_H
+#define _DAIDE_CLIENT_DAIDE_CLIENT_GAME_POSITION_H
+
+#include <cstdint>
+
+#include "daide_client/map_types.h"
+
+namespace DAIDE {
+
+class GamePosition : public MapTypes {
+public:
+    Token current_season;                       // The current season of play
+    int current_year {0};                       // The current year of play
+    UNITS units;                                // The non-dislodged units
+    UNITS dislodged_units;                      // The dislodged units
+    WINTER_ORDERS winter_orders;                // The winter orders
+    Token province_owner[MAX_PROVINCES];        // The owner of each province (UNO if not owned)
+
+    // Zobrist hashes, kept up to date by the MapAndUnits functions which change the position or the orders
+    uint64_t position_hash {0};                 // Units, dislodged units, centre ownership, season and year
+    uint64_t order_hash {0};                    // The orders of the units, and our winter orders
+};
+
+} // namespace DAIDE
+
+#endif // _DAIDE_CLIENT_DAIDE_CLIENT_GAME_POSITION_H
@@ -0,0 +1,237 @@
+/**
+ * Diplomacy AI Client - Part of the DAIDE project.
+ *
+ * Incremental Adjudicator. Adjudicates a movement turn as the dependency adjudicator does. When the same position is
+ * adjudicated again with only a few orders changed, as it is by bots searching over orders, only the orders which
+ * the changes can affect are resolved again.
+ *
+ * The orders fall into components which can't affect each other's results. Two units are in the same component if their
+ * orders name a common province: the province a unit is in or moves to, the provinces a support or convoy is from and
+ * to, and the fleets on a convoy route. The functions which set orders, and process_orders(), note the units whose
+ * orders they change. The components of the new orders which hold a province a changed order named before or names now
+ * make up whole components of the old orders too, so only their units are adjudicated again. They are found by going
+ * out from those provinces, through the units kept for each province which are in it or whose orders name it. The other
+ * components are made up of the same orders as before, so their units keep the results they had, which are the results
+ * a full adjudication would give. Code which changes orders directly must call rehash() afterwards, as for the hashes.
+ * The changes then show as the order hash not matching the changes noted, and the whole position is adjudicated again.
+ *
+ * Release 8~3
+ **/
+
+#include "daide_client/map_and_units.h"
+
+using DAIDE::MapAndUnits;
+
+void MapAndUnits::adjudicate_moves_incrementally() {
+    bool adjudicate_all {true};
+    uint64_t changed_keys {0};
+    PROVINCE_SET provinces_to_search;
+    PROVINCE_SET provinces_to_resolve;
+    UNIT_SET units_to_resolve;
+    UNIT_SET units_found;
+
+    // Orders changed other than by the functions here show as the order hash not matching the changes noted
+    if (adjudicated_units_valid && (adjudicated_position_hash == position_hash) && !check_orders_on_adjudication
+        && (changed_orders - units.get_provinces()).empty()) {
+        for (PROVINCE_INDEX unit_province : changed_orders) {
+            changed_keys ^= changed_order_keys[unit_province] ^ adjudicated_units[unit_province].order_key;
+        }
+        adjudicate_all = (changed_keys != (order_hash ^ adjudicated_order_hash));
+    }
+
+    // The whole position is adjudicated the first time, once it has changed, and after any change not noted. Checked
+    // orders aren't kept track of.
+    if (adjudicate_all) {
+        adjudicate_moves_by_dependency();
+
+        // Every unit is recorded, and noted against the provinces in its order, from scratch
+        for (PROVINCE_INDEX province = 0; province < number_of_provinces; province++) {
+            units_naming[province].clear();
+        }
+        for (auto &unit_itr : units) {
+            record_adjudicated_order(unit_itr.first, unit_itr.second, get_order_key(unit_itr.second, false));
+            record_adjudicated_results(unit_itr.first, unit_itr.second);
+        }
+
+        adjudicated_units_valid = !check_orders_on_adjudication;
+        adjudicated_position_hash = position_hash;
+        adjudicated_order_hash = order_hash;
+        changed_orders.clear();
+        unit_results_replaced = false;
+        return;
+    }
+
+    // The provinces each changed order named before and names now
+    for (PROVINCE_INDEX unit_province : changed_orders) {
+        ADJUDICATED_UNIT &adjudicated_unit = adjudicated_units[unit_province];
+
+        for (PROVINCE_INDEX province : adjudicated_unit.order_provinces) {
+            units_naming[province].erase(unit_province);
+        }
+        provinces_to_search |= adjudicated_unit.order_provinces;
+
+        record_adjudicated_order(unit_province, units[unit_province], changed_order_keys[unit_province]);
+        provinces_to_search |= adjudicated_unit.order_provinces;
+    }
+
+    // Find the components of the new orders which hold those provinces, going out from them to the units in them or
+    // naming them, and from those units to the provinces they name, until no more are found
+    provinces_to_resolve = provinces_to_search;
+
+    while (!provinces_to_search.empty()) {
+        units_found.clear();
+        for (PROVINCE_INDEX province : provinces_to_search) {
+            units_found |= units_naming[province];
+        }
+        units_found -= units_to_resolve;
+        units_to_resolve |= units_found;
+
+        provinces_to_search.clear();
+        for (PROVINCE_INDEX unit_province : units_found) {
+            provinces_to_search |= adjudicated_units[unit_province].order_provinces;
+        }
+        provinces_to_search -= provinces_to_resolve;
+        provinces_to_resolve |= provinces_to_search;
+    }
+
+    // The other units keep their results, which set_position() may have overwritten since
+    if (unit_results_replaced) {
+        for (PROVINCE_INDEX unit_province : units.get_provinces() - units_to_resolve) {
+            restore_adjudicated_results(unit_province, &(units[unit_province]));
+        }
+        unit_results_replaced = false;
+    }
+
+    // Adjudicate the units found again, from the start. Any standoff in their provinces is found again.
+    attacker_lists.clear();
+    supporting_units.clear();
+    convoying_units.clear();
+    convoyed_units.clear();
+    bounce_locations -= provinces_to_resolve;
+
+    for (PROVINCE_INDEX unit_province : units_to_resolve) {
+        initialise_unit_adjudication(unit_province, &(units[unit_province]));
+    }
+
+    resolve_orders_by_dependency(units_to_resolve);
+
+    for (PROVINCE_INDEX unit_province : units_to_resolve) {
+        record_adjudicated_results(unit_province, units[unit_province]);
+    }
+
+    adjudicated_order_hash = order_hash;
+    changed_orders.clear();
+}
+
+int MapAndUnits::get_named_provinces(const UNIT_AND_ORDER &unit, PROVINCE_INDEX named_provinces[]) const {
+    PROVINCE_INDEX order_provinces[2] {-1, -1};
+    int number_of_named_provinces {0};
+
+    switch (unit.order_type) {
+        case MOVE_ORDER:
+            order_provinces[0] = unit.move_dest.province_index;
+            break;
+
+        case MOVE_BY_CONVOY_ORDER:
+            order_provinces[0] = unit.move_dest.province_index;
+            for (PROVINCE_INDEX convoy_step : unit.convoy_step_list) {
+                if ((convoy_step >= 0) && (convoy_step < number_of_provinces)) {
+                    named_provinces[number_of_named_provinces++] = convoy_step;
+                }
+            }
+            break;
+
+        // A support to hold may name the supported unit in either field
+        case SUPPORT_TO_HOLD_ORDER:
+        case SUPPORT_TO_MOVE_ORDER:
+        case CONVOY_ORDER:
+            order_provinces[0] = unit.other_source_province;
+            order_provinces[1] = unit.other_dest_province;
+            break;
+
+        default:
+            break;
+    }
+
+    for (PROVINCE_INDEX order_province : order_provinces) {
+        if ((order_province >= 0) && (order_province < number_of_provinces)) {
+            named_provinces[number_of_named_provinces++] = order_province;
+        }
+    }
+    return number_of_named_provinces;
+}
+
+void MapAndUnits::note_order_change(PROVINCE_INDEX unit_province, const UNIT_AND_ORDER &unit, uint64_t order_key) {
+    if (order_changed(unit_province, unit, order_key)) {
+        changed_orders.insert(unit_province);
+        changed_order_keys[unit_province] = order_key;
+    } else {
+        changed_orders.erase(unit_province);
+    }
+}
+
+bool MapAndUnits::order_changed(PROVINCE_INDEX unit_province, const UNIT_AND_ORDER &unit, uint64_t order_key) const {
+    const ADJUDICATED_UNIT &adjudicated_unit = adjudicated_units[unit_province];
+
+    // Every field the adjudicator may read. Fields left over from an earlier order only make the unit look changed.
+    return (unit.order_type != adjudicated_unit.order_type)
+           || (unit.move_dest.province_index != adjudicated_unit.move_dest.province_index)
+           || (unit.move_dest.coast_token != adjudicated_unit.move_dest.coast_token)
+           || (unit.other_source_province != adjudicated_unit.other_source_province)
+           || (unit.other_dest_province != adjudicated_unit.other_dest_province)
+           || (order_key != adjudicated_unit.order_key);
+}
+
+void MapAndUnits::record_adjudicated_order(PROVINCE_INDEX unit_province,
+                                           const UNIT_AND_ORDER &unit,
+                                           uint64_t order_key) {
+    ADJUDICATED_UNIT &adjudicated_unit = adjudicated_units[unit_province];
+    PROVINCE_INDEX named_provinces[MAX_PROVINCES];
+    int number_of_named_provinces {0};
+
+    adjudicated_unit.order_type = unit.order_type;
+    adjudicated_unit.move_dest = unit.move_dest;
+    adjudicated_unit.other_source_province = unit.other_source_province;
+    adjudicated_unit.other_dest_province = unit.other_dest_province;
+    adjudicated_unit.order_key = order_key;
+
+    // Also noted against each province, for finding the units to adjudicate again
+    adjudicated_unit.order_provinces.clear();
+    adjudicated_unit.order_provinces.insert(unit_province);
+    units_naming[unit_province].insert(unit_province);
+
+    number_of_named_provinces = get_named_provinces(unit, named_provinces);
+    for (int named_province_ctr = 0; named_province_ctr < number_of_named_provinces; named_province_ctr++) {
+        adjudicated_unit.order_provinces.insert(named_provinces[named_province_ctr]);
+        units_naming[named_provinces[named_province_ctr]].insert(unit_province);
+    }
+}
+
+void MapAndUnits::record_adjudicated_results(PROVINCE_INDEX unit_province, const UNIT_AND_ORDER &unit) {
+    ADJUDICATED_UNIT &adjudicated_unit = adjudicated_units[unit_province];
+
+    adjudicated_unit.no_convoy = unit.no_convoy;
+    adjudicated_unit.no_army_to_convoy = unit.no_army_to_convoy;
+    adjudicated_unit.convoy_broken = unit.convoy_broken;
+    adjudicated_unit.support_void = unit.support_void;
+    adjudicated_unit.support_cut = unit.support_cut;
+    adjudicated_unit.bounce = unit.bounce;
+    adjudicated_unit.dislodged = unit.dislodged;
+    adjudicated_unit.unit_moves = unit.unit_moves;
+    adjudicated_unit.dislodged_from = unit.dislodged_from;
+}
+
+void MapAndUnits::restore_adjudicated_results(PROVINCE_INDEX unit_province, UNIT_AND_ORDER *unit) const {
+    const ADJUDICATED_UNIT &adjudicated_unit = adjudicated_units[unit_province];
+
+    unit->no_convoy = adjudicated_unit.no_convoy;
+    unit->no_army_to_convoy = adjudicated_unit.no_army_to_convoy;
+    unit->convoy_broken = adjudicated_unit.convoy_broken;
+    unit->support_void = adjudicated_unit.support_void;
+    unit->support_cut = adjudicated_unit.support_cut;
+    unit->bounce = adjudicated_unit.bounce;
+    unit->dislodged = adjudicated_unit.dislodged;
+    unit->unit_moves = adjudicated_unit.unit_moves;
+    unit->illegal_order = false;
+    unit->dislodged_from = adjudicated_unit.dislodged_from;
+}
@@ -25,10 +25,12 @@ int main(int argc, char *argv[])
         return 1;
     }
 
-    // Main message loop:
+    // Main message loop. Metrics scrapes are answered while waiting for the server.
     while (the_bot.is_active()) {
-        the_bot.m_socket.ReceiveData();
-        while (the_bot.OnSocketMessage()) {}
+        if (the_bot.m_metrics_server.wait_for_socket(the_bot.m_socket.GetSocket())) {
+            the_bot.m_socket.ReceiveData();
+            while (the_bot.OnSocketMessage()) {}
+        }
     }
     return 0;
 }
@@ -12,13 +12,29 @@
  * Release 8~3
  **/
 
+#include <algorithm>
+
 #include "daide_client/map_and_units.h"
+#include "daide_client/map_cache.h"
 #include "daide_client/token_message.h"
 
 using DAIDE::MapAndUnits;
 using DAIDE::Token;
 using DAIDE::TokenMessage;
 
+namespace {
+
+// Seeds for the order hash keys, so different kinds of order do not share keys
+const uint64_t HASH_SEED_ORDER = 0x6f72647200000000ULL;
+const uint64_t HASH_SEED_WINTER_ORDER = 0x776e747200000000ULL;
+const uint64_t HASH_SEED_WAIVES = 0x7761697600000000ULL;
+
+uint64_t get_coast_value(const DAIDE::MapTypes::COAST_ID &coast) {
+    return (static_cast<uint64_t>(coast.province_index) << 16) | coast.coast_token.get_token();
+}
+
+} // namespace
+
 // Function to get the instance of the MapAndUnits object
 MapAndUnits *MapAndUnits::get_instance() {
     static MapAndUnits object_instance;
@@ -44,319 +60,49 @@ void MapAndUnits::delete_duplicate_instance(MapAndUnits *duplicate) {
     delete duplicate;
 }
 
-// Private constructor. Use get_instance to get the object
-MapAndUnits::MapAndUnits() :
+MapAndUnits::MapAndUnits() : MapAndUnits(MapTopology::empty_topology()) {}
+
+MapAndUnits::MapAndUnits(const std::shared_ptr<const MapTopology> &initial_topology) :
+    game_map {nullptr},
     number_of_provinces {NO_MAP},
     number_of_powers {NO_MAP},
     power_played {Token(0)},
     passcode {0},
     game_started {false},
     game_over {false},
-    current_year {0},
     check_orders_on_submission {true},
     check_orders_on_adjudication {false},
     number_of_disbands {0}
-{}
-
-int MapAndUnits::set_map(const TokenMessage &mdf_message) {
-    int error_location {ADJUDICATOR_NO_ERROR};      // location of error in the message, or ADJUDICATOR_NO_ERROR
-    TokenMessage mdf_command {};                    // The command
-    TokenMessage power_list {};                     // The list of powers
-    TokenMessage provinces {};                      // The provinces
-    TokenMessage adjacencies {};                    // The adjacencies
-
-    // Check there are 4 submessages
-    if (mdf_message.get_submessage_count() != 4) {
-        return 0;               // error location is 0
-    }
-
-    // Get the four parts of the message
-    mdf_command = mdf_message.get_submessage(0);
-    power_list = mdf_message.get_submessage(1);
-    provinces = mdf_message.get_submessage(2);
-    adjacencies = mdf_message.get_submessage(3);
-
-    // Check the mdf command
-    if (!mdf_command.is_single_token() || mdf_command.get_token() != TOKEN_COMMAND_MDF) {
-        return 0;               // error location is 0
-    }
-
-    // Process power list
-    error_location = process_power_list(power_list);
-    if (error_location != ADJUDICATOR_NO_ERROR) { return error_location; }
-
-    // Process provinces
-    error_location = process_provinces(provinces);
-    if (error_location != ADJUDICATOR_NO_ERROR) { return error_location; }
-
-    // Process adjacencies
-    error_location = process_adjacencies(adjacencies);
-    if (error_location != ADJUDICATOR_NO_ERROR) { return error_location; }
-
-    // No errors
-    return error_location;
-}
-
-int MapAndUnits::process_power_list(const TokenMessage &power_list) {
-    bool power_used[MAX_POWERS] {};
-    int error_location {ADJUDICATOR_NO_ERROR};
-    Token power {};
-
-    number_of_powers = power_list.get_message_length();
-
-    // Marking all powers as false
-    for (int power_ctr = 0; power_ctr < number_of_powers; power_ctr++) {
-        power_used[power_ctr] = false;
-    }
-
-    // Making sure powers are valid and not used twice
-    for (int power_ctr = 0; power_ctr < number_of_powers; power_ctr++) {
-        power = power_list.get_token(power_ctr);
-        if ((power.get_subtoken() >= number_of_powers) || (power_used[power.get_subtoken()])) {
-            error_location = power_ctr;
-        } else {
-            power_used[power.get_subtoken()] = true;
-        }
-        if (error_location != ADJUDICATOR_NO_ERROR) { break; }
-    }
-
-    return error_location;
-}
-
-int MapAndUnits::process_provinces(const TokenMessage &provinces) {
-    int error_location {ADJUDICATOR_NO_ERROR};
-    TokenMessage supply_centres {};
-    TokenMessage non_supply_centres {};
-
-    // Resetting all provinces
-    for (auto &province : game_map) {
-        province.province_in_use = false;
-        province.is_supply_centre = false;
-        province.is_land = false;
-        province.coast_info.clear();
-        province.home_centre_set.clear();
-    }
-
-    // Retrieving SC and Non-SC info
-    supply_centres = provinces.get_submessage(0);
-    non_supply_centres = provinces.get_submessage(1);
-
-    // Processing SC
-    error_location = process_supply_centres(supply_centres);
-    if (error_location != ADJUDICATOR_NO_ERROR) { return error_location + provinces.get_submessage_start(0); }
-
-    // Processing Non-SC
-    error_location = process_non_supply_centres(non_supply_centres);
-    if (error_location != ADJUDICATOR_NO_ERROR) { return error_location + provinces.get_submessage_start(1); }
-
-    // Counting provinces
-    // MAX_PROVINCES has 256 provinces, while the standard map has only 81
-    // We should not reach any used province after finding the first unused province
-    number_of_provinces = -1;
-    for (int province_ctr = 0; province_ctr < MAX_PROVINCES; province_ctr++) {
-
-        // Error - Found a used province after an unused one
-        if (game_map[province_ctr].province_in_use && number_of_provinces != -1) {
-            return provinces.get_submessage_start(1) - 1;
-        }
-
-        // End of provinces - First unused province detected
-        if (!game_map[province_ctr].province_in_use && number_of_provinces == -1) {
-            number_of_provinces = province_ctr;
-        }
-    }
-
-    return error_location;
-}
-
-int MapAndUnits::process_supply_centres(const TokenMessage &supply_centres) {
-    int error_location {ADJUDICATOR_NO_ERROR};
-
-    for (int submessage_ctr = 0; submessage_ctr < supply_centres.get_submessage_count(); submessage_ctr++) {
-        error_location = process_supply_centres_for_power(supply_centres.get_submessage(submessage_ctr));
-        if (error_location != ADJUDICATOR_NO_ERROR) {
-            return error_location + supply_centres.get_submessage_start(submessage_ctr);
-        }
-    }
-    return error_location;
-}
-
-int MapAndUnits::process_supply_centres_for_power(const TokenMessage &supply_centres) {
-    int error_location {ADJUDICATOR_NO_ERROR};
-    int province_index {-1};
-    Token token {};
-    Token power {TOKEN_PARAMETER_UNO};
-    TokenMessage submessage {};
-    HOME_CENTRE_SET home_centre_set;
-
-    for (int submessage_ctr = 0; submessage_ctr < supply_centres.get_submessage_count(); submessage_ctr++) {
-        submessage = supply_centres.get_submessage(submessage_ctr);
-
-        // Single token (POWER, PROVINCE)
-        if (submessage.is_single_token()) {
-            token = submessage.get_token();
-
-            // Token is power
-            if (token.get_category() == CATEGORY_POWER) {
-
-                // Error - Too many powers
-                if (token.get_subtoken() >= number_of_powers) {
-                    return supply_centres.get_submessage_start(submessage_ctr);
-                }
-
-                home_centre_set.insert(token.get_subtoken());
-                power = token;
-
-            // Token is province
-            } else if (token.is_province()) {
-                province_index = token.get_subtoken();
-
-                // Error - Province already in use
-                if (game_map[province_index].province_in_use) {
-                    return supply_centres.get_submessage_start(submessage_ctr);
-                }
-
-                game_map[province_index].province_token = token;
-                game_map[province_index].province_in_use = true;
-                game_map[province_index].home_centre_set = home_centre_set;
-                game_map[province_index].is_supply_centre = true;
-                game_map[province_index].owner = power;
-
-
-            // Unexpected token
-            } else if (token != TOKEN_PARAMETER_UNO) {
-                return supply_centres.get_submessage_start(submessage_ctr);
-            }
-
-        // Multiple tokens
-        } else {
-            for (int token_ctr = 0; token_ctr < submessage.get_message_length(); token_ctr++) {
-                token = submessage.get_token(token_ctr);
-
-                // Power
-                if (token.get_category() == CATEGORY_POWER) {
-
-                    // Error - Too many powers
-                    if (token.get_subtoken() >= number_of_powers) {
-                        return token_ctr + supply_centres.get_submessage_start(submessage_ctr);
-                    }
-
-                    home_centre_set.insert(token.get_subtoken());
-                    power = token;
-
-                // Unknown token
-                } else {
-                    return supply_centres.get_submessage_start(submessage_ctr);
-                }
-            }
-        }
-    }
-
-    return error_location;
-}
-
-int MapAndUnits::process_non_supply_centres(const TokenMessage &non_supply_centres) {
-    int error_location {ADJUDICATOR_NO_ERROR};
-    int province_index {-1};
-    Token token {};
-
-    for (int token_ctr = 0; token_ctr < non_supply_centres.get_message_length(); token_ctr++) {
-        token = non_supply_centres.get_token(token_ctr);
-
-        // Province
-        if (token.is_province()) {
-            province_index = token.get_subtoken();
-            if (game_map[province_index].province_in_use) { return token_ctr; }
-            game_map[province_index].province_token = token;
-            game_map[province_index].province_in_use = true;
-            game_map[province_index].owner = TOKEN_PARAMETER_UNO;
-
-        // Unexpected token
-        } else if (token != TOKEN_PARAMETER_UNO) { return token_ctr; }
-    }
-
-    return error_location;
+{
+    set_topology(initial_topology);
 }
 
-int MapAndUnits::process_adjacencies(const TokenMessage &adjacencies) {
+int MapAndUnits::set_map(const TokenMessage &mdf_message) {
     int error_location {ADJUDICATOR_NO_ERROR};
-    TokenMessage province_adjacency {};
 
-    for (int province_ctr = 0; province_ctr < adjacencies.get_submessage_count(); province_ctr++) {
-        province_adjacency = adjacencies.get_submessage(province_ctr);
-        error_location = process_province_adjacency(province_adjacency);
-        if (error_location != ADJUDICATOR_NO_ERROR) {
-            return error_location + adjacencies.get_submessage_start(province_ctr);
-        }
+    // The map is only replaced if the whole message is valid. A map seen before is not compiled again.
+    std::shared_ptr<const MapTopology> new_topology = MapCache::get_topology(mdf_message, &error_location);
+    if (new_topology != nullptr) {
+        set_topology(new_topology);
     }
     return error_location;
 }
 
-int MapAndUnits::process_province_adjacency(const TokenMessage &province_adjacency) {
-    int error_location {ADJUDICATOR_NO_ERROR};
-    Token province_token {};
-    TokenMessage adjacency_list {};
-    PROVINCE_DETAILS *province_details {nullptr};
+void MapAndUnits::set_topology(const std::shared_ptr<const MapTopology> &new_topology) {
+    topology = new_topology;
+    game_map = topology->game_map;
+    number_of_provinces = topology->number_of_provinces;
+    number_of_powers = topology->number_of_powers;
 
-    province_token = province_adjacency.get_token(0);
-    province_details = &(game_map[province_token.get_subtoken()]);
+    convoy_reachability.set_topology(topology);
 
-    if (!province_details->province_in_use || !province_details->coast_info.empty()) {
-        return 0;           // error_location = 0
+    // Centres start with their owners from the MDF
+    for (int province_ctr = 0; province_ctr < MAX_PROVINCES; province_ctr++) {
+        province_owner[province_ctr] = game_map[province_ctr].initial_owner;
     }
 
-    for (int adjacency_ctr = 1; adjacency_ctr < province_adjacency.get_submessage_count(); adjacency_ctr++) {
-        adjacency_list = province_adjacency.get_submessage(adjacency_ctr);
-        error_location = process_adjacency_list(province_details, adjacency_list);
-        if (error_location != ADJUDICATOR_NO_ERROR) {
-            return error_location + province_adjacency.get_submessage_start(adjacency_ctr);
-        }
-    }
-    return error_location;
-}
-
-int MapAndUnits::process_adjacency_list(PROVINCE_DETAILS *province_details, const TokenMessage &adjacency_list) {
-    int error_location {ADJUDICATOR_NO_ERROR};
-    COAST_ID adjacent_coast {-1};
-    Token coast_token {};
-    Token adjacent_coast_token {};
-    Token province_token {};
-    TokenMessage adjacency_token {};
-    COAST_DETAILS *coast_details {nullptr};
-
-    adjacency_token = adjacency_list.get_submessage(0);
-
-    if (adjacency_token.is_single_token()) {
-        coast_token = adjacency_token.get_token();
-        adjacent_coast_token = coast_token;
-        if (coast_token == TOKEN_UNIT_AMY) { province_details->is_land = true; }
-    } else {
-        coast_token = adjacency_token.get_token(1);
-        adjacent_coast_token = TOKEN_UNIT_FLT;
-    }
-
-    coast_details = &(province_details->coast_info[coast_token]);
-    if (!coast_details->adjacent_coasts.empty()) {
-        return 0;               // error_location = 0
-    }
-
-    for (int adjacency_ctr = 1; adjacency_ctr < adjacency_list.get_submessage_count(); adjacency_ctr++) {
-        adjacency_token = adjacency_list.get_submessage(adjacency_ctr);
-
-        if (adjacency_token.is_single_token()) {
-            province_token = adjacency_token.get_token();
-            adjacent_coast.province_index = province_token.get_subtoken();
-            adjacent_coast.coast_token = adjacent_coast_token;
-        } else {
-            province_token = adjacency_token.get_token(0);
-            coast_token = adjacency_token.get_token(1);
-            adjacent_coast.province_index = province_token.get_subtoken();
-            adjacent_coast.coast_token = coast_token;
-        }
-
-        coast_details->adjacent_coasts.insert(adjacent_coast);
-    }
-    return error_location;
+    // The keys belong to the topology, so everything has to be hashed again
+    rehash();
 }
 
 void MapAndUnits::set_power_played(const Token &power) {
@@ -417,7 +163,7 @@ int MapAndUnits::process_sco_for_power(const TokenMessage &sco_for_power) {
         // Error - Too many provinces
         if (province.get_subtoken() >= number_of_provinces) { return province_ctr; }
 
-        game_map[province.get_subtoken()].owner = power;
+        set_province_owner(province.get_subtoken(), power);
         if (power == power_played) { our_centres.insert(province.get_subtoken()); }
     }
     return error_location;
@@ -438,10 +184,10 @@ int MapAndUnits::set_units(const TokenMessage &now_message) {
         }
 
         turn_message = now_message.get_submessage(1);
-        current_season = turn_message.get_token(0);
-        current_year = turn_message.get_token(1).get_number();
+        set_turn(turn_message.get_token(0), turn_message.get_token(1).get_number());
 
-        // Resetting units
+        // Resetting units, and with them all the orders
+        position_hash ^= get_units_hash(units, false) ^ get_units_hash(dislodged_units, true);
         units.clear();
         dislodged_units.clear();
         our_units.clear();
@@ -449,6 +195,7 @@ int MapAndUnits::set_units(const TokenMessage &now_message) {
         open_home_centres.clear();
         our_winter_orders.builds_or_disbands.clear();
         our_winter_orders.number_of_waives = 0;
+        order_hash = 0;
 
         // Store the unit positions
         for (int unit_ctr = 2; unit_ctr < now_message.get_submessage_count(); unit_ctr++) {
@@ -464,7 +211,7 @@ int MapAndUnits::set_units(const TokenMessage &now_message) {
             open_home_centres.clear();
 
             for (int home_centre : home_centres) {
-                if ((game_map[home_centre].owner == power_played) && (units.find(home_centre) == units.end())) {
+                if ((province_owner[home_centre] == power_played) && (units.find(home_centre) == units.end())) {
                     open_home_centres.insert(home_centre);
                 }
             }
@@ -542,14 +289,18 @@ int MapAndUnits::process_now_unit(const TokenMessage &unit_message) {
         for (int retreat_loc_ctr = 0; retreat_loc_ctr < retreat_option_list.get_submessage_count(); retreat_loc_ctr++) {
             unit.retreat_options.insert(get_coast_id(retreat_option_list.get_submessage(retreat_loc_ctr), unit_type));
         }
+        remove_unit_from_hash(dislodged_units, prov.get_subtoken(), true);
         dislodged_units[prov.get_subtoken()] = unit;
+        position_hash ^= get_unit_key(unit, true);
         if (nationality == power_played.get_subtoken()) {
             our_dislodged_units.insert(prov.get_subtoken());
         }
 
     // Unit is not dislodged
     } else {
+        remove_unit_from_hash(units, prov.get_subtoken(), false);
         units[prov.get_subtoken()] = unit;
+        position_hash ^= get_unit_key(unit, false);
         if (nationality == power_played.get_subtoken()) {
             our_units.insert(prov.get_subtoken());
         }
@@ -639,54 +390,79 @@ int MapAndUnits::store_result(const TokenMessage &ord_message) {
 
 bool MapAndUnits::set_hold_order(PROVINCE_INDEX unit) {
     bool unit_ordered {true};                       // Whether the unit was ordered successfully
+    uint64_t order_key {0};                         // The key of the new order
 
     auto unit_to_order = units.find(unit);
     if (unit_to_order == units.end()) {
         unit_ordered = false;
     } else {
+        order_hash ^= get_order_key(unit_to_order->second, false);
         unit_to_order->second.order_type = HOLD_ORDER;
+        order_key = get_order_key(unit_to_order->second, false);
+        order_hash ^= order_key;
+        note_order_change(unit, unit_to_order->second, order_key);
     }
     return unit_ordered;
 }
 
 bool MapAndUnits::set_move_order(PROVINCE_INDEX unit, const COAST_ID &destination) {
     bool unit_ordered {true};                       // Whether the unit was ordered successfully
+    uint64_t order_key {0};                         // The key of the new order
 
     auto unit_to_order = units.find(unit);
     if (unit_to_order == units.end()) {
         unit_ordered = false;
     } else {
+        order_hash ^= get_order_key(unit_to_order->second, false);
         unit_to_order->second.order_type = MOVE_ORDER;
         unit_to_order->second.move_dest = destination;
+        order_key = get_order_key(unit_to_order->second, false);
+        order_hash ^= order_key;
+        note_order_change(unit, unit_to_order->second, order_key);
     }
     return unit_ordered;
 }
 
 bool MapAndUnits::set_support_to_hold_order(PROVINCE_INDEX unit, PROVINCE_INDEX supported_unit) {
     bool unit_ordered {true};                       // Whether the unit was ordered successfully
+    uint64_t order_key {0};                         // The key of the new order
 
     auto unit_to_order = units.find(unit);
     if (unit_to_order == units.end()) {
         unit_ordered = false;
     } else {
-        unit_to_order->second.order_type = SUPPORT_TO_HOLD_ORDER;
-        unit_to_order->second.other_dest_province = supported_unit;
+        order_hash ^= get_order_key(unit_to_order->second, false);
+        order_support_to_hold(unit_to_order->second, supported_unit);
+        order_key = get_order_key(unit_to_order->second, false);
+        order_hash ^= order_key;
+        note_order_change(unit, unit_to_order->second, order_key);
     }
     return unit_ordered;
 }
 
+void MapAndUnits::order_support_to_hold(UNIT_AND_ORDER &unit, PROVINCE_INDEX supported_unit) {
+    unit.order_type = SUPPORT_TO_HOLD_ORDER;
+    unit.other_source_province = supported_unit;
+    unit.other_dest_province = supported_unit;
+}
+
 bool MapAndUnits::set_support_to_move_order(PROVINCE_INDEX unit,
                                             PROVINCE_INDEX supported_unit,
                                             PROVINCE_INDEX destination) {
     bool unit_ordered {true};                       // Whether the unit was ordered successfully
+    uint64_t order_key {0};                         // The key of the new order
 
     auto unit_to_order = units.find(unit);
     if (unit_to_order == units.end()) {
         unit_ordered = false;
     } else {
+        order_hash ^= get_order_key(unit_to_order->second, false);
         unit_to_order->second.order_type = SUPPORT_TO_MOVE_ORDER;
         unit_to_order->second.other_source_province = supported_unit;
         unit_to_order->second.other_dest_province = destination;
+        order_key = get_order_key(unit_to_order->second, false);
+        order_hash ^= order_key;
+        note_order_change(unit, unit_to_order->second, order_key);
     }
     return unit_ordered;
 }
@@ -695,14 +471,19 @@ bool MapAndUnits::set_convoy_order(PROVINCE_INDEX unit,
                                    PROVINCE_INDEX convoyed_army,
                                    PROVINCE_INDEX destination) {
     bool unit_ordered {true};                       // Whether the unit was ordered successfully
+    uint64_t order_key {0};                         // The key of the new order
 
     auto unit_to_order = units.find(unit);
     if (unit_to_order == units.end()) {
         unit_ordered = false;
     } else {
+        order_hash ^= get_order_key(unit_to_order->second, false);
         unit_to_order->second.order_type = CONVOY_ORDER;
         unit_to_order->second.other_source_province = convoyed_army;
         unit_to_order->second.other_dest_province = destination;
+        order_key = get_order_key(unit_to_order->second, false);
+        order_hash ^= order_key;
+        note_order_change(unit, unit_to_order->second, order_key);
     }
     return unit_ordered;
 }
@@ -710,14 +491,16 @@ bool MapAndUnits::set_convoy_order(PROVINCE_INDEX unit,
 bool MapAndUnits::set_move_by_convoy_order(PROVINCE_INDEX unit,
                                            PROVINCE_INDEX destination,
                                            int number_of_steps,
-                                           PROVINCE_INDEX step_list[]) {
+                                           const PROVINCE_INDEX step_list[]) {
     bool unit_ordered {true};                       // Whether the unit was ordered successfully
+    uint64_t order_key {0};                         // The key of the new order
 
     auto unit_to_order = units.find(unit);
     if (unit_to_order == units.end()) {
         unit_ordered = false;
 
     } else {
+        order_hash ^= get_order_key(unit_to_order->second, false);
         unit_to_order->second.order_type = MOVE_BY_CONVOY_ORDER;
         unit_to_order->second.move_dest.province_index = destination;
         unit_to_order->second.move_dest.coast_token = TOKEN_UNIT_AMY;
@@ -726,6 +509,9 @@ bool MapAndUnits::set_move_by_convoy_order(PROVINCE_INDEX unit,
         for (int step_ctr = 0; step_ctr < number_of_steps; step_ctr++) {
             unit_to_order->second.convoy_step_list.push_back(step_list[step_ctr]);
         }
+        order_key = get_order_key(unit_to_order->second, false);
+        order_hash ^= order_key;
+        note_order_change(unit, unit_to_order->second, order_key);
     }
     return unit_ordered;
 }
@@ -737,7 +523,9 @@ bool MapAndUnits::set_disband_order(PROVINCE_INDEX unit) {
     if (unit_to_order == dislodged_units.end()) {
         unit_ordered = false;
     } else {
+        order_hash ^= get_order_key(unit_to_order->second, true);
         unit_to_order->second.order_type = DISBAND_ORDER;
+        order_hash ^= get_order_key(unit_to_order->second, true);
     }
     return unit_ordered;
 }
@@ -749,8 +537,10 @@ bool MapAndUnits::set_retreat_order(PROVINCE_INDEX unit, const COAST_ID &destina
     if (unit_to_order == dislodged_units.end()) {
         unit_ordered = false;
     } else {
+        order_hash ^= get_order_key(unit_to_order->second, true);
         unit_to_order->second.order_type = RETREAT_ORDER;
         unit_to_order->second.move_dest = destination;
+        order_hash ^= get_order_key(unit_to_order->second, true);
     }
     return unit_ordered;
 }
@@ -765,11 +555,14 @@ void MapAndUnits::set_build_order(const COAST_ID &location) {
     if ((matching_unit != our_winter_orders.builds_or_disbands.end())
         && (matching_unit->first.province_index == location.province_index)) {
 
+        order_hash ^= get_winter_order_key(matching_unit->first, our_winter_orders.is_building);
         our_winter_orders.builds_or_disbands.erase(matching_unit);
     }
 
-    our_winter_orders.builds_or_disbands.insert(BUILDS_OR_DISBANDS::value_type(location, Token(0)));
-    our_winter_orders.is_building = true;
+    set_is_building(true);
+    if (our_winter_orders.builds_or_disbands.insert(BUILDS_OR_DISBANDS::value_type(location, Token(0))).second) {
+        order_hash ^= get_winter_order_key(location, true);
+    }
 }
 
 bool MapAndUnits::set_remove_order(PROVINCE_INDEX unit) {
@@ -779,9 +572,11 @@ bool MapAndUnits::set_remove_order(PROVINCE_INDEX unit) {
     if (unit_itr == units.end()) {
         unit_ordered = false;
     } else {
-        our_winter_orders.builds_or_disbands.insert(
-                BUILDS_OR_DISBANDS::value_type(unit_itr->second.coast_id, Token(0)));
-        our_winter_orders.is_building = false;
+        set_is_building(false);
+        if (our_winter_orders.builds_or_disbands.insert(
+                BUILDS_OR_DISBANDS::value_type(unit_itr->second.coast_id, Token(0))).second) {
+            order_hash ^= get_winter_order_key(unit_itr->second.coast_id, false);
+        }
     }
     return unit_ordered;
 }
@@ -797,6 +592,7 @@ bool MapAndUnits::cancel_build_order(PROVINCE_INDEX location) {
     if ((matching_unit != our_winter_orders.builds_or_disbands.end())
         && (matching_unit->first.province_index == location)) {
 
+        order_hash ^= get_winter_order_key(matching_unit->first, our_winter_orders.is_building);
         our_winter_orders.builds_or_disbands.erase(matching_unit);
         order_found = true;
     } else {
@@ -893,6 +689,9 @@ void MapAndUnits::clear_all_orders() {
     for (auto &dislodged_unit : dislodged_units) { dislodged_unit.second.order_type = NO_ORDER; }
     our_winter_orders.builds_or_disbands.clear();
     our_winter_orders.number_of_waives = 0;
+
+    // No orders left to hash
+    order_hash = 0;
 }
 
 MapAndUnits::COAST_ID MapAndUnits::get_coast_id(const TokenMessage &coast, const Token &unit_type) {
@@ -1007,8 +806,7 @@ void MapAndUnits::decode_order(UNIT_AND_ORDER &unit, const TokenMessage &order)
     // Support
     } else if (order_type == TOKEN_ORDER_SUP) {
         if (order.get_submessage_count() == 3) {
-            unit.order_type = SUPPORT_TO_HOLD_ORDER;
-            unit.other_dest_province = get_coast_from_unit(order.get_submessage(2)).province_index;
+            order_support_to_hold(unit, get_coast_from_unit(order.get_submessage(2)).province_index);
         } else {
             unit.order_type = SUPPORT_TO_MOVE_ORDER;
             unit.other_source_province = get_coast_from_unit(order.get_submessage(2)).province_index;
@@ -1325,12 +1123,12 @@ bool MapAndUnits::get_variant_setting(const Token &variant_option, Token *parame
     return variant_found;
 }
 
-MapAndUnits::COAST_SET *MapAndUnits::get_adjacent_coasts(COAST_ID &coast) {
-    return &(game_map[coast.province_index].coast_info[coast.coast_token].adjacent_coasts);
+const MapAndUnits::COAST_SET *MapAndUnits::get_adjacent_coasts(const COAST_ID &coast) const {
+    return &(topology->get_adjacent_coasts(coast));
 }
 
-MapAndUnits::COAST_SET *MapAndUnits::get_adjacent_coasts(PROVINCE_INDEX &unit_location) {
-    COAST_SET *adjacent_coasts {nullptr};
+const MapAndUnits::COAST_SET *MapAndUnits::get_adjacent_coasts(PROVINCE_INDEX &unit_location) {
+    const COAST_SET *adjacent_coasts {nullptr};
 
     auto unit_itr = units.find(unit_location);
     if (unit_itr != units.end()) {
@@ -1339,8 +1137,9 @@ MapAndUnits::COAST_SET *MapAndUnits::get_adjacent_coasts(PROVINCE_INDEX &unit_lo
     return adjacent_coasts;
 }
 
-MapAndUnits::COAST_SET *MapAndUnits::get_dislodged_unit_adjacent_coasts(PROVINCE_INDEX &dislodged_unit_location) {
-    COAST_SET *adjacent_coasts {nullptr};
+const MapAndUnits::COAST_SET *MapAndUnits::get_dislodged_unit_adjacent_coasts(
+        PROVINCE_INDEX &dislodged_unit_location) {
+    const COAST_SET *adjacent_coasts {nullptr};
 
     auto unit_itr = dislodged_units.find(dislodged_unit_location);
     if (unit_itr != dislodged_units.end()) {
@@ -1368,7 +1167,19 @@ int MapAndUnits::process_orders(const TokenMessage &sub_message, POWER_INDEX pow
     for (int submessage_ctr = 1; submessage_ctr < sub_message.get_submessage_count(); submessage_ctr++) {
         order = sub_message.get_submessage(submessage_ctr);
         order_result[submessage_ctr - 1] = process_order(order, power_index);
+
+        // Noted as the setters do, for the incremental adjudicator. A rejected order may have been partly written.
+        if ((current_season == TOKEN_SEASON_SPR) || (current_season == TOKEN_SEASON_FAL)) {
+            UNIT_AND_ORDER *unit_record = find_unit(order.get_submessage(0), units);
+
+            if (unit_record != nullptr) {
+                note_order_change(unit_record->coast_id.province_index, *unit_record, get_order_key(*unit_record, false));
+            }
+        }
     }
+
+    // The orders are written in many places while being checked, so hash them once they are all in
+    order_hash = compute_order_hash();
     return error_location;
 }
 
@@ -1459,8 +1270,7 @@ Token MapAndUnits::process_order(TokenMessage &order, POWER_INDEX power_index) {
                 return TOKEN_ORDER_NOTE_FAR;                    // Supports itself
             }
 
-            unit_record->order_type = SUPPORT_TO_HOLD_ORDER;
-            unit_record->other_source_province = supported_unit->coast_id.province_index;
+            order_support_to_hold(*unit_record, supported_unit->coast_id.province_index);
 
         // Support Move
         } else {
@@ -1613,7 +1423,7 @@ Token MapAndUnits::process_order(TokenMessage &order, POWER_INDEX power_index) {
                    == game_map[build_loc.province_index].home_centre_set.end()) {
             return TOKEN_ORDER_NOTE_HSC;
         }
-        if (game_map[build_loc.province_index].owner.get_subtoken() != power_index) { return TOKEN_ORDER_NOTE_YSC; }
+        if (province_owner[build_loc.province_index].get_subtoken() != power_index) { return TOKEN_ORDER_NOTE_YSC; }
         if (units.find(build_loc.province_index) != units.end()) { return TOKEN_ORDER_NOTE_ESC; }
         if (game_map[build_loc.province_index].coast_info.find(build_loc.coast_token)
                    == game_map[build_loc.province_index].coast_info.end()) {
@@ -1710,91 +1520,91 @@ MapAndUnits::UNIT_AND_ORDER *MapAndUnits::find_unit(const TokenMessage &unit_to_
     return found_unit;
 }
 
-bool MapAndUnits::can_move_to(UNIT_AND_ORDER *unit, const COAST_ID &destination) {
-    bool can_move {false};
-
-    auto coast_details = game_map[unit->coast_id.province_index].coast_info.find(unit->coast_id.coast_token);
-    if (coast_details != game_map[unit->coast_id.province_index].coast_info.end()) {
-        if (coast_details->second.adjacent_coasts.find(destination) != coast_details->second.adjacent_coasts.end()) {
-            can_move = true;
-        }
-    }
-    return can_move;
+bool MapAndUnits::can_move_to(const UNIT_AND_ORDER *unit, const COAST_ID &destination) const {
+    return topology->can_move_to(topology->get_coast_index(unit->coast_id), topology->get_coast_index(destination));
 }
 
-bool MapAndUnits::can_move_to_province(UNIT_AND_ORDER *unit, int province_index) {
-    bool can_move {false};
-    COAST_ID min_coast {};
-    COAST_SET *adjacencies {nullptr};
-
-    auto coast_details = game_map[unit->coast_id.province_index].coast_info.find(unit->coast_id.coast_token);
-    if (coast_details != game_map[unit->coast_id.province_index].coast_info.end()) {
-        adjacencies = &(coast_details->second.adjacent_coasts);
-        min_coast.province_index = province_index;
-        min_coast.coast_token = 0;
-
-        auto first_record = adjacencies->lower_bound(min_coast);
-        if ((first_record != adjacencies->end()) && (first_record->province_index == province_index)) {
-            can_move = true;
-        }
-    }
-    return can_move;
+bool MapAndUnits::can_move_to_province(const UNIT_AND_ORDER *unit, int province_index) const {
+    return topology->can_move_to_province(topology->get_coast_index(unit->coast_id), province_index);
 }
 
-bool MapAndUnits::has_route_to_province(UNIT_AND_ORDER *unit,
+bool MapAndUnits::has_route_to_province(const UNIT_AND_ORDER *unit,
                                         PROVINCE_INDEX province_index,
-                                        PROVINCE_INDEX province_to_avoid) {
+                                        PROVINCE_INDEX province_to_avoid) const {
+    PROVINCE_INDEX army_province = unit->coast_id.province_index;
     bool has_route {false};                                 // Whether there is a route
-    PROVINCE_SET checked_provinces;                         // Provinces which have already been checked
-    PROVINCE_SET provinces_to_check;                        // Provinces still to check
-    PROVINCE_INDEX province_being_checked {-1};             // Province currently being processed
 
     // First check if it can move directly
     has_route = can_move_to_province(unit, province_index);
 
     // If not, check for convoy routes
-    if (!has_route && (unit->unit_type == TOKEN_UNIT_AMY) && (game_map[province_index].is_land)) {
-        checked_provinces.insert(unit->coast_id.province_index);        // Mark the source province as checked
-
-        // Add all the adjacent provinces to the province to check list
-        for (auto &coast_itr : game_map[unit->coast_id.province_index].coast_info) {
-            for (const auto &adjacent_coast : coast_itr.second.adjacent_coasts) {
-                provinces_to_check.insert(adjacent_coast.province_index);
+    if (!has_route && (unit->unit_type == TOKEN_UNIT_AMY) && (game_map[province_index].is_land)
+        && (province_index != army_province) && (province_index != province_to_avoid)) {
+
+        // A land province next to the army counts, whichever unit type it is next to
+        INDEX_LIST adjacent_provinces = topology->get_province_adjacencies(army_province);
+        has_route = std::binary_search(adjacent_provinces.begin(), adjacent_provinces.end(), province_index);
+
+        if (!has_route) {
+            convoy_reachability.update(units.get_provinces());
+            has_route = convoy_reachability.can_convoy(army_province, province_index);
+
+            // The route may need the fleet to avoid, so search again without it. This is used to stop a fleet
+            // supporting a convoyed move that must be convoyed by that fleet.
+            if (has_route && (province_to_avoid != -1)
+                && convoy_reachability.get_fleets_at_sea().contains(province_to_avoid)) {
+                has_route = find_convoy_route(unit, province_index, province_to_avoid);
             }
         }
+    }
+    return has_route;
+}
 
-        // If there is a province to avoid, then mark it as already checked. This will stop
-        // any routes from going through it. This is used to stop a fleet supporting a convoyed
-        // move that must be convoyed by that fleet
-        if (province_to_avoid != -1) {
-            checked_provinces.insert(province_to_avoid);
-        }
+bool MapAndUnits::find_convoy_route(const UNIT_AND_ORDER *unit,
+                                    PROVINCE_INDEX province_index,
+                                    PROVINCE_INDEX province_to_avoid) const {
+    bool has_route {false};                                 // Whether there is a route
+    bool queued_provinces[MAX_PROVINCES] {};                // Provinces which have been added to the list to check
+    PROVINCE_INDEX provinces_to_check[MAX_PROVINCES];       // Provinces still to check
+    int number_to_check {0};
+    PROVINCE_INDEX province_being_checked {-1};             // Province currently being processed
 
-        // While there are provinces to check
-        while (!provinces_to_check.empty() && !has_route) {
-            province_being_checked = *(provinces_to_check.begin());     // Get the first
-            provinces_to_check.erase(provinces_to_check.begin());
+    queued_provinces[unit->coast_id.province_index] = true;             // Mark the source province as checked
 
-            // Check we haven't done it already
-            if (checked_provinces.find(province_being_checked) == checked_provinces.end()) {
-                checked_provinces.insert(province_being_checked);       // Add it to those we've done
+    // If there is a province to avoid, then mark it as already checked. This will stop
+    // any routes from going through it.
+    if (province_to_avoid != -1) {
+        queued_provinces[province_to_avoid] = true;
+    }
 
-                // If it is a land province then check if it is the destination
-                if (game_map[province_being_checked].is_land) {
-                    if (province_being_checked == province_index) {
-                        has_route = true;
-                    }
+    // Add all the adjacent provinces to the province to check list. Each province is only added once, so the
+    // list never holds more than MAX_PROVINCES entries.
+    for (PROVINCE_INDEX adjacent_province : topology->get_province_adjacencies(unit->coast_id.province_index)) {
+        if (!queued_provinces[adjacent_province]) {
+            queued_provinces[adjacent_province] = true;
+            provinces_to_check[number_to_check++] = adjacent_province;
+        }
+    }
+
+    // While there are provinces to check
+    while ((number_to_check > 0) && !has_route) {
+        province_being_checked = provinces_to_check[--number_to_check];
 
-                // Sea province, so check if occupied. If it is then add all adjacent provinces
-                } else {
-                    if (units.find(province_being_checked) != units.end()) {
+        // If it is a land province then check if it is the destination
+        if (game_map[province_being_checked].is_land) {
+            if (province_being_checked == province_index) {
+                has_route = true;
+            }
+
+        // Sea province, so check if occupied. If it is then add all adjacent provinces
+        } else {
+            if (units.find(province_being_checked) != units.end()) {
 
-                        // Add all the adjacent provinces to the province to check list
-                        for (auto &coast_itr : game_map[province_being_checked].coast_info) {
-                            for (const auto &adjacent_coast : coast_itr.second.adjacent_coasts) {
-                                provinces_to_check.insert(adjacent_coast.province_index);
-                            }
-                        }
+                // Add all the adjacent provinces to the province to check list
+                for (PROVINCE_INDEX adjacent_province : topology->get_province_adjacencies(province_being_checked)) {
+                    if (!queued_provinces[adjacent_province]) {
+                        queued_provinces[adjacent_province] = true;
+                        provinces_to_check[number_to_check++] = adjacent_province;
                     }
                 }
             }
@@ -1816,18 +1626,17 @@ int MapAndUnits::get_adjudication_results(TokenMessage ord_messages[]) {
 }
 
 int MapAndUnits::get_movement_results(TokenMessage ord_messages[]) {
-    int unit_ctr {0};
-    UNIT_AND_ORDER *unit {nullptr};
+    UNIT_RESULT results[MAX_PROVINCES];
+    int number_of_results = get_move_results(results);
 
-    for (auto &unit_itr : units) {
-        unit = &(unit_itr.second);
-        ord_messages[unit_ctr] = describe_movement_result(unit);
-        unit_ctr++;
+    for (int result_ctr = 0; result_ctr < number_of_results; result_ctr++) {
+        ord_messages[result_ctr] = describe_movement_result(&(units[results[result_ctr].province]),
+                                                            results[result_ctr]);
     }
-    return unit_ctr;
+    return number_of_results;
 }
 
-TokenMessage MapAndUnits::describe_movement_result(UNIT_AND_ORDER *unit) {
+TokenMessage MapAndUnits::describe_movement_result(UNIT_AND_ORDER *unit, const UNIT_RESULT &unit_result) {
     TokenMessage movement_result {};
     TokenMessage order {};
     TokenMessage result {};
@@ -1840,39 +1649,39 @@ TokenMessage MapAndUnits::describe_movement_result(UNIT_AND_ORDER *unit) {
         case NO_ORDER:
         case HOLD_ORDER:
             order = describe_unit(unit) + TOKEN_ORDER_HLD;
-            if (!unit->dislodged) { result = TOKEN_RESULT_SUC; }
+            if (!(unit_result.flags & RESULT_DISLODGED)) { result = TOKEN_RESULT_SUC; }
             break;
 
         case MOVE_ORDER:
             order = describe_unit(unit) + TOKEN_ORDER_MTO + describe_coast(unit->move_dest);
-            if (unit->bounce) { result = TOKEN_RESULT_BNC; }
-            else if (unit->illegal_order) { result = unit->illegal_reason; }
+            if (unit_result.flags & RESULT_BOUNCE) { result = TOKEN_RESULT_BNC; }
+            else if (unit_result.flags & RESULT_ILLEGAL) { result = unit_result.illegal_reason; }
             else { result = TOKEN_RESULT_SUC; }
             break;
 
         case SUPPORT_TO_HOLD_ORDER:
             order = describe_unit(unit) + TOKEN_ORDER_SUP + describe_unit(&(units[unit->other_source_province]));
-            if (unit->support_cut) { result = TOKEN_RESULT_CUT; }
-            else if (unit->support_void) { result = TOKEN_RESULT_NSO; }
-            else if (unit->illegal_order) { result = unit->illegal_reason; }
+            if (unit_result.flags & RESULT_SUPPORT_CUT) { result = TOKEN_RESULT_CUT; }
+            else if (unit_result.flags & RESULT_SUPPORT_VOID) { result = TOKEN_RESULT_NSO; }
+            else if (unit_result.flags & RESULT_ILLEGAL) { result = unit_result.illegal_reason; }
             else { result = TOKEN_RESULT_SUC; }
             break;
 
         case SUPPORT_TO_MOVE_ORDER:
             order = describe_unit(unit) + TOKEN_ORDER_SUP + describe_unit(&(units[unit->other_source_province]))
                     + TOKEN_ORDER_MTO + game_map[unit->other_dest_province].province_token;
-            if (unit->support_cut) { result = TOKEN_RESULT_CUT; }
-            else if (unit->support_void) { result = TOKEN_RESULT_NSO; }
-            else if (unit->illegal_order) { result = unit->illegal_reason; }
+            if (unit_result.flags & RESULT_SUPPORT_CUT) { result = TOKEN_RESULT_CUT; }
+            else if (unit_result.flags & RESULT_SUPPORT_VOID) { result = TOKEN_RESULT_NSO; }
+            else if (unit_result.flags & RESULT_ILLEGAL) { result = unit_result.illegal_reason; }
             else { result = TOKEN_RESULT_SUC; }
             break;
 
         case CONVOY_ORDER:
             order = describe_unit(unit) + TOKEN_ORDER_CVY + describe_unit(&(units[unit->other_source_province]))
                     + TOKEN_ORDER_CTO + game_map[unit->other_dest_province].province_token;
-            if (unit->no_army_to_convoy) { result = TOKEN_RESULT_NSO; }
-            else if (unit->illegal_order) { result = unit->illegal_reason; }
-            else if (!unit->dislodged) { result = TOKEN_RESULT_SUC; }
+            if (unit_result.flags & RESULT_NO_ARMY_TO_CONVOY) { result = TOKEN_RESULT_NSO; }
+            else if (unit_result.flags & RESULT_ILLEGAL) { result = unit_result.illegal_reason; }
+            else if (!(unit_result.flags & RESULT_DISLODGED)) { result = TOKEN_RESULT_SUC; }
             break;
 
         case MOVE_BY_CONVOY_ORDER:
@@ -1882,10 +1691,10 @@ TokenMessage MapAndUnits::describe_movement_result(UNIT_AND_ORDER *unit) {
             }
             order = order + TOKEN_ORDER_VIA & convoy_via;
 
-            if (unit->no_convoy) { result = TOKEN_RESULT_NSO; }
-            else if (unit->convoy_broken) { result = TOKEN_RESULT_DSR; }
-            else if (unit->bounce) { result = TOKEN_RESULT_BNC; }
-            else if (unit->illegal_order) { result = unit->illegal_reason; }
+            if (unit_result.flags & RESULT_NO_CONVOY) { result = TOKEN_RESULT_NSO; }
+            else if (unit_result.flags & RESULT_CONVOY_BROKEN) { result = TOKEN_RESULT_DSR; }
+            else if (unit_result.flags & RESULT_BOUNCE) { result = TOKEN_RESULT_BNC; }
+            else if (unit_result.flags & RESULT_ILLEGAL) { result = unit_result.illegal_reason; }
             else { result = TOKEN_RESULT_SUC; }
             break;
 
@@ -1893,7 +1702,7 @@ TokenMessage MapAndUnits::describe_movement_result(UNIT_AND_ORDER *unit) {
             break;
     }
 
-    if (unit->dislodged) { result = result + TOKEN_RESULT_RET; }
+    if (unit_result.flags & RESULT_DISLODGED) { result = result + TOKEN_RESULT_RET; }
     movement_result = movement_result & order & result;
     return movement_result;
 }
@@ -2039,10 +1848,10 @@ void MapAndUnits::get_sc_ownerships(TokenMessage *sco_message) {
     // Building a list of SC ownership
     for (int province_ctr = 0; province_ctr < number_of_provinces; province_ctr++) {
         if (game_map[province_ctr].is_supply_centre) {
-            if (game_map[province_ctr].owner == TOKEN_PARAMETER_UNO) {
+            if (province_owner[province_ctr] == TOKEN_PARAMETER_UNO) {
                 unowned_scs = unowned_scs + game_map[province_ctr].province_token;
             } else {
-                sc_owner = game_map[province_ctr].owner.get_subtoken();
+                sc_owner = province_owner[province_ctr].get_subtoken();
                 power_owned_scs[sc_owner] = power_owned_scs[sc_owner] + game_map[province_ctr].province_token;
             }
         }
@@ -2065,7 +1874,7 @@ int MapAndUnits::get_centre_count(const Token &power) {
 
     for (int province_ctr = 0; province_ctr < number_of_provinces; province_ctr++) {
         if (game_map[province_ctr].is_supply_centre) {
-            if (game_map[province_ctr].owner == power) {
+            if (province_owner[province_ctr] == power) {
                 centre_count++;
             }
         }
@@ -2167,3 +1976,135 @@ bool MapAndUnits::unorder_adjustment(const TokenMessage &not_sub_message, int po
 
     return true;                // Order is valid and has been reverted
 }
+
+void MapAndUnits::rehash() {
+    position_hash = compute_position_hash();
+    order_hash = compute_order_hash();
+}
+
+uint64_t MapAndUnits::compute_position_hash() const {
+    uint64_t hash = get_units_hash(units, false) ^ get_units_hash(dislodged_units, true);
+
+    for (PROVINCE_INDEX province_ctr = 0; province_ctr < number_of_provinces; province_ctr++) {
+        hash ^= get_owner_key(province_ctr, province_owner[province_ctr]);
+    }
+    return hash ^ MapTopology::get_season_key(current_season) ^ MapTopology::get_year_key(current_year);
+}
+
+uint64_t MapAndUnits::compute_order_hash() const {
+    uint64_t hash = get_waives_key(our_winter_orders.number_of_waives);
+
+    for (auto &unit : units) { hash ^= get_order_key(unit.second, false); }
+    for (auto &dislodged_unit : dislodged_units) { hash ^= get_order_key(dislodged_unit.second, true); }
+
+    for (auto &builds_or_disband : our_winter_orders.builds_or_disbands) {
+        hash ^= get_winter_order_key(builds_or_disband.first, our_winter_orders.is_building);
+    }
+    return hash;
+}
+
+uint64_t MapAndUnits::get_unit_key(const UNIT_AND_ORDER &unit, bool is_dislodged) const {
+    COAST_INDEX coast_index = topology->get_coast_index(unit.coast_id);
+
+    if ((coast_index == NO_COAST) || (unit.nationality < 0) || (unit.nationality >= number_of_powers)) { return 0; }
+
+    return is_dislodged ? topology->get_dislodged_unit_key(coast_index, unit.nationality)
+                        : topology->get_unit_key(coast_index, unit.nationality);
+}
+
+uint64_t MapAndUnits::get_units_hash(const UNITS &unit_set, bool is_dislodged) const {
+    uint64_t hash {0};
+
+    for (auto &unit : unit_set) { hash ^= get_unit_key(unit.second, is_dislodged); }
+    return hash;
+}
+
+void MapAndUnits::remove_unit_from_hash(const UNITS &unit_set, PROVINCE_INDEX province_index, bool is_dislodged) {
+    auto unit_itr = unit_set.find(province_index);
+    if (unit_itr != unit_set.end()) {
+        position_hash ^= get_unit_key(unit_itr->second, is_dislodged);
+        order_hash ^= get_order_key(unit_itr->second, is_dislodged);
+    }
+}
+
+uint64_t MapAndUnits::get_owner_key(PROVINCE_INDEX province_index, const Token &owner) const {
+    if ((owner.get_category() != CATEGORY_POWER) || (owner.get_subtoken() >= number_of_powers)) { return 0; }
+
+    return topology->get_owner_key(province_index, owner.get_subtoken());
+}
+
+void MapAndUnits::set_province_owner(PROVINCE_INDEX province_index, const Token &owner) {
+    position_hash ^= get_owner_key(province_index, province_owner[province_index])
+                     ^ get_owner_key(province_index, owner);
+    province_owner[province_index] = owner;
+}
+
+void MapAndUnits::set_turn(const Token &season, int year) {
+    position_hash ^= MapTopology::get_season_key(current_season) ^ MapTopology::get_year_key(current_year);
+    current_season = season;
+    current_year = year;
+    position_hash ^= MapTopology::get_season_key(current_season) ^ MapTopology::get_year_key(current_year);
+}
+
+uint64_t MapAndUnits::get_order_key(const UNIT_AND_ORDER &unit, bool is_dislodged) {
+    uint64_t key {0};
+
+    if (unit.order_type == NO_ORDER) { return 0; }
+
+    key = MapTopology::mix_hash(HASH_SEED_ORDER + ((static_cast<uint64_t>(unit.coast_id.province_index) << 16)
+                                                   | (static_cast<uint64_t>(is_dislodged) << 8)
+                                                   | static_cast<uint64_t>(unit.order_type)));
+
+    // Only the fields which the order uses, as the others may be left over from earlier orders
+    switch (unit.order_type) {
+        case MOVE_ORDER:
+        case RETREAT_ORDER:
+            key = MapTopology::mix_hash(key ^ get_coast_value(unit.move_dest));
+            break;
+
+        case SUPPORT_TO_HOLD_ORDER:
+            key = MapTopology::mix_hash(key ^ static_cast<uint64_t>(unit.other_source_province));
+            break;
+
+        case SUPPORT_TO_MOVE_ORDER:
+        case CONVOY_ORDER:
+            key = MapTopology::mix_hash(key ^ ((static_cast<uint64_t>(unit.other_source_province) << 16)
+                                               | static_cast<uint64_t>(unit.other_dest_province)));
+            break;
+
+        case MOVE_BY_CONVOY_ORDER:
+            key = MapTopology::mix_hash(key ^ get_coast_value(unit.move_dest));
+            for (PROVINCE_INDEX step : unit.convoy_step_list) {
+                key = MapTopology::mix_hash(key ^ static_cast<uint64_t>(step));
+            }
+            break;
+
+        default:
+            break;
+    }
+    return key;
+}
+
+uint64_t MapAndUnits::get_winter_order_key(const COAST_ID &location, bool is_building) {
+    return MapTopology::mix_hash(HASH_SEED_WINTER_ORDER + ((get_coast_value(location) << 1) | is_building));
+}
+
+uint64_t MapAndUnits::get_waives_key(int waives) {
+    return (waives == 0) ? 0 : MapTopology::mix_hash(HASH_SEED_WAIVES + static_cast<uint32_t>(waives));
+}
+
+void MapAndUnits::set_is_building(bool is_building) {
+    if (our_winter_orders.is_building == is_building) { return; }
+
+    // The orders already entered change meaning
+    for (auto &builds_or_disband : our_winter_orders.builds_or_disbands) {
+        order_hash ^= get_winter_order_key(builds_or_disband.first, our_winter_orders.is_building)
+                      ^ get_winter_order_key(builds_or_disband.first, is_building);
+    }
+    our_winter_orders.is_building = is_building;
+}
+
+void MapAndUnits::set_number_of_waives(int waives) {
+    order_hash ^= get_waives_key(our_winter_orders.number_of_waives) ^ get_waives_key(waives);
+    our_winter_orders.number_of_waives = waives;
+}
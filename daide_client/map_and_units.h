@@ -15,15 +15,23 @@
 #ifndef _DAIDE_CLIENT_DAIDE_CLIENT_MAP_AND_UNITS_H
 #define _DAIDE_CLIENT_DAIDE_CLIENT_MAP_AND_UNITS_H
 
-#include "daide_client/types.h"
-#include "daide_client/tokens.h"
+#include <climits>
+#include <memory>
+#include <vector>
+
+#include "daide_client/attacker_lists.h"
+#include "daide_client/convoy_reachability.h"
+#include "daide_client/game_position.h"
+#include "daide_client/map_topology.h"
 #include "daide_client/token_message.h"
 
 namespace DAIDE {
 
+class MetricsHistogram;
+
 /**
- * The MapAndUnits Class is a singleton. In order to access the class, the get_instance function should be used.
- * You cannot construct MapAndUnit objects outside the class.
+ * The MapAndUnits Class is usually used as a singleton: the bots access the main instance through the get_instance
+ * function. Further instances can be constructed directly, e.g. one per worker thread.
  *
  * The MapAndUnits Class performs a number of functions.
  *
@@ -41,159 +49,23 @@ namespace DAIDE {
  * This could also be done with the main instance, but this is not recommended, as it would leave the client with no
  * record of the current position.
  *
+ * The map itself is held in a read-only MapTopology which all the copies share, so a duplicate only copies the
+ * position. For lookahead within one instance, use get_position() to take a copy and set_position() to restore it.
+ *
  * For every call to get_duplicate_instance(), you need to call delete_duplicate_instance() in order to avoid memory
  * leaks.
+ *
+ * An instance has no hidden shared state: the topology it shares is read-only, and the map cache and token text map
+ * are locked. So separate instances can be used from separate threads at the same time, although a single instance
+ * must only be used from one thread at a time.
  **/
 
-class MapAndUnits {
+class MapAndUnits : public GamePosition {
 public:
-    // Constants
-    enum { MAX_PROVINCES = 256 };
-    enum { MAX_POWERS = 256 };
-    enum { NO_MAP = -1 };                   // Value used to indicate no map has been set up.
-
-    // Types used by the MapAndUnits class
-
-    // A province index. To convert from Token to PROVINCE_INDEX, use token.get_subtoken().
-    // To convert from PROVINCE_INDEX to token, use game_map[ province_index ].province_token.
-    using PROVINCE_INDEX = int;
-
-    // A power index. To convert from Token to POWER_INDEX, use token.get_subtoken().
-    // To convert from POWER_INDEX to token, Token::Token( CATEGORY_POWER, power_index );
-    using POWER_INDEX = int;
-
-    // A coast. The coast_token should be a TOKEN_COAST_... , or TOKEN_UNIT_FLT
-    // for a province which does not have multiple coasts, or TOKEN_UNIT_AMY for
-    // an army in the province.
-    // Examples: Paris has one coast (TOKEN_UNIT_AMY). Brest has two coasts (TOKEN_UNIT_AMY and
-    // TOKEN_UNIT_FLT). Spain has three coasts (TOKEN_UNIT_AMY, TOKEN_COAST_NCS and
-    // TOKEN_COAST_SCS). North Sea has one coast (TOKEN_UNIT_FLT).
-    using COAST_ID = struct tag_coast_id {
-        PROVINCE_INDEX province_index;
-        Token coast_token;
-
-        bool operator<(const struct tag_coast_id &other_coast_id) const {
-            return ((province_index < other_coast_id.province_index)
-                    || ((province_index == other_coast_id.province_index)
-                         && (coast_token < other_coast_id.coast_token)));
-        }
-    };
-
-    // Orders which a unit can be given
-    using ORDER_TYPE = enum {
-        NO_ORDER,
-        HOLD_ORDER,
-        MOVE_ORDER,
-        SUPPORT_TO_HOLD_ORDER,
-        SUPPORT_TO_MOVE_ORDER,
-        CONVOY_ORDER,
-        MOVE_BY_CONVOY_ORDER,
-
-        RETREAT_ORDER,
-        DISBAND_ORDER,
-
-        // The following can not be ordered, but may be used by the adjudicator
-        HOLD_NO_SUPPORT_ORDER
-    };
-
-    // Used by the adjudicator
-    using RING_UNIT_STATUS = enum {
-        RING_ADVANCES_REGARDLESS,
-        RING_ADVANCES_IF_VACANT,
-        STANDOFF_REGARDLESS,
-        SIDE_ADVANCES_IF_VACANT,
-        SIDE_ADVANCES_REGARDLESS
-    };
-
-    // Collections
-    using UNIT_LIST = std::list<PROVINCE_INDEX>;
-    using UNIT_SET = std::set<PROVINCE_INDEX>;
-    using PROVINCE_SET = std::set<PROVINCE_INDEX>;
-    using PROVINCE_TO_PROVINCE_MAP = std::map<PROVINCE_INDEX, PROVINCE_INDEX>;
-    using COAST_SET = std::set<COAST_ID>;
-
-    using UNIT_AND_ORDER = struct {
-        // Location of the unit
-        COAST_ID coast_id;                          // Coast of the unit's location
-        POWER_INDEX nationality;                    // Nationality of the unit
-        Token unit_type;                            // The type of unit
-
-        // Order for the unit
-        ORDER_TYPE order_type;                      // Type of order given to unit
-        COAST_ID move_dest;                         // Destination to move to (normal or via convoy)
-        PROVINCE_INDEX other_source_province;       // Province support or convoy is from (if moving)
-                                                    // (i.e. province containing supported unit)
-        PROVINCE_INDEX other_dest_province;         // Province support or convoy is to (or is holding in)
-        UNIT_LIST convoy_step_list;                 // List of fleets that the convoy uses
-
-        // The following are used during the adjudication
-        ORDER_TYPE order_type_copy;                 // Copy of order type - may be reverted to HOLD or HOLD_NO_SUPPORT
-        UNIT_SET supports;                          // The supporting units
-        int no_of_supports_to_dislodge;             // The number of supports which count towards dislodgement
-        bool is_support_to_dislodge;                // Whether the support this unit is giving is a support to dislodge
-        int move_number;                            // Nb of the move - used for detecting rings and head-to-heads
-        RING_UNIT_STATUS ring_unit_status;          // Status of this unit as part of a ring of attack
-        PROVINCE_INDEX dislodged_from;              // Province the unit was dislodged from
-
-        // Results flags
-        bool no_convoy;                             // Convoy order was not provided by necessary fleets
-        bool no_army_to_convoy;                     // Army not ordered to use the convoy or fleets broke the route
-        bool convoy_broken;                         // A convoying fleet was dislodged so the convoy failed
-        bool support_void;                          // The support order did not match the order of the supp. unit
-        bool support_cut;                           // The support order was cut by an attack
-        bool bounce;                                // The move bounced
-        bool dislodged;                             // The unit was dislodged
-        bool unit_moves;                            // The unit moves successfully
-        bool illegal_order;                         // Order illegal - only possible in AOA game
-        Token illegal_reason;                       // Reason that order was illegal
-
-        // Retreat options
-        COAST_SET retreat_options;                  // Locations where the unit can retreat to
-    };
-
-    // The coasts adjacent to a given coast
-    using COAST_DETAILS = struct {
-        COAST_SET adjacent_coasts;
-    };
-
-    // The set of coasts in a province, keyed on the Coast Token
-    // (may be TOKEN_COAST_..., TOKEN_UNIT_FLT or TOKEN_UNIT_AMY) - see COAST_ID above
-    using PROVINCE_COASTS = std::map<Token, COAST_DETAILS>;
-
-    // The set of powers for which a given province is a home centre
-    using HOME_CENTRE_SET = std::set<POWER_INDEX>;
-
-    // The details of a province
-    using PROVINCE_DETAILS = struct {
-        Token province_token;
-        bool province_in_use;
-        bool is_supply_centre;
-        bool is_land;
-        PROVINCE_COASTS coast_info;
-        HOME_CENTRE_SET home_centre_set;
-        Token owner;
-    };
-
-    // The collection of all units, keyed on the province in which the unit is located
-    using UNITS = std::map<PROVINCE_INDEX, UNIT_AND_ORDER>;
-
-    // Map of build or disband orders against result token (SUC or failure reason)
-    using BUILDS_OR_DISBANDS = std::map<COAST_ID, Token>;
-
-    // The winter orders for one power
-    using WINTER_ORDERS_FOR_POWER = struct {
-        BUILDS_OR_DISBANDS builds_or_disbands;
-        int number_of_waives;
-        int number_of_orders_required;
-        bool is_building;
-    };
-
-    using WINTER_ORDERS = std::map<POWER_INDEX, WINTER_ORDERS_FOR_POWER> ;
-
     // Public Data.
 
-    // The map
-    PROVINCE_DETAILS game_map[MAX_PROVINCES];
+    // The map. Points into the shared topology, so it is only valid while the topology is held.
+    const PROVINCE_DETAILS *game_map;
 
     int number_of_provinces;                    // Number of provinces on the map
     int number_of_powers;                       // The number of powers in the variant
@@ -206,11 +78,6 @@ public:
     // Current status
     bool game_started;                          // Whether the game has started
     bool game_over;                             // Whether the game is over
-    Token current_season;                       // The current season of play
-    int current_year;                           // The current year of play
-    UNITS units;                                // The non-dislodged units
-    UNITS dislodged_units;                      // The dislodged units
-    WINTER_ORDERS winter_orders;                // The winter orders
     WINTER_ORDERS_FOR_POWER our_winter_orders;  // The winter orders for this power
     UNITS last_movement_results;                // The results from the last movement turn
     UNITS last_retreat_results;                 // The results from the last retreat turn
@@ -232,7 +99,12 @@ public:
 
     // Public Functions
 
-    // Get the instance of the MapAndUnits class
+    // An instance with no map, or using an already built topology
+    MapAndUnits();
+
+    explicit MapAndUnits(const std::shared_ptr<const MapTopology> &topology);
+
+    // Get the main instance of the MapAndUnits class
     static MapAndUnits *get_instance();
 
     // Get a duplicate copy of the MapAndUnits class. Recommended for messing around with
@@ -245,6 +117,45 @@ public:
     // Set up the class
     int set_map(const TokenMessage &mdf_message);
 
+    // Use an already built topology, e.g. one shared with another instance
+    void set_topology(const std::shared_ptr<const MapTopology> &new_topology);
+
+    const std::shared_ptr<const MapTopology> &get_topology() const { return topology; }
+
+    // Get or replace the current position (units, ownership, season and winter orders). The map is not copied.
+    const GamePosition &get_position() const { return *this; }
+
+    void set_position(const GamePosition &position) {
+        GamePosition::operator=(position);
+        unit_results_replaced = true;
+    }
+
+    // Zobrist hashes of the position and of the orders, which are equal whenever the positions (or orders) are equal.
+    // They are kept up to date by the functions here. Code which changes the units, orders or ownership directly must
+    // call rehash() afterwards.
+    uint64_t get_position_hash() const { return position_hash; }
+
+    uint64_t get_order_hash() const { return order_hash; }
+
+    void rehash();
+
+    // Calculate the hashes from scratch
+    uint64_t compute_position_hash() const;
+
+    uint64_t compute_order_hash() const;
+
+    // Make and unmake. While undo logging is on, apply_adjudication() records each change it makes to the position
+    // (units, centre owners, turn and winter orders), and undo_to() takes back everything recorded since a mark, in
+    // time proportional to the number of changes. The log is reused, so a depth first search does not allocate per
+    // node. Orders and results written before apply_adjudication() are restored with the units.
+    using UNDO_MARK = int;
+
+    void set_undo_logging(bool log_changes) { undo_logging = log_changes; }
+
+    UNDO_MARK get_undo_mark() const { return undo_log_size; }
+
+    void undo_to(UNDO_MARK mark);
+
     void set_power_played(const Token &power);
 
     int set_ownership(const TokenMessage &sco_message);
@@ -267,7 +178,7 @@ public:
     bool set_move_by_convoy_order(PROVINCE_INDEX unit,
                                   PROVINCE_INDEX destination,
                                   int number_of_steps,
-                                  PROVINCE_INDEX step_list[]);
+                                  const PROVINCE_INDEX step_list[]);
 
     bool set_move_by_single_step_convoy_order(PROVINCE_INDEX unit, PROVINCE_INDEX destination, PROVINCE_INDEX step) {
         return set_move_by_convoy_order(unit, destination, 1, &step);
@@ -281,13 +192,11 @@ public:
 
     bool set_remove_order(PROVINCE_INDEX unit);
 
-    void set_waive_order() { our_winter_orders.number_of_waives++; }
+    void set_waive_order() { set_number_of_waives(our_winter_orders.number_of_waives + 1); }
 
-    void set_multiple_waive_orders(int waives) {
-        our_winter_orders.number_of_waives = our_winter_orders.number_of_waives + waives;
-    }
+    void set_multiple_waive_orders(int waives) { set_number_of_waives(our_winter_orders.number_of_waives + waives); }
 
-    void set_total_number_of_waive_orders(int waives) { our_winter_orders.number_of_waives = waives; }
+    void set_total_number_of_waive_orders(int waives) { set_number_of_waives(waives); }
 
     // Accept a complete set of orders for a power as a single TokenMessage
     int process_orders(const TokenMessage &sub_message, POWER_INDEX power_index, Token *order_result);
@@ -336,25 +245,62 @@ public:
                              Token *parameter = nullptr);    // OUTPUT: Parameter for variant (if one was provided)
 
     // Get the adjacency list for a coast
-    COAST_SET *get_adjacent_coasts(COAST_ID &coast);
+    const COAST_SET *get_adjacent_coasts(const COAST_ID &coast) const;
 
     // Get the adjacency list for a unit. Returns nullptr if no unit in the given province.
-    COAST_SET *get_adjacent_coasts(PROVINCE_INDEX &unit_location);
+    const COAST_SET *get_adjacent_coasts(PROVINCE_INDEX &unit_location);
 
     // Get the adjacency list for a dislodged unit. Returns nullptr if no dislodged unit in the given province.
-    COAST_SET *get_dislodged_unit_adjacent_coasts(PROVINCE_INDEX &dislodged_unit_location);
+    const COAST_SET *get_dislodged_unit_adjacent_coasts(PROVINCE_INDEX &dislodged_unit_location);
+
+    // Whether a unit can move to a coast, or to any coast of a province
+    bool can_move_to(const UNIT_AND_ORDER *unit, const COAST_ID &destination) const;
+
+    bool can_move_to_province(const UNIT_AND_ORDER *unit, int province_index) const;
+
+    // Whether a unit can reach a province directly or, for an army, by convoy through the fleets now at sea. Routes
+    // through province_to_avoid (-1 for none) are not used. Convoys are looked up in the convoy reachability, which
+    // follows the fleets as they move.
+    bool has_route_to_province(const UNIT_AND_ORDER *unit,
+                               PROVINCE_INDEX province_index,
+                               PROVINCE_INDEX province_to_avoid) const;
 
     // Functions for the adjudicator
 
     // Set the order checking options
     void set_order_checking(bool check_on_submit, bool check_on_adjudicate);
 
+    // The algorithms which can adjudicate a movement turn. They give the same results.
+    using MOVE_ADJUDICATOR = enum {
+        PHASED_MOVE_ADJUDICATOR,                // The DPTG algorithm, resolving the orders in phases
+        DEPENDENCY_MOVE_ADJUDICATOR,            // Resolves each order from the orders it depends on
+        INCREMENTAL_MOVE_ADJUDICATOR            // As the dependency one, but when only some of the orders have
+                                                // changed since the last adjudication of the position, only the
+                                                // orders which interact with them are resolved again
+    };
+
+    // Choose the algorithm adjudicate() uses for movement turns. The phased one is used unless another is chosen.
+    void set_move_adjudicator(MOVE_ADJUDICATOR adjudicator) { move_adjudicator = adjudicator; }
+
+    MOVE_ADJUDICATOR get_move_adjudicator() const { return move_adjudicator; }
+
     // Perform the adjudication
     void adjudicate();
 
+    // Where adjudicate() records how long it takes: the shared daide_adjudication_seconds histogram, unless another
+    // is given (e.g. one per worker thread, added to the shared one now and again). nullptr for the shared one.
+    void set_adjudication_histogram(MetricsHistogram *histogram) { adjudication_histogram = histogram; }
+
     // Get the results as a set of ORD messages
     int get_adjudication_results(TokenMessage ord_messages[]);
 
+    // Get the results of a movement turn as one UNIT_RESULT per unit, in the order of the units, without building
+    // any TokenMessages. Returns the number of units.
+    int get_move_results(UNIT_RESULT results[]) const;
+
+    // The RESULT_... flags for the results flags of a unit
+    static uint16_t get_result_flags(const UNIT_AND_ORDER &unit);
+
     // Apply the adjudication. This moves all the units to their new positions.
     bool apply_adjudication();
 
@@ -376,24 +322,8 @@ public:
     TokenMessage describe_dislodged_unit(UNIT_AND_ORDER *unit);
 
 private:
-    // Private constructor - use the get_instance() function
-    MapAndUnits();
-
-    int process_power_list(const TokenMessage &power_list);
-
-    int process_provinces(const TokenMessage &provinces);
-
-    int process_supply_centres(const TokenMessage &supply_centres);
-
-    int process_supply_centres_for_power(const TokenMessage &supply_centres);
-
-    int process_non_supply_centres(const TokenMessage &non_supply_centres);
-
-    int process_adjacencies(const TokenMessage &adjacencies);
-
-    int process_province_adjacency(const TokenMessage &province_adjacency);
-
-    static int process_adjacency_list(PROVINCE_DETAILS *province_details, const TokenMessage &adjacency_list);
+    // Adjudicates on a working copy, calling the move adjudication directly
+    friend class BatchAdjudicator;
 
     int process_sco_for_power(const TokenMessage &sco_for_power);
 
@@ -425,15 +355,15 @@ private:
 
     UNIT_AND_ORDER *find_unit(const TokenMessage &unit_to_find, UNITS &units_map);
 
-    bool can_move_to(UNIT_AND_ORDER *unit, const COAST_ID &destination);
-
-    bool can_move_to_province(UNIT_AND_ORDER *unit, int province_index);
-
-    bool has_route_to_province(UNIT_AND_ORDER *unit, PROVINCE_INDEX province_index, PROVINCE_INDEX province_to_avoid);
+    // Search for a convoy route which does not go through the province to avoid
+    bool find_convoy_route(const UNIT_AND_ORDER *unit,
+                           PROVINCE_INDEX province_index,
+                           PROVINCE_INDEX province_to_avoid) const;
 
     int get_movement_results(TokenMessage ord_messages[]);
 
-    TokenMessage describe_movement_result(UNIT_AND_ORDER *unit);
+    // The ORD message for a unit's result
+    TokenMessage describe_movement_result(UNIT_AND_ORDER *unit, const UNIT_RESULT &unit_result);
 
     int get_retreat_results(TokenMessage ord_messages[]);
 
@@ -447,6 +377,17 @@ private:
 
     TokenMessage describe_waive(POWER_INDEX power_ctr);
 
+    void get_move_result(PROVINCE_INDEX unit_province,
+                         const UNIT_AND_ORDER &unit,
+                         const PROVINCE_SET &occupied_provinces,
+                         UNIT_RESULT *result) const;
+
+    // The provinces which hold a unit once the units which move have moved
+    PROVINCE_SET get_provinces_occupied_after_moves() const;
+
+    // The adjacent coasts a dislodged unit can retreat to, as for UNIT_RESULT
+    uint32_t get_retreat_options(const UNIT_AND_ORDER &unit, const PROVINCE_SET &occupied_provinces) const;
+
     // Functions used to adjudicate
     void adjudicate_moves();
 
@@ -456,6 +397,8 @@ private:
 
     void initialise_move_adjudication();
 
+    void initialise_unit_adjudication(PROVINCE_INDEX unit_province, UNIT_AND_ORDER *unit);
+
     void check_for_illegal_move_orders();
 
     void cancel_inconsistent_convoys();
@@ -498,12 +441,66 @@ private:
 
     void resolve_attacks_on_province(PROVINCE_INDEX province);
 
+    bool is_on_convoy_route(UNIT_AND_ORDER *convoying_fleet);
+
+    void convoyed_attack_cuts_support(UNIT_AND_ORDER *convoyed_army);
+
     void cut_support(PROVINCE_INDEX attacked_province);
 
     PROVINCE_INDEX find_dislodging_unit(PROVINCE_INDEX attacked_province, bool ignore_occupying_unit = false);
 
     PROVINCE_INDEX find_successful_attack_on_empty_province(PROVINCE_INDEX attacked_province);
 
+    // Functions used by the dependency adjudicator
+    void adjudicate_moves_by_dependency();
+
+    void resolve_orders_by_dependency(const UNIT_SET &units_to_resolve);
+
+    bool resolve_order(PROVINCE_INDEX unit_province);
+
+    bool adjudicate_order(PROVINCE_INDEX unit_province);
+
+    bool adjudicate_move_order(UNIT_AND_ORDER *unit);
+
+    bool adjudicate_support_order(UNIT_AND_ORDER *unit);
+
+    bool adjudicate_convoy_order(UNIT_AND_ORDER *unit);
+
+    void apply_backup_rule(int first_dependency);
+
+    bool convoy_route_holds(UNIT_AND_ORDER *army);
+
+    bool is_moving(UNIT_AND_ORDER *unit);
+
+    UNIT_AND_ORDER *find_head_to_head_opponent(UNIT_AND_ORDER *unit);
+
+    int count_supports_given(UNIT_AND_ORDER *unit, bool supports_to_dislodge_only);
+
+    int get_hold_strength(PROVINCE_INDEX province);
+
+    int get_attack_strength(UNIT_AND_ORDER *unit);
+
+    int get_defend_strength(UNIT_AND_ORDER *unit);
+
+    int get_prevent_strength(UNIT_AND_ORDER *unit);
+
+    void set_dependency_results(const UNIT_SET &units_resolved);
+
+    // Functions used by the incremental adjudicator
+    void adjudicate_moves_incrementally();
+
+    int get_named_provinces(const UNIT_AND_ORDER &unit, PROVINCE_INDEX named_provinces[]) const;
+
+    void note_order_change(PROVINCE_INDEX unit_province, const UNIT_AND_ORDER &unit, uint64_t order_key);
+
+    bool order_changed(PROVINCE_INDEX unit_province, const UNIT_AND_ORDER &unit, uint64_t order_key) const;
+
+    void record_adjudicated_order(PROVINCE_INDEX unit_province, const UNIT_AND_ORDER &unit, uint64_t order_key);
+
+    void record_adjudicated_results(PROVINCE_INDEX unit_province, const UNIT_AND_ORDER &unit);
+
+    void restore_adjudicated_results(PROVINCE_INDEX unit_province, UNIT_AND_ORDER *unit) const;
+
     void check_for_illegal_retreat_orders();
 
     void generate_cd_disbands(POWER_INDEX power_index, WINTER_ORDERS_FOR_POWER *orders);
@@ -520,6 +517,65 @@ private:
 
     bool update_sc_ownership();
 
+    // Keys for the Zobrist hashes. A unit, owner or order which cannot be hashed has a key of zero.
+    uint64_t get_unit_key(const UNIT_AND_ORDER &unit, bool is_dislodged) const;
+
+    uint64_t get_units_hash(const UNITS &unit_set, bool is_dislodged) const;
+
+    uint64_t get_owner_key(PROVINCE_INDEX province_index, const Token &owner) const;
+
+    static uint64_t get_order_key(const UNIT_AND_ORDER &unit, bool is_dislodged);
+
+    static uint64_t get_winter_order_key(const COAST_ID &location, bool is_building);
+
+    static uint64_t get_waives_key(int waives);
+
+    // Give the unit a support to hold. Every way of entering an order goes through here, so that both fields name the
+    // supported unit: orders are sent from other_dest_province, but adjudicated and hashed from other_source_province.
+    static void order_support_to_hold(UNIT_AND_ORDER &unit, PROVINCE_INDEX supported_unit);
+
+    // Take the unit (if any) in the province out of the hashes, before it is replaced
+    void remove_unit_from_hash(const UNITS &unit_set, PROVINCE_INDEX province_index, bool is_dislodged);
+
+    // Change the position or orders, updating the hashes
+    void set_province_owner(PROVINCE_INDEX province_index, const Token &owner);
+
+    void set_turn(const Token &season, int year);
+
+    void set_is_building(bool is_building);
+
+    void set_number_of_waives(int waives);
+
+    // Entries in the undo log. Each holds what it replaced, e.g. the unit (if any) which was in a province.
+    using UNDO_TYPE = enum {
+        UNDO_UNIT,
+        UNDO_DISLODGED_UNIT,
+        UNDO_OWNER,
+        UNDO_TURN,
+        UNDO_WINTER_ORDERS
+    };
+
+    using UNDO_ENTRY = struct {
+        UNDO_TYPE type;
+        int index;                                  // Province, or power for winter orders
+        bool was_present;                           // Whether there was a unit, or winter orders
+        UNIT_AND_ORDER unit;
+        Token token;                                // Owner, or season
+        int year;
+        WINTER_ORDERS_FOR_POWER winter_orders;
+    };
+
+    // Record the current value before it is changed, if undo logging is on
+    UNDO_ENTRY &add_undo_entry(UNDO_TYPE type, int index);
+
+    void log_unit(UNDO_TYPE type, PROVINCE_INDEX province_index);
+
+    void log_province_owner(PROVINCE_INDEX province_index);
+
+    void log_turn();
+
+    void log_winter_orders(POWER_INDEX power_index);
+
     // Constants used by the adjudicator
     enum { DOES_NOT_SUBVERT = -1 };
     enum { NO_DISLODGING_UNIT = -1 };
@@ -539,11 +595,71 @@ private:
         int number_of_subversions;                  // Number of convoys which subvert this convoy
         SUBVERSION_TYPE subversion_type;            // How this convoy is subverted
     };
-    using CONVOY_SUBVERSION_MAP = std::map<PROVINCE_INDEX, CONVOY_SUBVERSION>;
-    using ATTACKER_MAP = std::multimap<PROVINCE_INDEX, PROVINCE_INDEX> ;
+    using CONVOY_SUBVERSION_MAP = ProvinceMap<CONVOY_SUBVERSION>;
+
+    // How far the dependency adjudicator has got with an order
+    using RESOLUTION_STATE = enum {
+        UNRESOLVED,
+        GUESSING,
+        RESOLVED
+    };
+
+    // The working state of a unit during move adjudication. Held apart from the units, indexed by province, so it
+    // is reused from one adjudication to the next.
+    using UNIT_ADJUDICATION = struct {
+        ORDER_TYPE order_type_copy;                 // Copy of order type - may be reverted to HOLD or HOLD_NO_SUPPORT
+        UNIT_SET supports;                          // The supporting units
+        int no_of_supports_to_dislodge;             // The number of supports which count towards dislodgement
+        bool is_support_to_dislodge;                // Whether the support this unit is giving is a support to dislodge
+        int move_number;                            // Nb of the move - used for detecting rings and head-to-heads
+        RING_UNIT_STATUS ring_unit_status;          // Status of this unit as part of a ring of attack
+        RESOLUTION_STATE resolution_state;          // For the dependency adjudicator
+        bool order_succeeds;                        // The move is made, support given or convoy kept up (or guess)
+        int guess_depth;                            // While guessing, the depth of the guess the result depends on
+    };
+
+    UNIT_ADJUDICATION &adjudication_of(const UNIT_AND_ORDER *unit) {
+        return unit_adjudication[unit->coast_id.province_index];
+    }
+
+    // Signed, as it is compared with counts which start at -1
+    int number_of_supports(const UNIT_AND_ORDER *unit) {
+        return static_cast<int>(adjudication_of(unit).supports.size());
+    }
+
+    // A unit as last adjudicated by the incremental adjudicator: its order, and the results of it
+    using ADJUDICATED_UNIT = struct {
+        ORDER_TYPE order_type;
+        COAST_ID move_dest;
+        PROVINCE_INDEX other_source_province;
+        PROVINCE_INDEX other_dest_province;
+        uint64_t order_key;                         // Also covers the convoy route
+        PROVINCE_SET order_provinces;               // The province the unit is in, and those its order names
+        bool no_convoy;
+        bool no_army_to_convoy;
+        bool convoy_broken;
+        bool support_void;
+        bool support_cut;
+        bool bounce;
+        bool dislodged;
+        bool unit_moves;
+        PROVINCE_INDEX dislodged_from;
+    };
+
+    // The unit retreating to each province
+    using RETREAT_MAP = ProvinceMap<PROVINCE_INDEX>;
+
+    // The map, shared with any duplicates
+    std::shared_ptr<const MapTopology> topology;
+
+    // Where armies can be convoyed to. Brought up to date with the fleets when it is used.
+    mutable ConvoyReachability convoy_reachability;
+
+    MetricsHistogram *adjudication_histogram {nullptr};
 
     // Data used to adjudicate
-    ATTACKER_MAP attacker_map;
+    UNIT_ADJUDICATION unit_adjudication[MAX_PROVINCES];
+    AttackerLists attacker_lists;
     UNIT_SET supporting_units;
     UNIT_SET convoying_units;
     UNIT_SET convoyed_units;
@@ -552,6 +668,34 @@ private:
     UNIT_SET balanced_head_to_heads;
     UNIT_SET unbalanced_head_to_heads;
     PROVINCE_SET bounce_locations;    // The locations in which bounces have occurred
+
+    // The orders whose results depend on a guess further out, for the dependency adjudicator. Guesses are numbered by
+    // how deeply the resolution was nested when they were made.
+    enum { NO_GUESS_USED = INT_MAX };
+    PROVINCE_INDEX dependencies[MAX_PROVINCES];
+    int number_of_dependencies {0};
+    int resolution_depth {0};
+    int shallowest_guess_used {NO_GUESS_USED};
+    MOVE_ADJUDICATOR move_adjudicator {PHASED_MOVE_ADJUDICATOR};
+
+    // The last adjudication, for the incremental adjudicator: the position and orders, each unit, and for each
+    // province, the units in it or whose orders name it. Only valid while the position is unchanged.
+    bool adjudicated_units_valid {false};
+    uint64_t adjudicated_position_hash {0};
+    uint64_t adjudicated_order_hash {0};
+    ADJUDICATED_UNIT adjudicated_units[MAX_PROVINCES];
+    UNIT_SET units_naming[MAX_PROVINCES];
+
+    // The units whose orders the functions here have changed from the adjudicated ones since, with the key of each
+    // new order, and whether set_position() has been called since, which may have overwritten the units' results
+    UNIT_SET changed_orders;
+    uint64_t changed_order_keys[MAX_PROVINCES];
+    bool unit_results_replaced {false};
+
+    // The undo log. Entries beyond undo_log_size are kept for reuse.
+    bool undo_logging {false};
+    int undo_log_size {0};
+    std::vector<UNDO_ENTRY> undo_log;
 };
 
 } // namespace DAIDE
@@ -0,0 +1,445 @@
+/**
+ * Diplomacy AI Client - Part of the DAIDE project.
+ *
+ * Map Cache. Keeps compiled maps in memory and in cache files, and saves and loads a MapTopology.
+ *
+ * Release 8~3
+ **/
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "daide_client/map_cache.h"
+
+using DAIDE::MapCache;
+using DAIDE::MapTopology;
+using DAIDE::Token;
+using DAIDE::TokenMessage;
+
+namespace {
+
+const char FILE_MAGIC[4] = {'D', 'M', 'A', 'P'};
+const uint32_t FILE_VERSION = 1;
+const uint32_t BYTE_ORDER_CHECK = 0x01020304;
+
+// Each array starts on this boundary, so it is aligned for its type in the file as well as in memory. The arrays are
+// copied out of the mapped file when it is read, so the mapping can be closed at once.
+const size_t ALIGNMENT = 8;
+
+// Whether every value is at least zero and below the limit, so it can be used as an index into an array of that size
+bool all_below(const std::vector<int> &values, int limit) {
+    return std::all_of(values.begin(), values.end(), [limit](int value) { return (value >= 0) && (value < limit); });
+}
+
+// Whether the row starts begin at zero and never go down, so each row lies inside the array they index. That the last
+// start is the array's size is checked with the sizes.
+bool rows_in_order(const std::vector<int> &start) {
+    return !start.empty() && (start.front() == 0) && std::is_sorted(start.begin(), start.end());
+}
+
+// Appends values in the machine's own byte order. The files are only a cache, so they are not moved between machines,
+// and the byte order is checked when they are read.
+class ByteWriter {
+public:
+    explicit ByteWriter(std::vector<uint8_t> *buffer) : m_buffer(buffer) {}
+
+    template <typename T>
+    void put(T value) {
+        const uint8_t *bytes = reinterpret_cast<const uint8_t *>(&value);
+        m_buffer->insert(m_buffer->end(), bytes, bytes + sizeof(T));
+    }
+
+    template <typename T>
+    void put_array(const std::vector<T> &values) {
+        put<uint32_t>(static_cast<uint32_t>(values.size()));
+        align();
+
+        const uint8_t *bytes = reinterpret_cast<const uint8_t *>(values.data());
+        m_buffer->insert(m_buffer->end(), bytes, bytes + values.size() * sizeof(T));
+    }
+
+    void align() {
+        while (m_buffer->size() % ALIGNMENT != 0) { m_buffer->push_back(0); }
+    }
+
+private:
+    std::vector<uint8_t> *m_buffer;
+};
+
+// Reads what ByteWriter wrote. Reading past the end sets the overrun flag and returns zeros.
+class ByteReader {
+public:
+    ByteReader(const uint8_t *data, size_t length) : m_data(data), m_length(length), m_position(0), m_overrun(false) {}
+
+    template <typename T>
+    T get() {
+        T value {};
+
+        if (m_length - m_position < sizeof(T)) {
+            m_overrun = true;
+        } else {
+            memcpy(&value, m_data + m_position, sizeof(T));
+            m_position += sizeof(T);
+        }
+        return value;
+    }
+
+    // Whether the next bytes are the given ones, compared where they are. They are stepped over
+    // whether they match or not.
+    bool get_matching(const void *bytes, size_t size) {
+        if (m_length - m_position < size) {
+            m_overrun = true;
+            return false;
+        }
+
+        bool matches = (memcmp(m_data + m_position, bytes, size) == 0);
+        m_position += size;
+        return matches;
+    }
+
+    template <typename T>
+    void get_array(std::vector<T> *values) {
+        size_t size = get<uint32_t>();
+        align();
+
+        if (m_overrun || ((m_length - m_position) / sizeof(T) < size)) {
+            m_overrun = true;
+            values->clear();
+        } else {
+            values->resize(size);
+            memcpy(values->data(), m_data + m_position, size * sizeof(T));
+            m_position += size * sizeof(T);
+        }
+    }
+
+    void align() {
+        m_position = std::min(m_length, (m_position + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT);
+    }
+
+    bool overrun() const { return m_overrun; }
+
+    size_t get_position() const { return m_position; }
+
+private:
+    const uint8_t *m_data;
+    size_t m_length;
+    size_t m_position;
+    bool m_overrun;
+};
+
+// A topology held in memory, with the MDF it was built from
+using CACHED_TOPOLOGY = struct {
+    TokenMessage mdf_message;
+    std::shared_ptr<const MapTopology> topology;
+};
+
+std::mutex cache_mutex;
+std::multimap<uint64_t, CACHED_TOPOLOGY> cached_topologies;
+std::string cache_directory {"."};
+
+// Write the MDF tokens, as the file header
+void put_mdf(ByteWriter *writer, const TokenMessage &mdf_message) {
+    writer->put<uint32_t>(static_cast<uint32_t>(mdf_message.get_message_length()));
+    for (int token_ctr = 0; token_ctr < mdf_message.get_message_length(); token_ctr++) {
+        writer->put<uint16_t>(mdf_message.get_token(token_ctr).get_token());
+    }
+    writer->align();
+}
+
+bool mdf_matches(ByteReader *reader, const TokenMessage &mdf_message) {
+    bool matches = (reader->get<uint32_t>() == static_cast<uint32_t>(mdf_message.get_message_length()));
+
+    for (int token_ctr = 0; matches && (token_ctr < mdf_message.get_message_length()); token_ctr++) {
+        matches = (reader->get<uint16_t>() == mdf_message.get_token(token_ctr).get_token());
+    }
+    reader->align();
+    return matches && !reader->overrun();
+}
+
+} // namespace
+
+void MapTopology::serialize(std::vector<uint8_t> *buffer) const {
+    ByteWriter writer(buffer);
+
+    writer.align();
+    writer.put<int32_t>(MAX_PROVINCES);
+    writer.put<int32_t>(number_of_provinces);
+    writer.put<int32_t>(number_of_powers);
+    writer.put<int32_t>(number_of_coasts);
+    writer.put<int32_t>(distance_row_length);
+
+    // The provinces, as parsed from the MDF
+    for (PROVINCE_INDEX province_ctr = 0; province_ctr < MAX_PROVINCES; province_ctr++) {
+        const PROVINCE_DETAILS &province = game_map[province_ctr];
+
+        writer.put<uint16_t>(province.province_token.get_token());
+        writer.put<uint8_t>(province.province_in_use);
+        writer.put<uint8_t>(province.is_supply_centre);
+        writer.put<uint8_t>(province.is_land);
+        writer.put<uint16_t>(province.initial_owner.get_token());
+
+        writer.put<uint32_t>(static_cast<uint32_t>(province.home_centre_set.size()));
+        for (POWER_INDEX power : province.home_centre_set) {
+            writer.put<int32_t>(power);
+        }
+
+        writer.put<uint32_t>(static_cast<uint32_t>(province.coast_info.size()));
+        for (const auto &coast_itr : province.coast_info) {
+            writer.put<uint16_t>(coast_itr.first.get_token());
+            writer.put<uint32_t>(static_cast<uint32_t>(coast_itr.second.adjacent_coasts.size()));
+            for (const COAST_ID &adjacent_coast : coast_itr.second.adjacent_coasts) {
+                writer.put<int32_t>(adjacent_coast.province_index);
+                writer.put<uint16_t>(adjacent_coast.coast_token.get_token());
+            }
+        }
+    }
+
+    // The compiled arrays. The coasts themselves are rebuilt from the provinces.
+    writer.put_array(province_first_coast);
+    writer.put_array(coast_adjacency_start);
+    writer.put_array(coast_adjacencies);
+    writer.put_array(province_adjacency_start);
+    writer.put_array(province_adjacencies);
+    writer.put_array(army_adjacency_start);
+    writer.put_array(army_adjacencies);
+    writer.put_array(fleet_adjacency_start);
+    writer.put_array(fleet_adjacencies);
+    writer.put_array(army_distances);
+    writer.put_array(coast_distances);
+    writer.put_array(distances);
+    writer.put_array(home_distances);
+    writer.put_array(nearest_home_centres);
+    writer.put_array(unit_keys);
+    writer.put_array(dislodged_unit_keys);
+    writer.put_array(owner_keys);
+}
+
+bool MapTopology::deserialize(const uint8_t *data, size_t length) {
+    ByteReader reader(data, length);
+
+    if (reader.get<int32_t>() != MAX_PROVINCES) { return false; }
+    number_of_provinces = reader.get<int32_t>();
+    number_of_powers = reader.get<int32_t>();
+    number_of_coasts = reader.get<int32_t>();
+    distance_row_length = reader.get<int32_t>();
+
+    coasts.clear();
+    for (PROVINCE_INDEX province_ctr = 0; province_ctr < MAX_PROVINCES; province_ctr++) {
+        PROVINCE_DETAILS &province = game_map[province_ctr];
+
+        province.province_token = Token(reader.get<uint16_t>());
+        province.province_in_use = (reader.get<uint8_t>() != 0);
+        province.is_supply_centre = (reader.get<uint8_t>() != 0);
+        province.is_land = (reader.get<uint8_t>() != 0);
+        province.initial_owner = Token(reader.get<uint16_t>());
+
+        province.home_centre_set.clear();
+        for (uint32_t home_ctr = reader.get<uint32_t>(); (home_ctr > 0) && !reader.overrun(); home_ctr--) {
+            province.home_centre_set.insert(reader.get<int32_t>());
+        }
+
+        province.coast_info.clear();
+        for (uint32_t coast_ctr = reader.get<uint32_t>(); (coast_ctr > 0) && !reader.overrun(); coast_ctr--) {
+            Token coast_token(reader.get<uint16_t>());
+            COAST_SET &adjacent_coasts = province.coast_info[coast_token].adjacent_coasts;
+
+            coasts.push_back(COAST_ID {province_ctr, coast_token});
+            for (uint32_t adjacent_ctr = reader.get<uint32_t>(); (adjacent_ctr > 0) && !reader.overrun(); adjacent_ctr--) {
+                COAST_ID adjacent_coast {};
+                adjacent_coast.province_index = reader.get<int32_t>();
+                adjacent_coast.coast_token = Token(reader.get<uint16_t>());
+                adjacent_coasts.insert(adjacent_coast);
+            }
+        }
+    }
+
+    reader.get_array(&province_first_coast);
+    reader.get_array(&coast_adjacency_start);
+    reader.get_array(&coast_adjacencies);
+    reader.get_array(&province_adjacency_start);
+    reader.get_array(&province_adjacencies);
+    reader.get_array(&army_adjacency_start);
+    reader.get_array(&army_adjacencies);
+    reader.get_array(&fleet_adjacency_start);
+    reader.get_array(&fleet_adjacencies);
+    reader.get_array(&army_distances);
+    reader.get_array(&coast_distances);
+    reader.get_array(&distances);
+    reader.get_array(&home_distances);
+    reader.get_array(&nearest_home_centres);
+    reader.get_array(&unit_keys);
+    reader.get_array(&dislodged_unit_keys);
+    reader.get_array(&owner_keys);
+
+    // Check the arrays fit together, and that every index held in them is in range, so a damaged file cannot lead to
+    // reading outside them
+    int number_of_rows = std::max(distance_row_length, 0);
+    int number_of_key_rows = std::max(number_of_powers, 0);
+
+    bool sizes_match = !reader.overrun()
+           && (reader.get_position() == length)
+           && (static_cast<int>(coasts.size()) == number_of_coasts)
+           && (province_first_coast.size() == MAX_PROVINCES + 1)
+           && (province_first_coast[MAX_PROVINCES] == number_of_coasts)
+           && (coast_adjacency_start.size() == static_cast<size_t>(number_of_coasts + 1))
+           && (coast_adjacency_start[number_of_coasts] == static_cast<int>(coast_adjacencies.size()))
+           && (province_adjacency_start.size() == MAX_PROVINCES + 1)
+           && (province_adjacency_start[MAX_PROVINCES] == static_cast<int>(province_adjacencies.size()))
+           && (army_adjacency_start.size() == MAX_PROVINCES + 1)
+           && (army_adjacency_start[MAX_PROVINCES] == static_cast<int>(army_adjacencies.size()))
+           && (fleet_adjacency_start.size() == MAX_PROVINCES + 1)
+           && (fleet_adjacency_start[MAX_PROVINCES] == static_cast<int>(fleet_adjacencies.size()))
+           && (army_distances.size() == static_cast<size_t>(number_of_rows * number_of_rows))
+           && (distances.size() == static_cast<size_t>(number_of_rows * number_of_rows))
+           && (coast_distances.size() == static_cast<size_t>(number_of_coasts * number_of_rows))
+           && (home_distances.size() == static_cast<size_t>(number_of_key_rows * number_of_rows))
+           && (nearest_home_centres.size() == home_distances.size())
+           && (unit_keys.size() == static_cast<size_t>(number_of_coasts * number_of_key_rows))
+           && (dislodged_unit_keys.size() == unit_keys.size())
+           && (owner_keys.size() == static_cast<size_t>(std::max(number_of_provinces, 0) * number_of_key_rows));
+    if (!sizes_match) { return false; }
+
+    // Provinces index the distance rows, as well as arrays of MAX_PROVINCES
+    int province_limit = std::min(number_of_rows, static_cast<int>(MAX_PROVINCES));
+
+    return (number_of_provinces >= 0) && (number_of_provinces <= MAX_PROVINCES)
+           && rows_in_order(province_first_coast)
+           && rows_in_order(coast_adjacency_start)
+           && rows_in_order(province_adjacency_start)
+           && rows_in_order(army_adjacency_start)
+           && rows_in_order(fleet_adjacency_start)
+           && all_below(coast_adjacencies, number_of_coasts)
+           && all_below(province_adjacencies, province_limit)
+           && all_below(army_adjacencies, province_limit)
+           && all_below(fleet_adjacencies, province_limit)
+           && std::all_of(nearest_home_centres.begin(), nearest_home_centres.end(), [province_limit](int province) {
+                  return (province == NO_PROVINCE) || ((province >= 0) && (province < province_limit));
+              });
+}
+
+std::shared_ptr<const MapTopology> MapCache::get_topology(const TokenMessage &mdf_message, int *error_location) {
+    uint64_t mdf_hash = hash_mdf(mdf_message);
+    std::string filename;
+    std::shared_ptr<MapTopology> topology;
+
+    *error_location = ADJUDICATOR_NO_ERROR;
+
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex);
+
+        auto cached_range = cached_topologies.equal_range(mdf_hash);
+        for (auto cached_itr = cached_range.first; cached_itr != cached_range.second; cached_itr++) {
+            if (cached_itr->second.mdf_message == mdf_message) { return cached_itr->second.topology; }
+        }
+
+        if (!cache_directory.empty()) { filename = get_filename(cache_directory, mdf_hash); }
+    }
+
+    // Not in memory, so try the file, then build it
+    if (!filename.empty()) { topology = read_file(filename, mdf_message); }
+
+    if (topology == nullptr) {
+        topology = std::make_shared<MapTopology>();
+        *error_location = topology->set_map(mdf_message);
+        if (*error_location != ADJUDICATOR_NO_ERROR) { return nullptr; }
+
+        if (!filename.empty()) { write_file(filename, mdf_message, *topology); }
+    }
+
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    cached_topologies.insert(std::make_pair(mdf_hash, CACHED_TOPOLOGY {mdf_message, topology}));
+    return topology;
+}
+
+void MapCache::set_cache_directory(const std::string &directory) {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    cache_directory = directory;
+}
+
+void MapCache::clear() {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    cached_topologies.clear();
+}
+
+uint64_t MapCache::hash_mdf(const TokenMessage &mdf_message) {
+    uint64_t hash = MapTopology::mix_hash(static_cast<uint64_t>(mdf_message.get_message_length()));
+
+    for (int token_ctr = 0; token_ctr < mdf_message.get_message_length(); token_ctr++) {
+        hash = MapTopology::mix_hash(hash ^ mdf_message.get_token(token_ctr).get_token());
+    }
+    return hash;
+}
+
+bool MapCache::write_file(const std::string &filename, const TokenMessage &mdf_message, const MapTopology &topology) {
+    std::vector<uint8_t> buffer;
+    ByteWriter writer(&buffer);
+    std::string temporary_filename = filename + "." + std::to_string(getpid()) + ".tmp";
+    FILE *file {nullptr};
+    bool written {false};
+
+    for (char magic_byte : FILE_MAGIC) { writer.put<char>(magic_byte); }
+    writer.put<uint32_t>(FILE_VERSION);
+    writer.put<uint32_t>(BYTE_ORDER_CHECK);
+    put_mdf(&writer, mdf_message);
+    topology.serialize(&buffer);
+
+    file = fopen(temporary_filename.c_str(), "wb");
+    if (file != nullptr) {
+        written = (fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size());
+        written = (fclose(file) == 0) && written;
+        written = written && (rename(temporary_filename.c_str(), filename.c_str()) == 0);
+
+        if (!written) { remove(temporary_filename.c_str()); }
+    }
+    return written;
+}
+
+std::shared_ptr<MapTopology> MapCache::read_file(const std::string &filename, const TokenMessage &mdf_message) {
+    std::shared_ptr<MapTopology> topology;
+    struct stat file_status {};
+    int file_descriptor {-1};
+    void *mapping {nullptr};
+
+    file_descriptor = open(filename.c_str(), O_RDONLY);
+    if (file_descriptor < 0) { return nullptr; }
+
+    if ((fstat(file_descriptor, &file_status) == 0) && (file_status.st_size > 0)) {
+        size_t length = static_cast<size_t>(file_status.st_size);
+
+        mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+        if (mapping != MAP_FAILED) {
+            const uint8_t *data = static_cast<const uint8_t *>(mapping);
+            ByteReader reader(data, length);
+
+            if (reader.get_matching(FILE_MAGIC, sizeof(FILE_MAGIC))
+                && (reader.get<uint32_t>() == FILE_VERSION)
+                && (reader.get<uint32_t>() == BYTE_ORDER_CHECK)
+                && mdf_matches(&reader, mdf_message)) {
+
+                topology = std::make_shared<MapTopology>();
+                if (!topology->deserialize(data + reader.get_position(), length - reader.get_position())) {
+                    topology = nullptr;
+                }
+            }
+            munmap(mapping, length);
+        }
+    }
+    close(file_descriptor);
+    return topology;
+}
+
+std::string MapCache::get_filename(const std::string &directory, uint64_t mdf_hash) {
+    char hash_text[17];
+
+    snprintf(hash_text, sizeof(hash_text), "%016llx", static_cast<unsigned long long>(mdf_hash));
+    return directory + "/daide_map_" + hash_text + ".bin";
+}
@@ -0,0 +1,52 @@
+/**
+ * Diplomacy AI Client - Part of the DAIDE project.
+ *
+ * Map Cache. Keeps each compiled map so that a game on a map which has been seen before starts without parsing and
+ * compiling the MDF again.
+ *
+ * Topologies are kept in memory for the life of the process, and in a cache file per map (named after a hash of the
+ * MDF) which later processes map into memory and load directly. Each cache file also holds its MDF, which must match
+ * exactly, so a hash collision cannot load the wrong map.
+ *
+ * Release 8~3
+ **/
+
+#ifndef _DAIDE_CLIENT_DAIDE_CLIENT_MAP_CACHE_H
+#define _DAIDE_CLIENT_DAIDE_CLIENT_MAP_CACHE_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "daide_client/map_topology.h"
+#include "daide_client/token_message.h"
+
+namespace DAIDE {
+
+class MapCache {
+public:
+    // The topology for an MDF message: from memory, else from the cache file, else built by MapTopology::set_map()
+    // and saved to both. Returns nullptr, with the error location set, if the MDF is not valid.
+    static std::shared_ptr<const MapTopology> get_topology(const TokenMessage &mdf_message, int *error_location);
+
+    // Where the cache files are kept (the working directory by default). An empty string turns the files off.
+    static void set_cache_directory(const std::string &directory);
+
+    // Forget the topologies held in memory (the files are kept)
+    static void clear();
+
+    static uint64_t hash_mdf(const TokenMessage &mdf_message);
+
+    // Save and load a single cache file. The file is written under a temporary name and renamed, so other processes
+    // never see part of one. read_file returns nullptr if the file is missing, damaged or for another MDF.
+    static bool write_file(const std::string &filename, const TokenMessage &mdf_message, const MapTopology &topology);
+
+    static std::shared_ptr<MapTopology> read_file(const std::string &filename, const TokenMessage &mdf_message);
+
+private:
+    static std::string get_filename(const std::string &directory, uint64_t mdf_hash);
+};
+
+} // namespace DAIDE
+
+#endif // _DAIDE_CLIENT_DAIDE_CLIENT_MAP_CACHE_H
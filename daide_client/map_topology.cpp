@@ -0,0 +1,585 @@
+/**
+ * Diplomacy AI Client - Part of the DAIDE project.
+ *
+ * Map Topology. Parses the MDF message into the provinces, coasts and adjacencies of the map.
+ *
+ * (C) David Norman 2002 david@ellought.demon.co.uk
+ *
+ * This software may be reused for non-commercial purposes without charge, and
+ * without notifying the author. Use of any part of this software for commercial
+ * purposes without permission from the Author is prohibited.
+ *
+ * Release 8~3
+ **/
+
+#include <algorithm>
+
+#include "daide_client/map_topology.h"
+
+using DAIDE::MapTopology;
+using DAIDE::Token;
+using DAIDE::TokenMessage;
+
+MapTopology::MapTopology() :
+    number_of_provinces {NO_MAP},
+    number_of_powers {NO_MAP},
+    number_of_coasts {0},
+    distance_row_length {0}
+{
+    for (auto &province : game_map) {
+        province.province_in_use = false;
+        province.is_supply_centre = false;
+        province.is_land = false;
+        province.initial_owner = TOKEN_PARAMETER_UNO;
+    }
+    compile_adjacencies();
+    compile_hash_keys();
+}
+
+std::shared_ptr<const MapTopology> MapTopology::empty_topology() {
+    static const std::shared_ptr<const MapTopology> topology = std::make_shared<MapTopology>();
+    return topology;
+}
+
+const MapTopology::COAST_SET &MapTopology::get_adjacent_coasts(const COAST_ID &coast) const {
+    static const COAST_SET no_adjacent_coasts;
+    const PROVINCE_COASTS &coast_info = game_map[coast.province_index].coast_info;
+
+    auto coast_itr = coast_info.find(coast.coast_token);
+    return (coast_itr == coast_info.end()) ? no_adjacent_coasts : coast_itr->second.adjacent_coasts;
+}
+
+int MapTopology::set_map(const TokenMessage &mdf_message) {
+    int error_location {ADJUDICATOR_NO_ERROR};      // location of error in the message, or ADJUDICATOR_NO_ERROR
+    TokenMessage mdf_command {};                    // The command
+    TokenMessage power_list {};                     // The list of powers
+    TokenMessage provinces {};                      // The provinces
+    TokenMessage adjacencies {};                    // The adjacencies
+
+    // Check there are 4 submessages
+    if (mdf_message.get_submessage_count() != 4) {
+        return 0;               // error location is 0
+    }
+
+    // Get the four parts of the message
+    mdf_command = mdf_message.get_submessage(0);
+    power_list = mdf_message.get_submessage(1);
+    provinces = mdf_message.get_submessage(2);
+    adjacencies = mdf_message.get_submessage(3);
+
+    // Check the mdf command
+    if (!mdf_command.is_single_token() || mdf_command.get_token() != TOKEN_COMMAND_MDF) {
+        return 0;               // error location is 0
+    }
+
+    // Process power list
+    error_location = process_power_list(power_list);
+    if (error_location != ADJUDICATOR_NO_ERROR) { return error_location; }
+
+    // Process provinces
+    error_location = process_provinces(provinces);
+    if (error_location != ADJUDICATOR_NO_ERROR) { return error_location; }
+
+    // Process adjacencies
+    error_location = process_adjacencies(adjacencies);
+    if (error_location != ADJUDICATOR_NO_ERROR) { return error_location; }
+
+    compile_adjacencies();
+    compile_distances();
+    compile_hash_keys();
+
+    // No errors
+    return error_location;
+}
+
+int MapTopology::process_power_list(const TokenMessage &power_list) {
+    bool power_used[MAX_POWERS] {};
+    int error_location {ADJUDICATOR_NO_ERROR};
+    Token power {};
+
+    number_of_powers = power_list.get_message_length();
+
+    // Marking all powers as false
+    for (int power_ctr = 0; power_ctr < number_of_powers; power_ctr++) {
+        power_used[power_ctr] = false;
+    }
+
+    // Making sure powers are valid and not used twice
+    for (int power_ctr = 0; power_ctr < number_of_powers; power_ctr++) {
+        power = power_list.get_token(power_ctr);
+        if ((power.get_subtoken() >= number_of_powers) || (power_used[power.get_subtoken()])) {
+            error_location = power_ctr;
+        } else {
+            power_used[power.get_subtoken()] = true;
+        }
+        if (error_location != ADJUDICATOR_NO_ERROR) { break; }
+    }
+
+    return error_location;
+}
+
+int MapTopology::process_provinces(const TokenMessage &provinces) {
+    int error_location {ADJUDICATOR_NO_ERROR};
+    TokenMessage supply_centres {};
+    TokenMessage non_supply_centres {};
+
+    // Resetting all provinces
+    for (auto &province : game_map) {
+        province.province_in_use = false;
+        province.is_supply_centre = false;
+        province.is_land = false;
+        province.coast_info.clear();
+        province.home_centre_set.clear();
+    }
+
+    // Retrieving SC and Non-SC info
+    supply_centres = provinces.get_submessage(0);
+    non_supply_centres = provinces.get_submessage(1);
+
+    // Processing SC
+    error_location = process_supply_centres(supply_centres);
+    if (error_location != ADJUDICATOR_NO_ERROR) { return error_location + provinces.get_submessage_start(0); }
+
+    // Processing Non-SC
+    error_location = process_non_supply_centres(non_supply_centres);
+    if (error_location != ADJUDICATOR_NO_ERROR) { return error_location + provinces.get_submessage_start(1); }
+
+    // Counting provinces
+    // MAX_PROVINCES has 256 provinces, while the standard map has only 81
+    // We should not reach any used province after finding the first unused province
+    number_of_provinces = -1;
+    for (int province_ctr = 0; province_ctr < MAX_PROVINCES; province_ctr++) {
+
+        // Error - Found a used province after an unused one
+        if (game_map[province_ctr].province_in_use && number_of_provinces != -1) {
+            return provinces.get_submessage_start(1) - 1;
+        }
+
+        // End of provinces - First unused province detected
+        if (!game_map[province_ctr].province_in_use && number_of_provinces == -1) {
+            number_of_provinces = province_ctr;
+        }
+    }
+
+    return error_location;
+}
+
+int MapTopology::process_supply_centres(const TokenMessage &supply_centres) {
+    int error_location {ADJUDICATOR_NO_ERROR};
+
+    for (int submessage_ctr = 0; submessage_ctr < supply_centres.get_submessage_count(); submessage_ctr++) {
+        error_location = process_supply_centres_for_power(supply_centres.get_submessage(submessage_ctr));
+        if (error_location != ADJUDICATOR_NO_ERROR) {
+            return error_location + supply_centres.get_submessage_start(submessage_ctr);
+        }
+    }
+    return error_location;
+}
+
+int MapTopology::process_supply_centres_for_power(const TokenMessage &supply_centres) {
+    int error_location {ADJUDICATOR_NO_ERROR};
+    int province_index {-1};
+    Token token {};
+    Token power {TOKEN_PARAMETER_UNO};
+    TokenMessage submessage {};
+    HOME_CENTRE_SET home_centre_set;
+
+    for (int submessage_ctr = 0; submessage_ctr < supply_centres.get_submessage_count(); submessage_ctr++) {
+        submessage = supply_centres.get_submessage(submessage_ctr);
+
+        // Single token (POWER, PROVINCE)
+        if (submessage.is_single_token()) {
+            token = submessage.get_token();
+
+            // Token is power
+            if (token.get_category() == CATEGORY_POWER) {
+
+                // Error - Too many powers
+                if (token.get_subtoken() >= number_of_powers) {
+                    return supply_centres.get_submessage_start(submessage_ctr);
+                }
+
+                home_centre_set.insert(token.get_subtoken());
+                power = token;
+
+            // Token is province
+            } else if (token.is_province()) {
+                province_index = token.get_subtoken();
+
+                // Error - Province already in use
+                if (game_map[province_index].province_in_use) {
+                    return supply_centres.get_submessage_start(submessage_ctr);
+                }
+
+                game_map[province_index].province_token = token;
+                game_map[province_index].province_in_use = true;
+                game_map[province_index].home_centre_set = home_centre_set;
+                game_map[province_index].is_supply_centre = true;
+                game_map[province_index].initial_owner = power;
+
+
+            // Unexpected token
+            } else if (token != TOKEN_PARAMETER_UNO) {
+                return supply_centres.get_submessage_start(submessage_ctr);
+            }
+
+        // Multiple tokens
+        } else {
+            for (int token_ctr = 0; token_ctr < submessage.get_message_length(); token_ctr++) {
+                token = submessage.get_token(token_ctr);
+
+                // Power
+                if (token.get_category() == CATEGORY_POWER) {
+
+                    // Error - Too many powers
+                    if (token.get_subtoken() >= number_of_powers) {
+                        return token_ctr + supply_centres.get_submessage_start(submessage_ctr);
+                    }
+
+                    home_centre_set.insert(token.get_subtoken());
+                    power = token;
+
+                // Unknown token
+                } else {
+                    return supply_centres.get_submessage_start(submessage_ctr);
+                }
+            }
+        }
+    }
+
+    return error_location;
+}
+
+int MapTopology::process_non_supply_centres(const TokenMessage &non_supply_centres) {
+    int error_location {ADJUDICATOR_NO_ERROR};
+    int province_index {-1};
+    Token token {};
+
+    for (int token_ctr = 0; token_ctr < non_supply_centres.get_message_length(); token_ctr++) {
+        token = non_supply_centres.get_token(token_ctr);
+
+        // Province
+        if (token.is_province()) {
+            province_index = token.get_subtoken();
+            if (game_map[province_index].province_in_use) { return token_ctr; }
+            game_map[province_index].province_token = token;
+            game_map[province_index].province_in_use = true;
+            game_map[province_index].initial_owner = TOKEN_PARAMETER_UNO;
+
+        // Unexpected token
+        } else if (token != TOKEN_PARAMETER_UNO) { return token_ctr; }
+    }
+
+    return error_location;
+}
+
+int MapTopology::process_adjacencies(const TokenMessage &adjacencies) {
+    int error_location {ADJUDICATOR_NO_ERROR};
+    TokenMessage province_adjacency {};
+
+    for (int province_ctr = 0; province_ctr < adjacencies.get_submessage_count(); province_ctr++) {
+        province_adjacency = adjacencies.get_submessage(province_ctr);
+        error_location = process_province_adjacency(province_adjacency);
+        if (error_location != ADJUDICATOR_NO_ERROR) {
+            return error_location + adjacencies.get_submessage_start(province_ctr);
+        }
+    }
+    return error_location;
+}
+
+int MapTopology::process_province_adjacency(const TokenMessage &province_adjacency) {
+    int error_location {ADJUDICATOR_NO_ERROR};
+    Token province_token {};
+    TokenMessage adjacency_list {};
+    PROVINCE_DETAILS *province_details {nullptr};
+
+    province_token = province_adjacency.get_token(0);
+    province_details = &(game_map[province_token.get_subtoken()]);
+
+    if (!province_details->province_in_use || !province_details->coast_info.empty()) {
+        return 0;           // error_location = 0
+    }
+
+    for (int adjacency_ctr = 1; adjacency_ctr < province_adjacency.get_submessage_count(); adjacency_ctr++) {
+        adjacency_list = province_adjacency.get_submessage(adjacency_ctr);
+        error_location = process_adjacency_list(province_details, adjacency_list);
+        if (error_location != ADJUDICATOR_NO_ERROR) {
+            return error_location + province_adjacency.get_submessage_start(adjacency_ctr);
+        }
+    }
+    return error_location;
+}
+
+int MapTopology::process_adjacency_list(PROVINCE_DETAILS *province_details, const TokenMessage &adjacency_list) {
+    int error_location {ADJUDICATOR_NO_ERROR};
+    COAST_ID adjacent_coast {-1};
+    Token coast_token {};
+    Token adjacent_coast_token {};
+    Token province_token {};
+    TokenMessage adjacency_token {};
+    COAST_DETAILS *coast_details {nullptr};
+
+    adjacency_token = adjacency_list.get_submessage(0);
+
+    if (adjacency_token.is_single_token()) {
+        coast_token = adjacency_token.get_token();
+        adjacent_coast_token = coast_token;
+        if (coast_token == TOKEN_UNIT_AMY) { province_details->is_land = true; }
+    } else {
+        coast_token = adjacency_token.get_token(1);
+        adjacent_coast_token = TOKEN_UNIT_FLT;
+    }
+
+    coast_details = &(province_details->coast_info[coast_token]);
+    if (!coast_details->adjacent_coasts.empty()) {
+        return 0;               // error_location = 0
+    }
+
+    for (int adjacency_ctr = 1; adjacency_ctr < adjacency_list.get_submessage_count(); adjacency_ctr++) {
+        adjacency_token = adjacency_list.get_submessage(adjacency_ctr);
+
+        if (adjacency_token.is_single_token()) {
+            province_token = adjacency_token.get_token();
+            adjacent_coast.province_index = province_token.get_subtoken();
+            adjacent_coast.coast_token = adjacent_coast_token;
+        } else {
+            province_token = adjacency_token.get_token(0);
+            coast_token = adjacency_token.get_token(1);
+            adjacent_coast.province_index = province_token.get_subtoken();
+            adjacent_coast.coast_token = coast_token;
+        }
+
+        coast_details->adjacent_coasts.insert(adjacent_coast);
+    }
+    return error_location;
+}
+
+void MapTopology::compile_adjacencies() {
+    coasts.clear();
+    province_first_coast.assign(MAX_PROVINCES + 1, 0);
+
+    // Number the coasts
+    for (int province_ctr = 0; province_ctr < MAX_PROVINCES; province_ctr++) {
+        province_first_coast[province_ctr] = static_cast<int>(coasts.size());
+
+        for (const auto &coast_itr : game_map[province_ctr].coast_info) {
+            coasts.push_back(COAST_ID {province_ctr, coast_itr.first});
+        }
+    }
+    province_first_coast[MAX_PROVINCES] = static_cast<int>(coasts.size());
+    number_of_coasts = static_cast<int>(coasts.size());
+
+    // Coast adjacencies
+    coast_adjacency_start.assign(number_of_coasts + 1, 0);
+    coast_adjacencies.clear();
+
+    for (COAST_INDEX coast_ctr = 0; coast_ctr < number_of_coasts; coast_ctr++) {
+        coast_adjacency_start[coast_ctr] = static_cast<int>(coast_adjacencies.size());
+
+        for (const auto &adjacent_coast : get_adjacent_coasts(coasts[coast_ctr])) {
+            COAST_INDEX adjacent_coast_index = get_coast_index(adjacent_coast);
+            if (adjacent_coast_index != NO_COAST) {
+                coast_adjacencies.push_back(adjacent_coast_index);
+            }
+        }
+    }
+    coast_adjacency_start[number_of_coasts] = static_cast<int>(coast_adjacencies.size());
+
+    // Province adjacencies, for any unit and for each unit type
+    province_adjacency_start.assign(MAX_PROVINCES + 1, 0);
+    army_adjacency_start.assign(MAX_PROVINCES + 1, 0);
+    fleet_adjacency_start.assign(MAX_PROVINCES + 1, 0);
+    province_adjacencies.clear();
+    army_adjacencies.clear();
+    fleet_adjacencies.clear();
+
+    for (int province_ctr = 0; province_ctr < MAX_PROVINCES; province_ctr++) {
+        bool is_adjacent[MAX_PROVINCES] {};
+        bool is_army_adjacent[MAX_PROVINCES] {};
+        bool is_fleet_adjacent[MAX_PROVINCES] {};
+
+        province_adjacency_start[province_ctr] = static_cast<int>(province_adjacencies.size());
+        army_adjacency_start[province_ctr] = static_cast<int>(army_adjacencies.size());
+        fleet_adjacency_start[province_ctr] = static_cast<int>(fleet_adjacencies.size());
+
+        for (COAST_INDEX coast_ctr = get_first_coast(province_ctr);
+             coast_ctr < get_end_coast(province_ctr);
+             coast_ctr++) {
+
+            bool is_army_coast = (coasts[coast_ctr].coast_token == TOKEN_UNIT_AMY);
+
+            for (COAST_INDEX adjacent_coast : get_coast_adjacencies(coast_ctr)) {
+                PROVINCE_INDEX adjacent_province = coasts[adjacent_coast].province_index;
+                is_adjacent[adjacent_province] = true;
+                (is_army_coast ? is_army_adjacent : is_fleet_adjacent)[adjacent_province] = true;
+            }
+        }
+
+        for (int adjacent_ctr = 0; adjacent_ctr < MAX_PROVINCES; adjacent_ctr++) {
+            if (is_adjacent[adjacent_ctr]) { province_adjacencies.push_back(adjacent_ctr); }
+            if (is_army_adjacent[adjacent_ctr]) { army_adjacencies.push_back(adjacent_ctr); }
+            if (is_fleet_adjacent[adjacent_ctr]) { fleet_adjacencies.push_back(adjacent_ctr); }
+        }
+    }
+    province_adjacency_start[MAX_PROVINCES] = static_cast<int>(province_adjacencies.size());
+    army_adjacency_start[MAX_PROVINCES] = static_cast<int>(army_adjacencies.size());
+    fleet_adjacency_start[MAX_PROVINCES] = static_cast<int>(fleet_adjacencies.size());
+}
+
+void MapTopology::compile_distances() {
+    distance_row_length = std::max(number_of_provinces, 0);
+
+    army_distances.assign(distance_row_length * distance_row_length, UNREACHABLE);
+    distances.assign(distance_row_length * distance_row_length, UNREACHABLE);
+    coast_distances.assign(number_of_coasts * distance_row_length, UNREACHABLE);
+    home_distances.assign(std::max(number_of_powers, 0) * distance_row_length, UNREACHABLE);
+    nearest_home_centres.assign(std::max(number_of_powers, 0) * distance_row_length, NO_PROVINCE);
+
+    for (PROVINCE_INDEX province_ctr = 0; province_ctr < distance_row_length; province_ctr++) {
+        find_distances(province_ctr, &MapTopology::get_army_adjacencies,
+                       &army_distances[province_ctr * distance_row_length]);
+        find_distances(province_ctr, &MapTopology::get_province_adjacencies,
+                       &distances[province_ctr * distance_row_length]);
+    }
+
+    // A unit on a coast can only move along the adjacencies of its own coast, and the coasts it reaches. Search the
+    // coast graph, and keep the shortest distance to any coast of each province.
+    std::vector<COAST_INDEX> coasts_to_check(number_of_coasts);
+    std::vector<int> coast_distance(number_of_coasts);
+
+    for (COAST_INDEX coast_ctr = 0; coast_ctr < number_of_coasts; coast_ctr++) {
+        uint8_t *distance_row = &coast_distances[coast_ctr * distance_row_length];
+        int number_to_check {0};
+        int next_to_check {0};
+
+        std::fill(coast_distance.begin(), coast_distance.end(), static_cast<int>(UNREACHABLE));
+        coast_distance[coast_ctr] = 0;
+        coasts_to_check[number_to_check++] = coast_ctr;
+
+        while (next_to_check < number_to_check) {
+            COAST_INDEX coast_being_checked = coasts_to_check[next_to_check++];
+            PROVINCE_INDEX province_being_checked = coasts[coast_being_checked].province_index;
+            int distance = coast_distance[coast_being_checked];
+
+            if ((province_being_checked < distance_row_length) && (distance < distance_row[province_being_checked])) {
+                distance_row[province_being_checked] = static_cast<uint8_t>(distance);
+            }
+
+            for (COAST_INDEX adjacent_coast : get_coast_adjacencies(coast_being_checked)) {
+                if ((coast_distance[adjacent_coast] == UNREACHABLE) && (distance + 1 < UNREACHABLE)) {
+                    coast_distance[adjacent_coast] = distance + 1;
+                    coasts_to_check[number_to_check++] = adjacent_coast;
+                }
+            }
+        }
+    }
+
+    // The nearest home centre of each power. On a tie, the lowest numbered centre.
+    for (PROVINCE_INDEX province_ctr = 0; province_ctr < distance_row_length; province_ctr++) {
+        for (POWER_INDEX power : game_map[province_ctr].home_centre_set) {
+            if ((power < 0) || (power >= number_of_powers)) { continue; }
+
+            for (PROVINCE_INDEX from_ctr = 0; from_ctr < distance_row_length; from_ctr++) {
+                int distance = get_distance(from_ctr, province_ctr);
+                int entry = power * distance_row_length + from_ctr;
+
+                if (distance < home_distances[entry]) {
+                    home_distances[entry] = static_cast<uint8_t>(distance);
+                    nearest_home_centres[entry] = province_ctr;
+                }
+            }
+        }
+    }
+}
+
+void MapTopology::find_distances(PROVINCE_INDEX from,
+                                 INDEX_LIST (MapTopology::*get_adjacencies)(PROVINCE_INDEX) const,
+                                 uint8_t *distance_row) const {
+    PROVINCE_INDEX provinces_to_check[MAX_PROVINCES];
+    int number_to_check {0};
+    int next_to_check {0};
+
+    distance_row[from] = 0;
+    provinces_to_check[number_to_check++] = from;
+
+    while (next_to_check < number_to_check) {
+        PROVINCE_INDEX province_being_checked = provinces_to_check[next_to_check++];
+        int distance = distance_row[province_being_checked];
+
+        for (PROVINCE_INDEX adjacent_province : (this->*get_adjacencies)(province_being_checked)) {
+            if ((adjacent_province < distance_row_length)
+                && (distance_row[adjacent_province] == UNREACHABLE)
+                && (distance + 1 < UNREACHABLE)) {
+
+                distance_row[adjacent_province] = static_cast<uint8_t>(distance + 1);
+                provinces_to_check[number_to_check++] = adjacent_province;
+            }
+        }
+    }
+}
+
+void MapTopology::compile_hash_keys() {
+    int powers = std::max(number_of_powers, 0);
+
+    unit_keys.assign(number_of_coasts * powers, 0);
+    dislodged_unit_keys.assign(number_of_coasts * powers, 0);
+    owner_keys.assign(std::max(number_of_provinces, 0) * powers, 0);
+
+    for (COAST_INDEX coast_ctr = 0; coast_ctr < number_of_coasts; coast_ctr++) {
+        uint64_t coast_value = (static_cast<uint64_t>(coasts[coast_ctr].province_index) << 24)
+                               | (static_cast<uint64_t>(coasts[coast_ctr].coast_token.get_token()) << 8);
+
+        for (POWER_INDEX power_ctr = 0; power_ctr < powers; power_ctr++) {
+            unit_keys[coast_ctr * powers + power_ctr] = mix_hash(HASH_SEED_UNIT + (coast_value | power_ctr));
+            dislodged_unit_keys[coast_ctr * powers + power_ctr] =
+                    mix_hash(HASH_SEED_DISLODGED_UNIT + (coast_value | power_ctr));
+        }
+    }
+
+    for (PROVINCE_INDEX province_ctr = 0; province_ctr < number_of_provinces; province_ctr++) {
+        if (!game_map[province_ctr].is_supply_centre) { continue; }
+
+        for (POWER_INDEX power_ctr = 0; power_ctr < powers; power_ctr++) {
+            owner_keys[province_ctr * powers + power_ctr] =
+                    mix_hash(HASH_SEED_OWNER + ((static_cast<uint64_t>(province_ctr) << 8) | power_ctr));
+        }
+    }
+}
+
+uint64_t MapTopology::get_season_key(const Token &season) {
+    if ((season.get_token() < TOKEN_SEASON_SPR.get_token()) || (season.get_token() > TOKEN_SEASON_WIN.get_token())) {
+        return 0;
+    }
+    return mix_hash(HASH_SEED_SEASON + season.get_token());
+}
+
+MapTopology::COAST_INDEX MapTopology::get_coast_index(const COAST_ID &coast) const {
+    if ((coast.province_index < 0) || (coast.province_index >= MAX_PROVINCES)) { return NO_COAST; }
+
+    // A province has at most a few coasts, so a linear search is quickest
+    for (COAST_INDEX coast_ctr = get_first_coast(coast.province_index);
+         coast_ctr < get_end_coast(coast.province_index);
+         coast_ctr++) {
+
+        if (coasts[coast_ctr].coast_token == coast.coast_token) { return coast_ctr; }
+    }
+    return NO_COAST;
+}
+
+bool MapTopology::can_move_to(COAST_INDEX coast_index, COAST_INDEX destination) const {
+    if ((coast_index == NO_COAST) || (destination == NO_COAST)) { return false; }
+
+    for (COAST_INDEX adjacent_coast : get_coast_adjacencies(coast_index)) {
+        if (adjacent_coast == destination) { return true; }
+    }
+    return false;
+}
+
+bool MapTopology::can_move_to_province(COAST_INDEX coast_index, PROVINCE_INDEX province_index) const {
+    if (coast_index == NO_COAST) { return false; }
+
+    for (COAST_INDEX adjacent_coast : get_coast_adjacencies(coast_index)) {
+        if (coasts[adjacent_coast].province_index == province_index) { return true; }
+    }
+    return false;
+}
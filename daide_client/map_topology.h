@@ -0,0 +1,224 @@
+/**
+ * Diplomacy AI Client - Part of the DAIDE project.
+ *
+ * Map Topology. The parts of the map which never change during a game: the provinces, their coasts, the adjacencies
+ * and the home centres. Built once from the MDF message and then shared, read-only, by every copy of the position.
+ *
+ * (C) David Norman 2002 david@ellought.demon.co.uk
+ *
+ * This software may be reused for non-commercial purposes without charge, and
+ * without notifying the author. Use of any part of this software for commercial
+ * purposes without permission from the Author is prohibited.
+ *
+ * Release 8~3
+ **/
+
+#ifndef _DAIDE_CLIENT_DAIDE_CLIENT_MAP_TOPOLOGY_H
+#define _DAIDE_CLIENT_DAIDE_CLIENT_MAP_TOPOLOGY_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "daide_client/map_types.h"
+#include "daide_client/token_message.h"
+
+namespace DAIDE {
+
+class MapTopology : public MapTypes {
+public:
+    // The map
+    PROVINCE_DETAILS game_map[MAX_PROVINCES];
+
+    int number_of_provinces;                    // Number of provinces on the map
+    int number_of_powers;                       // The number of powers in the variant
+    int number_of_coasts;                       // The number of coasts on the map (all provinces)
+
+    MapTopology();
+
+    // Build the topology from an MDF message. Returns the location of any error, or ADJUDICATOR_NO_ERROR.
+    int set_map(const TokenMessage &mdf_message);
+
+    // Get the adjacency list for a coast. Empty if the province does not have that coast.
+    const COAST_SET &get_adjacent_coasts(const COAST_ID &coast) const;
+
+    // The compiled adjacencies. These hold the same information as coast_info, built once by set_map into flat
+    // arrays (compressed sparse rows) so they can be iterated without walking the map and set nodes.
+
+    // Convert between a coast and its dense index. get_coast_index returns NO_COAST if the province has no such coast.
+    COAST_INDEX get_coast_index(const COAST_ID &coast) const;
+
+    const COAST_ID &get_coast(COAST_INDEX coast_index) const { return coasts[coast_index]; }
+
+    // The coasts of a province
+    COAST_INDEX get_first_coast(PROVINCE_INDEX province_index) const { return province_first_coast[province_index]; }
+
+    COAST_INDEX get_end_coast(PROVINCE_INDEX province_index) const { return province_first_coast[province_index + 1]; }
+
+    // The coasts adjacent to a coast, in the same order as its COAST_SET
+    INDEX_LIST get_coast_adjacencies(COAST_INDEX coast_index) const {
+        return make_index_list(coast_adjacencies, coast_adjacency_start, coast_index);
+    }
+
+    // The provinces adjacent to a province by any unit, by an army and by a fleet (on any coast). Sorted.
+    INDEX_LIST get_province_adjacencies(PROVINCE_INDEX province_index) const {
+        return make_index_list(province_adjacencies, province_adjacency_start, province_index);
+    }
+
+    INDEX_LIST get_army_adjacencies(PROVINCE_INDEX province_index) const {
+        return make_index_list(army_adjacencies, army_adjacency_start, province_index);
+    }
+
+    INDEX_LIST get_fleet_adjacencies(PROVINCE_INDEX province_index) const {
+        return make_index_list(fleet_adjacencies, fleet_adjacency_start, province_index);
+    }
+
+    // Whether a unit on the given coast can move to the coast, or to any coast of the province
+    bool can_move_to(COAST_INDEX coast_index, COAST_INDEX destination) const;
+
+    bool can_move_to_province(COAST_INDEX coast_index, PROVINCE_INDEX province_index) const;
+
+    // Shortest path distances, in moves, computed once by set_map. UNREACHABLE if there is no path.
+    enum { UNREACHABLE = 255 };
+
+    // For an army moving overland
+    int get_army_distance(PROVINCE_INDEX from, PROVINCE_INDEX to) const {
+        return army_distances[from * distance_row_length + to];
+    }
+
+    // For a unit on the given coast: a fleet, or an army on its TOKEN_UNIT_AMY coast
+    int get_coast_distance(COAST_INDEX from, PROVINCE_INDEX to) const {
+        return coast_distances[from * distance_row_length + to];
+    }
+
+    // Ignoring the unit type, so through any coast of each province
+    int get_distance(PROVINCE_INDEX from, PROVINCE_INDEX to) const {
+        return distances[from * distance_row_length + to];
+    }
+
+    // The distance (ignoring unit type) to the nearest home centre of a power, and the centre itself
+    int get_distance_to_home(POWER_INDEX power, PROVINCE_INDEX from) const {
+        return home_distances[power * distance_row_length + from];
+    }
+
+    PROVINCE_INDEX get_nearest_home_centre(POWER_INDEX power, PROVINCE_INDEX from) const {
+        return nearest_home_centres[power * distance_row_length + from];
+    }
+
+    // A power's whole row of distances to home, by province, for scanning every province at once
+    const uint8_t *get_home_distances(POWER_INDEX power) const {
+        return &home_distances[power * distance_row_length];
+    }
+
+    // Zobrist keys for hashing a position. Each is made from what it stands for (province, coast, power) rather than
+    // from the compiled indexes, so the same position hashes the same in every instance and every run. The coast
+    // gives the unit type, as armies and fleets are on different coasts.
+    uint64_t get_unit_key(COAST_INDEX coast_index, POWER_INDEX power) const {
+        return unit_keys[coast_index * number_of_powers + power];
+    }
+
+    uint64_t get_dislodged_unit_key(COAST_INDEX coast_index, POWER_INDEX power) const {
+        return dislodged_unit_keys[coast_index * number_of_powers + power];
+    }
+
+    // Zero for provinces which are not supply centres
+    uint64_t get_owner_key(PROVINCE_INDEX province_index, POWER_INDEX power) const {
+        return owner_keys[province_index * number_of_powers + power];
+    }
+
+    // Zero for anything which is not a season
+    static uint64_t get_season_key(const Token &season);
+
+    static uint64_t get_year_key(int year) { return mix_hash(HASH_SEED_YEAR + static_cast<uint32_t>(year)); }
+
+    // Scramble a 64 bit value (the splitmix64 finaliser). Used to make keys, and to hash orders.
+    static uint64_t mix_hash(uint64_t value) {
+        value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+        return value ^ (value >> 31);
+    }
+
+    // The topology used before any map has been set
+    static std::shared_ptr<const MapTopology> empty_topology();
+
+    // Save the whole compiled topology as flat, aligned arrays, and load it back without parsing or compiling
+    // anything. Used by MapCache. deserialize returns false if the data is not a topology saved by this version.
+    void serialize(std::vector<uint8_t> *buffer) const;
+
+    bool deserialize(const uint8_t *data, size_t length);
+
+private:
+    int process_power_list(const TokenMessage &power_list);
+
+    int process_provinces(const TokenMessage &provinces);
+
+    int process_supply_centres(const TokenMessage &supply_centres);
+
+    int process_supply_centres_for_power(const TokenMessage &supply_centres);
+
+    int process_non_supply_centres(const TokenMessage &non_supply_centres);
+
+    int process_adjacencies(const TokenMessage &adjacencies);
+
+    int process_province_adjacency(const TokenMessage &province_adjacency);
+
+    static int process_adjacency_list(PROVINCE_DETAILS *province_details, const TokenMessage &adjacency_list);
+
+    // Build the compiled adjacencies from coast_info
+    void compile_adjacencies();
+
+    // Build the distance tables from the compiled adjacencies
+    void compile_distances();
+
+    // Build the Zobrist keys for the compiled coasts
+    void compile_hash_keys();
+
+    // Breadth first search over the province graph given by get_adjacencies, writing one row of a distance table
+    void find_distances(PROVINCE_INDEX from,
+                        INDEX_LIST (MapTopology::*get_adjacencies)(PROVINCE_INDEX) const,
+                        uint8_t *distance_row) const;
+
+    static INDEX_LIST make_index_list(const std::vector<int> &values, const std::vector<int> &start, int row) {
+        return INDEX_LIST {values.data() + start[row], values.data() + start[row + 1]};
+    }
+
+    std::vector<COAST_ID> coasts;                       // Coast for each coast index
+    std::vector<COAST_INDEX> province_first_coast;      // First coast index of each province (and one past the end)
+
+    std::vector<int> coast_adjacency_start;             // Row starts, indexed by coast
+    std::vector<COAST_INDEX> coast_adjacencies;
+
+    std::vector<int> province_adjacency_start;          // Row starts, indexed by province
+    std::vector<PROVINCE_INDEX> province_adjacencies;
+
+    std::vector<int> army_adjacency_start;
+    std::vector<PROVINCE_INDEX> army_adjacencies;
+
+    std::vector<int> fleet_adjacency_start;
+    std::vector<PROVINCE_INDEX> fleet_adjacencies;
+
+    // Distance tables, one row per source and distance_row_length (the number of provinces) columns
+    int distance_row_length;
+    std::vector<uint8_t> army_distances;                // Row per province
+    std::vector<uint8_t> coast_distances;               // Row per coast
+    std::vector<uint8_t> distances;                     // Row per province
+    std::vector<uint8_t> home_distances;                // Row per power
+    std::vector<PROVINCE_INDEX> nearest_home_centres;   // Row per power. NO_PROVINCE if no home centre is reachable
+
+    // Zobrist keys, number_of_powers per coast or province
+    enum : uint64_t {
+        HASH_SEED_UNIT = 0x756e697400000000ULL,
+        HASH_SEED_DISLODGED_UNIT = 0x646c677400000000ULL,
+        HASH_SEED_OWNER = 0x6f776e7200000000ULL,
+        HASH_SEED_SEASON = 0x736e736e00000000ULL,
+        HASH_SEED_YEAR = 0x7965617200000000ULL
+    };
+
+    std::vector<uint64_t> unit_keys;
+    std::vector<uint64_t> dislodged_unit_keys;
+    std::vector<uint64_t> owner_keys;
+};
+
+} // namespace DAIDE
+
+#endif // _DAIDE_CLIENT_DAIDE_CLIENT_MAP_TOPOLOGY_H
@@ -0,0 +1,214 @@
+/**
+ * Diplomacy AI Client - Part of the DAIDE project.
+ *
+ * Map Types. The constants and types shared by the map topology, the game position and the MapAndUnits class.
+ *
+ * (C) David Norman 2002 david@ellought.demon.co.uk
+ *
+ * This software may be reused for non-commercial purposes without charge, and
+ * without notifying the author. Use of any part of this software for commercial
+ * purposes without permission from the Author is prohibited.
+ *
+ * Release 8~3
+ **/
+
+#ifndef _DAIDE_CLIENT_DAIDE_CLIENT_MAP_TYPES_H
+#define _DAIDE_CLIENT_DAIDE_CLIENT_MAP_TYPES_H
+
+#include <cstdint>
+
+#include "daide_client/province_map.h"
+#include "daide_client/province_set.h"
+#include "daide_client/types.h"
+#include "daide_client/tokens.h"
+
+namespace DAIDE {
+
+// Holds no data. Classes derive from it so the types can still be named as MapAndUnits::COAST_ID etc.
+class MapTypes {
+public:
+    // Constants
+    enum { MAX_PROVINCES = 256 };
+    enum { MAX_POWERS = 256 };
+    enum { NO_MAP = -1 };                   // Value used to indicate no map has been set up.
+
+
+    // A province index. To convert from Token to PROVINCE_INDEX, use token.get_subtoken().
+    // To convert from PROVINCE_INDEX to token, use game_map[ province_index ].province_token.
+    using PROVINCE_INDEX = int;
+
+    // A power index. To convert from Token to POWER_INDEX, use token.get_subtoken().
+    // To convert from POWER_INDEX to token, Token::Token( CATEGORY_POWER, power_index );
+    using POWER_INDEX = int;
+
+    // A coast. The coast_token should be a TOKEN_COAST_... , or TOKEN_UNIT_FLT
+    // for a province which does not have multiple coasts, or TOKEN_UNIT_AMY for
+    // an army in the province.
+    // Examples: Paris has one coast (TOKEN_UNIT_AMY). Brest has two coasts (TOKEN_UNIT_AMY and
+    // TOKEN_UNIT_FLT). Spain has three coasts (TOKEN_UNIT_AMY, TOKEN_COAST_NCS and
+    // TOKEN_COAST_SCS). North Sea has one coast (TOKEN_UNIT_FLT).
+    using COAST_ID = struct tag_coast_id {
+        PROVINCE_INDEX province_index;
+        Token coast_token;
+
+        bool operator<(const struct tag_coast_id &other_coast_id) const {
+            return ((province_index < other_coast_id.province_index)
+                    || ((province_index == other_coast_id.province_index)
+                         && (coast_token < other_coast_id.coast_token)));
+        }
+    };
+
+    // A dense index for a coast, from 0 to number_of_coasts - 1. Coasts are numbered in province order, and in
+    // coast token order within a province.
+    using COAST_INDEX = int;
+    enum { NO_COAST = -1 };
+    enum { NO_PROVINCE = -1 };
+
+    // A contiguous run of indexes in one of the compiled adjacency arrays of the MapTopology. Iterate it like a container.
+    using INDEX_LIST = struct tag_index_list {
+        const int *first;
+        const int *last;
+
+        const int *begin() const { return first; }
+        const int *end() const { return last; }
+        int size() const { return static_cast<int>(last - first); }
+        bool empty() const { return first == last; }
+    };
+
+    // Orders which a unit can be given
+    using ORDER_TYPE = enum {
+        NO_ORDER,
+        HOLD_ORDER,
+        MOVE_ORDER,
+        SUPPORT_TO_HOLD_ORDER,
+        SUPPORT_TO_MOVE_ORDER,
+        CONVOY_ORDER,
+        MOVE_BY_CONVOY_ORDER,
+
+        RETREAT_ORDER,
+        DISBAND_ORDER,
+
+        // The following can not be ordered, but may be used by the adjudicator
+        HOLD_NO_SUPPORT_ORDER
+    };
+
+    // Used by the adjudicator
+    using RING_UNIT_STATUS = enum {
+        RING_ADVANCES_REGARDLESS,
+        RING_ADVANCES_IF_VACANT,
+        STANDOFF_REGARDLESS,
+        SIDE_ADVANCES_IF_VACANT,
+        SIDE_ADVANCES_REGARDLESS
+    };
+
+    // Collections
+    using UNIT_LIST = std::list<PROVINCE_INDEX>;
+    using UNIT_SET = ProvinceSet;               // Units, by the province they are in
+    using PROVINCE_SET = ProvinceSet;
+    using PROVINCE_TO_PROVINCE_MAP = std::map<PROVINCE_INDEX, PROVINCE_INDEX>;
+    using COAST_SET = std::set<COAST_ID>;
+
+    using UNIT_AND_ORDER = struct {
+        // Location of the unit
+        COAST_ID coast_id;                          // Coast of the unit's location
+        POWER_INDEX nationality;                    // Nationality of the unit
+        Token unit_type;                            // The type of unit
+
+        // Order for the unit
+        ORDER_TYPE order_type;                      // Type of order given to unit
+        COAST_ID move_dest;                         // Destination to move to (normal or via convoy)
+        PROVINCE_INDEX other_source_province;       // Province support or convoy is from (if moving)
+                                                    // (i.e. province containing supported unit)
+        PROVINCE_INDEX other_dest_province;         // Province support or convoy is to (or is holding in)
+        UNIT_LIST convoy_step_list;                 // List of fleets that the convoy uses
+
+        // Results flags
+        bool no_convoy;                             // Convoy order was not provided by necessary fleets
+        bool no_army_to_convoy;                     // Army not ordered to use the convoy or fleets broke the route
+        bool convoy_broken;                         // A convoying fleet was dislodged so the convoy failed
+        bool support_void;                          // The support order did not match the order of the supp. unit
+        bool support_cut;                           // The support order was cut by an attack
+        bool bounce;                                // The move bounced
+        bool dislodged;                             // The unit was dislodged
+        bool unit_moves;                            // The unit moves successfully
+        bool illegal_order;                         // Order illegal - only possible in AOA game
+        Token illegal_reason;                       // Reason that order was illegal
+        PROVINCE_INDEX dislodged_from;              // Province the unit was dislodged from
+
+        // Retreat options
+        COAST_SET retreat_options;                  // Locations where the unit can retreat to
+    };
+
+    // Flags for the outcome of a unit's order, one for each of the results flags of UNIT_AND_ORDER
+    enum {
+        RESULT_MOVES = 0x01,
+        RESULT_BOUNCE = 0x02,
+        RESULT_DISLODGED = 0x04,
+        RESULT_SUPPORT_CUT = 0x08,
+        RESULT_SUPPORT_VOID = 0x10,
+        RESULT_NO_CONVOY = 0x20,
+        RESULT_CONVOY_BROKEN = 0x40,
+        RESULT_NO_ARMY_TO_CONVOY = 0x80,
+        RESULT_ILLEGAL = 0x100
+    };
+
+    enum { MAX_RETREAT_OPTIONS = 32 };
+
+    // The outcome of a unit's order in a movement turn, as a flat record which is written without building any
+    // TokenMessages. The retreat options have a bit for each coast adjacent to the unit's coast, in the order of
+    // MapTopology::get_coast_adjacencies(), for the first MAX_RETREAT_OPTIONS of them.
+    using UNIT_RESULT = struct {
+        int16_t province;                           // Province the unit is in
+        int16_t location;                           // Coast index of where the unit ends up, if not dislodged
+        int16_t dislodged_from;                     // Province of the unit which dislodged it (NO_PROVINCE if none)
+        uint16_t flags;                             // RESULT_... flags
+        Token illegal_reason;                       // Reason the order was illegal, if RESULT_ILLEGAL is set
+        uint32_t retreat_options;                   // Where the unit can retreat to, if dislodged
+    };
+
+    // The coasts adjacent to a given coast
+    using COAST_DETAILS = struct {
+        COAST_SET adjacent_coasts;
+    };
+
+    // The set of coasts in a province, keyed on the Coast Token
+    // (may be TOKEN_COAST_..., TOKEN_UNIT_FLT or TOKEN_UNIT_AMY) - see COAST_ID above
+    using PROVINCE_COASTS = std::map<Token, COAST_DETAILS>;
+
+    // The set of powers for which a given province is a home centre
+    using HOME_CENTRE_SET = std::set<POWER_INDEX>;
+
+    // The details of a province
+    using PROVINCE_DETAILS = struct {
+        Token province_token;
+        bool province_in_use;
+        bool is_supply_centre;
+        bool is_land;
+        PROVINCE_COASTS coast_info;
+        HOME_CENTRE_SET home_centre_set;
+        Token initial_owner;                        // Owner of the centre in the MDF (UNO if not a centre)
+    };
+
+    // The collection of all units, keyed on the province in which the unit is located
+    using UNITS = ProvinceMap<UNIT_AND_ORDER>;
+
+    // Map of build or disband orders against result token (SUC or failure reason)
+    using BUILDS_OR_DISBANDS = std::map<COAST_ID, Token>;
+
+    // The winter orders for one power
+    using WINTER_ORDERS_FOR_POWER = struct {
+        BUILDS_OR_DISBANDS builds_or_disbands;
+        int number_of_waives;
+        int number_of_orders_required;
+        bool is_building;
+    };
+
+    using WINTER_ORDERS = std::map<POWER_INDEX, WINTER_ORDERS_FOR_POWER> ;
+};
+
+static_assert(static_cast<int>(ProvinceSet::CAPACITY) == static_cast<int>(MapTypes::MAX_PROVINCES),
+              "A ProvinceSet must be able to hold every province");
+
+} // namespace DAIDE
+
+#endif // _DAIDE_CLIENT_DAIDE_CLIENT_MAP_TYPES_H
@@ -0,0 +1,294 @@
+/**
+ * Diplomacy AI Client - Part of the DAIDE project.
+ *
+ * Metrics Registry and the loopback HTTP listener which serves it.
+ *
+ * Release 8~3
+ **/
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "daide_client/error_log.h"
+#include "daide_client/metrics.h"
+
+using DAIDE::MetricsHistogram;
+using DAIDE::MetricsRegistry;
+using DAIDE::MetricsServer;
+
+MetricsHistogram::MetricsHistogram(const BUCKET_BOUNDS &upper_bounds)
+    : m_upper_bounds(upper_bounds), m_bucket_counts(new std::atomic<uint64_t>[upper_bounds.size() + 1]) {
+
+    std::sort(m_upper_bounds.begin(), m_upper_bounds.end());
+    for (size_t bucket = 0; bucket <= m_upper_bounds.size(); bucket++) {
+        m_bucket_counts[bucket].store(0);
+    }
+}
+
+void MetricsHistogram::observe(double value) {
+    size_t bucket = std::lower_bound(m_upper_bounds.begin(), m_upper_bounds.end(), value) - m_upper_bounds.begin();
+    m_bucket_counts[bucket].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+
+    double sum = m_sum.load(std::memory_order_relaxed);
+    while (!m_sum.compare_exchange_weak(sum, sum + value, std::memory_order_relaxed)) {}
+}
+
+void MetricsHistogram::add_and_clear(MetricsHistogram &other) {
+    for (size_t bucket = 0; bucket <= m_upper_bounds.size(); bucket++) {
+        m_bucket_counts[bucket].fetch_add(other.m_bucket_counts[bucket].exchange(0, std::memory_order_relaxed),
+                                          std::memory_order_relaxed);
+    }
+    m_count.fetch_add(other.m_count.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+
+    double other_sum = other.m_sum.exchange(0.0, std::memory_order_relaxed);
+    double sum = m_sum.load(std::memory_order_relaxed);
+    while (!m_sum.compare_exchange_weak(sum, sum + other_sum, std::memory_order_relaxed)) {}
+}
+
+const MetricsHistogram::BUCKET_BOUNDS &MetricsHistogram::latency_buckets() {
+    static const BUCKET_BOUNDS buckets {0.00001, 0.00005, 0.0001, 0.0005, 0.001, 0.005, 0.01, 0.05, 0.1, 0.5, 1, 5, 10};
+    return buckets;
+}
+
+MetricsRegistry *MetricsRegistry::instance() {
+    // Never destroyed, so metrics can still be updated by the destructors of other statics, e.g. a bot closing its
+    // socket at exit
+    static MetricsRegistry *registry = new MetricsRegistry;
+    return registry;
+}
+
+DAIDE::MetricsCounter &MetricsRegistry::counter(const std::string &name, const std::string &help) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    METRIC<MetricsCounter> &entry = m_counters[name];
+
+    if (!entry.metric) {
+        entry.help = help;
+        entry.metric.reset(new MetricsCounter);
+    }
+    return *entry.metric;
+}
+
+DAIDE::MetricsGauge &MetricsRegistry::gauge(const std::string &name, const std::string &help) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    METRIC<MetricsGauge> &entry = m_gauges[name];
+
+    if (!entry.metric) {
+        entry.help = help;
+        entry.metric.reset(new MetricsGauge);
+    }
+    return *entry.metric;
+}
+
+MetricsHistogram &MetricsRegistry::histogram(const std::string &name, const std::string &help,
+                                             const MetricsHistogram::BUCKET_BOUNDS &upper_bounds) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    METRIC<MetricsHistogram> &entry = m_histograms[name];
+
+    if (!entry.metric) {
+        entry.help = help;
+        entry.metric.reset(new MetricsHistogram(upper_bounds));
+    }
+    return *entry.metric;
+}
+
+std::string MetricsRegistry::render_prometheus_text() const {
+    std::ostringstream text;
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    for (const auto &counter : m_counters) {
+        text << "# HELP " << counter.first << " " << counter.second.help << "\n"
+             << "# TYPE " << counter.first << " counter\n"
+             << counter.first << " " << counter.second.metric->get_value() << "\n";
+    }
+
+    for (const auto &gauge : m_gauges) {
+        text << "# HELP " << gauge.first << " " << gauge.second.help << "\n"
+             << "# TYPE " << gauge.first << " gauge\n"
+             << gauge.first << " " << gauge.second.metric->get_value() << "\n";
+    }
+
+    for (const auto &histogram_itr : m_histograms) {
+        const MetricsHistogram &histogram = *histogram_itr.second.metric;
+        const MetricsHistogram::BUCKET_BOUNDS &upper_bounds = histogram.get_upper_bounds();
+        uint64_t cumulative_count {0};
+
+        text << "# HELP " << histogram_itr.first << " " << histogram_itr.second.help << "\n"
+             << "# TYPE " << histogram_itr.first << " histogram\n";
+
+        for (size_t bucket = 0; bucket < upper_bounds.size(); bucket++) {
+            cumulative_count += histogram.get_bucket_count(bucket);
+            text << histogram_itr.first << "_bucket{le=\"" << upper_bounds[bucket] << "\"} "
+                 << cumulative_count << "\n";
+        }
+        cumulative_count += histogram.get_bucket_count(upper_bounds.size());
+
+        text << histogram_itr.first << "_bucket{le=\"+Inf\"} " << cumulative_count << "\n"
+             << histogram_itr.first << "_sum " << histogram.get_sum() << "\n"
+             << histogram_itr.first << "_count " << cumulative_count << "\n";
+    }
+
+    return text.str();
+}
+
+MetricsServer::~MetricsServer() {
+    stop();
+}
+
+bool MetricsServer::start(uint16_t port) {
+    struct sockaddr_in address {};
+    int reuse_address {1};
+
+    stop();
+
+    m_listen_socket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (m_listen_socket < 0) {
+        int error = WSAGetLastError();
+        log_error("Failure %d creating metrics socket: %s", error, strerror(error));
+        m_listen_socket = -1;
+        return false;
+    }
+
+    setsockopt(m_listen_socket, SOL_SOCKET, SO_REUSEADDR, &reuse_address, sizeof(reuse_address));
+    fcntl(m_listen_socket, F_SETFL, fcntl(m_listen_socket, F_GETFL, 0) | O_NONBLOCK);
+
+    // Loopback only. The metrics are not meant to be reachable from other machines.
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    if (bind(m_listen_socket, reinterpret_cast<sockaddr *>(&address), sizeof(address))
+        || listen(m_listen_socket, SOMAXCONN)) {
+
+        int error = WSAGetLastError();
+        log_error("Failure %d listening for metrics on port %d: %s", error, port, strerror(error));
+        stop();
+        return false;
+    }
+
+    log("Serving metrics on 127.0.0.1:%d", port);
+    return true;
+}
+
+void MetricsServer::stop() {
+    for (auto &pending_request : m_pending_requests) {
+        close(pending_request.socket);
+    }
+    m_pending_requests.clear();
+
+    if (m_listen_socket >= 0) {
+        close(m_listen_socket);
+        m_listen_socket = -1;
+    }
+}
+
+bool MetricsServer::wait_for_socket(SOCKET socket) {
+    fd_set readable_sockets;
+    SOCKET highest_socket {socket};
+
+    if (!is_listening()) {
+        return true;
+    }
+
+    FD_ZERO(&readable_sockets);
+    FD_SET(socket, &readable_sockets);
+    FD_SET(m_listen_socket, &readable_sockets);
+    highest_socket = std::max(highest_socket, m_listen_socket);
+
+    for (const auto &pending_request : m_pending_requests) {
+        FD_SET(pending_request.socket, &readable_sockets);
+        highest_socket = std::max(highest_socket, pending_request.socket);
+    }
+
+    if (select(highest_socket + 1, &readable_sockets, nullptr, nullptr, nullptr) < 0) {
+        // Interrupted. Let the caller try the socket, which will report any real error.
+        return true;
+    }
+
+    if (FD_ISSET(m_listen_socket, &readable_sockets)) {
+        accept_connections();
+    }
+    serve_pending_requests(readable_sockets);
+
+    return FD_ISSET(socket, &readable_sockets) != 0;
+}
+
+void MetricsServer::accept_connections() {
+    SOCKET connection {-1};
+
+    while ((connection = accept(m_listen_socket, nullptr, nullptr)) >= 0) {
+        if (connection >= FD_SETSIZE) {
+            close(connection);
+            continue;
+        }
+        fcntl(connection, F_SETFL, fcntl(connection, F_GETFL, 0) | O_NONBLOCK);
+        m_pending_requests.push_back(PENDING_REQUEST {connection, std::string()});
+    }
+}
+
+void MetricsServer::serve_pending_requests(const fd_set &readable_sockets) {
+    const size_t MAX_REQUEST_LENGTH = 8192;        // Anything longer is not a scrape
+    char buffer[1024];
+
+    auto request_itr = m_pending_requests.begin();
+    while (request_itr != m_pending_requests.end()) {
+        bool finished {false};
+
+        if (FD_ISSET(request_itr->socket, &readable_sockets)) {
+            ssize_t received = recv(request_itr->socket, buffer, sizeof(buffer), 0);
+
+            if (received > 0) {
+                request_itr->request.append(buffer, static_cast<size_t>(received));
+
+                // Only the request line matters; answer once the headers are complete
+                if (request_itr->request.find("\r\n\r\n") != std::string::npos
+                    || request_itr->request.find("\n\n") != std::string::npos) {
+
+                    if (request_itr->request.compare(0, 4, "GET ") == 0) {
+                        std::string body = MetricsRegistry::instance()->render_prometheus_text();
+                        send_response(request_itr->socket,
+                                      "HTTP/1.0 200 OK\r\n"
+                                      "Content-Type: text/plain; version=0.0.4\r\n"
+                                      "Content-Length: " + std::to_string(body.size()) + "\r\n"
+                                      "Connection: close\r\n\r\n" + body);
+                    } else {
+                        send_response(request_itr->socket,
+                                      "HTTP/1.0 405 Method Not Allowed\r\nConnection: close\r\n\r\n");
+                    }
+                    finished = true;
+
+                } else if (request_itr->request.size() > MAX_REQUEST_LENGTH) {
+                    finished = true;
+                }
+
+            } else if ((received == 0) || (WSAGetLastError() != EAGAIN && WSAGetLastError() != EWOULDBLOCK)) {
+                finished = true;
+            }
+        }
+
+        if (finished) {
+            close(request_itr->socket);
+            request_itr = m_pending_requests.erase(request_itr);
+        } else {
+            request_itr++;
+        }
+    }
+}
+
+void MetricsServer::send_response(SOCKET socket, const std::string &response) {
+    size_t sent_length {0};
+
+    // The response is small, so it normally goes in one call. Give up rather than block if the scraper is slow.
+    while (sent_length < response.size()) {
+        ssize_t sent = send(socket, response.data() + sent_length, response.size() - sent_length, MSG_NOSIGNAL);
+        if (sent <= 0) { break; }
+        sent_length += static_cast<size_t>(sent);
+    }
+}
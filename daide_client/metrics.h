@@ -0,0 +1,178 @@
+/**
+ * Diplomacy AI Client - Part of the DAIDE project.
+ *
+ * Metrics Registry. Counters, gauges and histograms which can be scraped in the Prometheus text format, either by
+ * calling render_prometheus_text() or through the MetricsServer, a loopback HTTP listener serviced from the main
+ * message loop.
+ *
+ * All metric updates are lock-free, so they may be made from any thread.
+ *
+ * Release 8~3
+ **/
+
+#ifndef _DAIDE_CLIENT_DAIDE_CLIENT_METRICS_H
+#define _DAIDE_CLIENT_DAIDE_CLIENT_METRICS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <sys/select.h>
+
+#include "daide_client/windaide_symbols.h"
+
+namespace DAIDE {
+
+// A value which only ever goes up
+class MetricsCounter {
+public:
+    void increment(uint64_t amount = 1) { m_value.fetch_add(amount, std::memory_order_relaxed); }
+
+    uint64_t get_value() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> m_value {0};
+};
+
+// A value which can go up and down
+class MetricsGauge {
+public:
+    void set(int64_t value) { m_value.store(value, std::memory_order_relaxed); }
+
+    void increment(int64_t amount = 1) { m_value.fetch_add(amount, std::memory_order_relaxed); }
+
+    void decrement(int64_t amount = 1) { m_value.fetch_sub(amount, std::memory_order_relaxed); }
+
+    int64_t get_value() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<int64_t> m_value {0};
+};
+
+// A distribution of observed values (usually durations in seconds), counted into fixed buckets
+class MetricsHistogram {
+public:
+    using BUCKET_BOUNDS = std::vector<double>;
+
+    explicit MetricsHistogram(const BUCKET_BOUNDS &upper_bounds);
+
+    void observe(double value);
+
+    // Add in the observations of a histogram with the same buckets, then clear that one. A thread which observes
+    // often can keep its own histogram and add it to the shared one now and again, rather than contend for it.
+    void add_and_clear(MetricsHistogram &other);
+
+    const BUCKET_BOUNDS &get_upper_bounds() const { return m_upper_bounds; }
+
+    // Count of observations in the given bucket (not cumulative). The last bucket is +Inf.
+    uint64_t get_bucket_count(size_t bucket) const { return m_bucket_counts[bucket].load(std::memory_order_relaxed); }
+
+    uint64_t get_count() const { return m_count.load(std::memory_order_relaxed); }
+
+    double get_sum() const { return m_sum.load(std::memory_order_relaxed); }
+
+    // Default buckets for latencies, from 10 microseconds to 10 seconds
+    static const BUCKET_BOUNDS &latency_buckets();
+
+private:
+    BUCKET_BOUNDS m_upper_bounds;
+    std::unique_ptr<std::atomic<uint64_t>[]> m_bucket_counts;
+    std::atomic<uint64_t> m_count {0};
+    std::atomic<double> m_sum {0.0};
+};
+
+// Times the lifetime of the object into a histogram
+class MetricsTimer {
+public:
+    explicit MetricsTimer(MetricsHistogram &histogram)
+        : m_histogram(histogram), m_start(std::chrono::steady_clock::now()) {}
+
+    MetricsTimer(const MetricsTimer &other) = delete;
+    MetricsTimer& operator=(const MetricsTimer &other) = delete;
+
+    ~MetricsTimer() {
+        m_histogram.observe(std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count());
+    }
+
+private:
+    MetricsHistogram &m_histogram;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+// The registry of all metrics in the process. Metrics are created on first use and are never destroyed, so callers
+// should look them up once and keep the reference, e.g. in a function-local static.
+class MetricsRegistry {
+public:
+    static MetricsRegistry *instance();
+
+    MetricsCounter &counter(const std::string &name, const std::string &help);
+
+    MetricsGauge &gauge(const std::string &name, const std::string &help);
+
+    MetricsHistogram &histogram(const std::string &name, const std::string &help,
+                                const MetricsHistogram::BUCKET_BOUNDS &upper_bounds
+                                    = MetricsHistogram::latency_buckets());
+
+    // All metrics, in the Prometheus text exposition format (version 0.0.4)
+    std::string render_prometheus_text() const;
+
+private:
+    template <typename T>
+    struct METRIC {
+        std::string help;
+        std::unique_ptr<T> metric;
+    };
+
+    MetricsRegistry() = default;
+
+    mutable std::mutex m_mutex;
+    std::map<std::string, METRIC<MetricsCounter>> m_counters;
+    std::map<std::string, METRIC<MetricsGauge>> m_gauges;
+    std::map<std::string, METRIC<MetricsHistogram>> m_histograms;
+};
+
+// Serves the registry over HTTP on a loopback port. Non-blocking: it is driven by the main message loop through
+// wait_for_socket(), so no extra thread is needed.
+class MetricsServer {
+public:
+    MetricsServer() = default;
+    MetricsServer(const MetricsServer &other) = delete;
+    MetricsServer& operator=(const MetricsServer &other) = delete;
+    ~MetricsServer();
+
+    // Start listening on 127.0.0.1:port. Returns false if the port could not be bound.
+    bool start(uint16_t port);
+
+    void stop();
+
+    bool is_listening() const { return m_listen_socket >= 0; }
+
+    // Wait until the given socket is readable, serving any scrape requests which arrive meanwhile.
+    // Returns true if the socket is readable. If the server is not listening, returns true immediately.
+    bool wait_for_socket(SOCKET socket);
+
+private:
+    using PENDING_REQUEST = struct {
+        SOCKET socket;
+        std::string request;
+    };
+
+    void accept_connections();
+
+    // Read and answer whatever scrape requests are ready, without blocking
+    void serve_pending_requests(const fd_set &readable_sockets);
+
+    static void send_response(SOCKET socket, const std::string &response);
+
+    SOCKET m_listen_socket {-1};
+    std::vector<PENDING_REQUEST> m_pending_requests;
+};
+
+} // namespace DAIDE
+
+#endif // _DAIDE_CLIENT_DAIDE_CLIENT_METRICS_H
@@ -0,0 +1,379 @@
+/**
+ * Diplomacy AI Client - Part of the DAIDE project.
+ *
+ * Order Generator. Lists every legal order for every unit in a position.
+ *
+ * Release 8~3
+ **/
+
+#include <algorithm>
+
+#include "daide_client/order_generator.h"
+
+using DAIDE::LegalOrders;
+using DAIDE::MapAndUnits;
+using DAIDE::OrderGenerator;
+
+bool LegalOrders::set_order(MapAndUnits *map_and_units, const UNIT_ORDERS &unit, const LEGAL_ORDER &order) const {
+    bool unit_ordered {false};
+
+    switch (order.order_type) {
+        case HOLD_ORDER:
+            unit_ordered = map_and_units->set_hold_order(unit.unit);
+            break;
+
+        case MOVE_ORDER:
+            unit_ordered = map_and_units->set_move_order(unit.unit, topology->get_coast(order.destination));
+            break;
+
+        case SUPPORT_TO_HOLD_ORDER:
+            unit_ordered = map_and_units->set_support_to_hold_order(unit.unit, order.other_source_province);
+            break;
+
+        case SUPPORT_TO_MOVE_ORDER:
+            unit_ordered = map_and_units->set_support_to_move_order(unit.unit,
+                                                                    order.other_source_province,
+                                                                    order.other_dest_province);
+            break;
+
+        case CONVOY_ORDER:
+            unit_ordered = map_and_units->set_convoy_order(unit.unit,
+                                                           order.other_source_province,
+                                                           order.other_dest_province);
+            break;
+
+        case MOVE_BY_CONVOY_ORDER:
+            unit_ordered = map_and_units->set_move_by_convoy_order(unit.unit,
+                                                                   topology->get_coast(order.destination).province_index,
+                                                                   order.number_of_steps,
+                                                                   convoy_steps.data() + order.first_step);
+            break;
+
+        case RETREAT_ORDER:
+            unit_ordered = map_and_units->set_retreat_order(unit.unit, topology->get_coast(order.destination));
+            break;
+
+        case DISBAND_ORDER:
+            unit_ordered = (season == TOKEN_SEASON_WIN) ? map_and_units->set_remove_order(unit.unit)
+                                                        : map_and_units->set_disband_order(unit.unit);
+            break;
+
+        default:
+            break;
+    }
+    return unit_ordered;
+}
+
+void LegalOrders::clear(int number_of_powers) {
+    orders.clear();
+    unit_orders.clear();
+    convoy_steps.clear();
+    build_locations.clear();
+
+    power_first_unit.assign(number_of_powers + 1, 0);
+    power_builds.assign(number_of_powers, 0);
+    power_first_build_location.assign(number_of_powers + 1, 0);
+}
+
+OrderGenerator::OrderGenerator() : cache(CACHE_SIZE) {}
+
+const LegalOrders &OrderGenerator::generate(const MapAndUnits &map_and_units) {
+    uint64_t position_key = get_position_key(map_and_units);
+    LegalOrders &legal_orders = cache[position_key % CACHE_SIZE];
+
+    // Already generated
+    if ((legal_orders.topology == map_and_units.get_topology()) && (legal_orders.position_key == position_key)) {
+        return legal_orders;
+    }
+
+    topology = map_and_units.get_topology();
+    legal_orders.topology = topology;
+    legal_orders.position_key = position_key;
+    legal_orders.season = map_and_units.current_season;
+    legal_orders.clear(map_and_units.number_of_powers);
+
+    if ((map_and_units.current_season == TOKEN_SEASON_SPR) || (map_and_units.current_season == TOKEN_SEASON_FAL)) {
+        generate_movement_orders(map_and_units, &legal_orders);
+    } else if ((map_and_units.current_season == TOKEN_SEASON_SUM)
+               || (map_and_units.current_season == TOKEN_SEASON_AUT)) {
+        generate_retreat_orders(map_and_units, &legal_orders);
+    } else if (map_and_units.current_season == TOKEN_SEASON_WIN) {
+        generate_adjustment_orders(map_and_units, &legal_orders);
+    }
+
+    topology = nullptr;
+    return legal_orders;
+}
+
+void OrderGenerator::clear() {
+    for (LegalOrders &legal_orders : cache) {
+        legal_orders.topology = nullptr;
+    }
+}
+
+void OrderGenerator::generate_movement_orders(const MapAndUnits &map_and_units, LegalOrders *legal_orders) {
+    const UNITS &units = map_and_units.units;
+
+    // Find where each unit can move to, and where each army can be convoyed to
+    convoyable_armies.clear();
+    for (auto &unit : units) {
+        COAST_INDEX unit_coast = topology->get_coast_index(unit.second.coast_id);
+
+        unit_coasts[unit.first] = unit_coast;
+        reachable_provinces[unit.first].clear();
+        if (unit_coast != NO_COAST) {
+            for (COAST_INDEX adjacent_coast : topology->get_coast_adjacencies(unit_coast)) {
+                reachable_provinces[unit.first].insert(topology->get_coast(adjacent_coast).province_index);
+            }
+        }
+
+        if (unit.second.unit_type == TOKEN_UNIT_AMY) {
+            find_convoy_routes(map_and_units, unit.first);
+            if (!convoy_destinations[unit.first].empty()) { convoyable_armies.push_back(unit.first); }
+        }
+    }
+
+    for (POWER_INDEX power_ctr = 0; power_ctr < map_and_units.number_of_powers; power_ctr++) {
+        legal_orders->power_first_unit[power_ctr] = static_cast<int>(legal_orders->unit_orders.size());
+
+        for (auto &unit : units) {
+            PROVINCE_INDEX unit_province = unit.first;
+            COAST_INDEX unit_coast = unit_coasts[unit_province];
+            bool is_fleet_at_sea = !map_and_units.game_map[unit_province].is_land;
+
+            if (unit.second.nationality != power_ctr) { continue; }
+
+            legal_orders->unit_orders.push_back(LegalOrders::UNIT_ORDERS {
+                    unit_province, power_ctr, static_cast<int>(legal_orders->orders.size()), 0});
+
+            add_order(legal_orders, HOLD_ORDER, NO_COAST, NO_PROVINCE, NO_PROVINCE);
+
+            if (unit_coast != NO_COAST) {
+                for (COAST_INDEX adjacent_coast : topology->get_coast_adjacencies(unit_coast)) {
+                    add_order(legal_orders, MOVE_ORDER, adjacent_coast, NO_PROVINCE, NO_PROVINCE);
+                }
+            }
+
+            // Moves by convoy
+            if ((unit.second.unit_type == TOKEN_UNIT_AMY) && !convoy_destinations[unit_province].empty()) {
+                find_convoy_routes(map_and_units, unit_province);
+
+                for (PROVINCE_INDEX destination : convoy_destinations[unit_province]) {
+                    int number_of_steps {0};
+
+                    for (PROVINCE_INDEX step = convoy_route_parent[destination];
+                         step != NO_PROVINCE;
+                         step = convoy_route_parent[step]) {
+                        route_steps[number_of_steps++] = step;
+                    }
+
+                    add_order(legal_orders, MOVE_BY_CONVOY_ORDER,
+                              topology->get_coast_index(COAST_ID {destination, TOKEN_UNIT_AMY}),
+                              NO_PROVINCE, NO_PROVINCE);
+
+                    LegalOrders::LEGAL_ORDER &order = legal_orders->orders.back();
+                    order.first_step = static_cast<int>(legal_orders->convoy_steps.size());
+                    order.number_of_steps = number_of_steps;
+                    for (int step_ctr = number_of_steps - 1; step_ctr >= 0; step_ctr--) {
+                        legal_orders->convoy_steps.push_back(route_steps[step_ctr]);
+                    }
+                }
+            }
+
+            // Supports, into the provinces the unit could move to
+            for (PROVINCE_INDEX destination : reachable_provinces[unit_province]) {
+                if (units.count(destination) != 0) {
+                    add_order(legal_orders, SUPPORT_TO_HOLD_ORDER, NO_COAST, destination, destination);
+                }
+
+                for (auto &supported_unit : units) {
+                    PROVINCE_INDEX supported_province = supported_unit.first;
+                    bool can_reach {false};
+
+                    if ((supported_province == unit_province) || (supported_province == destination)) { continue; }
+
+                    if (reachable_provinces[supported_province].contains(destination)) {
+                        can_reach = true;
+
+                    // A fleet cannot support a convoyed move which needs its own convoy
+                    } else if (convoy_destinations[supported_province].contains(destination)
+                               && (supported_unit.second.unit_type == TOKEN_UNIT_AMY)) {
+                        can_reach = !is_fleet_at_sea
+                                    || !convoy_fleets[supported_province].contains(unit_province)
+                                    || map_and_units.has_route_to_province(&(supported_unit.second),
+                                                                           destination, unit_province);
+                    }
+
+                    if (can_reach) {
+                        add_order(legal_orders, SUPPORT_TO_MOVE_ORDER, NO_COAST, supported_province, destination);
+                    }
+                }
+            }
+
+            // Convoys
+            if (is_fleet_at_sea) {
+                for (PROVINCE_INDEX army : convoyable_armies) {
+                    if (!convoy_fleets[army].contains(unit_province)) { continue; }
+
+                    for (PROVINCE_INDEX destination : convoy_destinations[army]) {
+                        add_order(legal_orders, CONVOY_ORDER, NO_COAST, army, destination);
+                    }
+                }
+            }
+        }
+    }
+
+    legal_orders->power_first_unit[map_and_units.number_of_powers] = static_cast<int>(legal_orders->unit_orders.size());
+
+    // Leave the convoy data empty for the next position
+    for (auto &unit : units) {
+        convoy_destinations[unit.first].clear();
+        convoy_fleets[unit.first].clear();
+    }
+}
+
+void OrderGenerator::generate_retreat_orders(const MapAndUnits &map_and_units, LegalOrders *legal_orders) {
+    for (POWER_INDEX power_ctr = 0; power_ctr < map_and_units.number_of_powers; power_ctr++) {
+        legal_orders->power_first_unit[power_ctr] = static_cast<int>(legal_orders->unit_orders.size());
+
+        for (auto &dislodged_unit : map_and_units.dislodged_units) {
+            if (dislodged_unit.second.nationality != power_ctr) { continue; }
+
+            legal_orders->unit_orders.push_back(LegalOrders::UNIT_ORDERS {
+                    dislodged_unit.first, power_ctr, static_cast<int>(legal_orders->orders.size()), 0});
+
+            for (const COAST_ID &retreat_option : dislodged_unit.second.retreat_options) {
+                COAST_INDEX destination = topology->get_coast_index(retreat_option);
+                if (destination != NO_COAST) {
+                    add_order(legal_orders, RETREAT_ORDER, destination, NO_PROVINCE, NO_PROVINCE);
+                }
+            }
+            add_order(legal_orders, DISBAND_ORDER, NO_COAST, NO_PROVINCE, NO_PROVINCE);
+        }
+    }
+
+    legal_orders->power_first_unit[map_and_units.number_of_powers] = static_cast<int>(legal_orders->unit_orders.size());
+}
+
+void OrderGenerator::generate_adjustment_orders(const MapAndUnits &map_and_units, LegalOrders *legal_orders) {
+    for (POWER_INDEX power_ctr = 0; power_ctr < map_and_units.number_of_powers; power_ctr++) {
+        Token power(CATEGORY_POWER, static_cast<BYTE>(power_ctr));
+        int number_of_centres {0};
+        int number_of_units {0};
+
+        legal_orders->power_first_unit[power_ctr] = static_cast<int>(legal_orders->unit_orders.size());
+        legal_orders->power_first_build_location[power_ctr] = static_cast<int>(legal_orders->build_locations.size());
+
+        for (PROVINCE_INDEX province_ctr = 0; province_ctr < map_and_units.number_of_provinces; province_ctr++) {
+            if (map_and_units.game_map[province_ctr].is_supply_centre
+                && (map_and_units.province_owner[province_ctr] == power)) {
+                number_of_centres++;
+            }
+        }
+        for (auto &unit : map_and_units.units) {
+            if (unit.second.nationality == power_ctr) { number_of_units++; }
+        }
+
+        legal_orders->power_builds[power_ctr] = number_of_centres - number_of_units;
+
+        // Builds, on every coast of each empty home centre still owned
+        if (number_of_centres > number_of_units) {
+            for (PROVINCE_INDEX province_ctr = 0; province_ctr < map_and_units.number_of_provinces; province_ctr++) {
+                const PROVINCE_DETAILS &province = map_and_units.game_map[province_ctr];
+
+                if ((province.home_centre_set.count(power_ctr) != 0)
+                    && (map_and_units.province_owner[province_ctr] == power)
+                    && (map_and_units.units.count(province_ctr) == 0)) {
+
+                    for (COAST_INDEX coast_ctr = topology->get_first_coast(province_ctr);
+                         coast_ctr < topology->get_end_coast(province_ctr);
+                         coast_ctr++) {
+                        legal_orders->build_locations.push_back(coast_ctr);
+                    }
+                }
+            }
+
+        // Removals
+        } else if (number_of_centres < number_of_units) {
+            for (auto &unit : map_and_units.units) {
+                if (unit.second.nationality != power_ctr) { continue; }
+
+                legal_orders->unit_orders.push_back(LegalOrders::UNIT_ORDERS {
+                        unit.first, power_ctr, static_cast<int>(legal_orders->orders.size()), 0});
+                add_order(legal_orders, DISBAND_ORDER, NO_COAST, NO_PROVINCE, NO_PROVINCE);
+            }
+        }
+    }
+
+    legal_orders->power_first_unit[map_and_units.number_of_powers] = static_cast<int>(legal_orders->unit_orders.size());
+    legal_orders->power_first_build_location[map_and_units.number_of_powers]
+            = static_cast<int>(legal_orders->build_locations.size());
+}
+
+void OrderGenerator::find_convoy_routes(const MapAndUnits &map_and_units, PROVINCE_INDEX army) {
+    PROVINCE_SET &destinations = convoy_destinations[army];
+    PROVINCE_SET &fleets = convoy_fleets[army];
+    PROVINCE_SET queued_provinces {};
+    PROVINCE_INDEX provinces_to_check[MAX_PROVINCES];
+    int first_to_check {0};
+    int number_to_check {0};
+
+    destinations.clear();
+    fleets.clear();
+    queued_provinces.insert(army);
+
+    // Start from the occupied seas next to the army. Searching in the order provinces are found gives the shortest
+    // route to each destination.
+    for (PROVINCE_INDEX adjacent_province : topology->get_province_adjacencies(army)) {
+        if (!map_and_units.game_map[adjacent_province].is_land && (map_and_units.units.count(adjacent_province) != 0)) {
+            queued_provinces.insert(adjacent_province);
+            convoy_route_parent[adjacent_province] = NO_PROVINCE;
+            provinces_to_check[number_to_check++] = adjacent_province;
+        }
+    }
+
+    while (first_to_check < number_to_check) {
+        PROVINCE_INDEX fleet_province = provinces_to_check[first_to_check++];
+        fleets.insert(fleet_province);
+
+        for (PROVINCE_INDEX adjacent_province : topology->get_province_adjacencies(fleet_province)) {
+            if (queued_provinces.contains(adjacent_province)) { continue; }
+
+            if (map_and_units.game_map[adjacent_province].is_land) {
+                queued_provinces.insert(adjacent_province);
+                convoy_route_parent[adjacent_province] = fleet_province;
+                destinations.insert(adjacent_province);
+
+            } else if (map_and_units.units.count(adjacent_province) != 0) {
+                queued_provinces.insert(adjacent_province);
+                convoy_route_parent[adjacent_province] = fleet_province;
+                provinces_to_check[number_to_check++] = adjacent_province;
+            }
+        }
+    }
+}
+
+void OrderGenerator::add_order(LegalOrders *legal_orders,
+                               ORDER_TYPE order_type,
+                               COAST_INDEX destination,
+                               PROVINCE_INDEX other_source_province,
+                               PROVINCE_INDEX other_dest_province) {
+    legal_orders->orders.push_back(LegalOrders::LEGAL_ORDER {
+            order_type, destination, other_source_province, other_dest_province, 0, 0});
+    legal_orders->unit_orders.back().number_of_orders++;
+}
+
+uint64_t OrderGenerator::get_position_key(const MapAndUnits &map_and_units) {
+    uint64_t position_key = map_and_units.get_position_hash();
+
+    for (auto &dislodged_unit : map_and_units.dislodged_units) {
+        uint64_t options_key = static_cast<uint64_t>(dislodged_unit.first);
+
+        for (const COAST_ID &retreat_option : dislodged_unit.second.retreat_options) {
+            options_key = MapTopology::mix_hash(options_key ^ ((static_cast<uint64_t>(retreat_option.province_index) << 16)
+                                                               | retreat_option.coast_token.get_token()));
+        }
+        position_key ^= MapTopology::mix_hash(options_key);
+    }
+    return position_key;
+}
@@ -0,0 +1,188 @@
+/**
+ * Diplomacy AI Client - Part of the DAIDE project.
+ *
+ * Order Generator. Lists every legal order for every unit in a position, for use by bots which search over orders.
+ *
+ * In a movement turn each unit may hold, move to an adjacent coast, support a unit to hold or to move into a province
+ * it can move to itself, and (a fleet at sea) convoy an army along a chain of fleets. Each army may also move by
+ * convoy to any land province the fleets at sea can carry it to, with the shortest chain of fleets as its route.
+ * In a retreat turn each dislodged unit may retreat to any of its retreat options, or disband. In an adjustment turn
+ * each power is given its number of builds and the coasts it can build on, or (if it must remove units) a remove
+ * order for each of its units.
+ *
+ * The orders are held in a few flat arrays which are reused from position to position, and the results for recent
+ * positions are kept, keyed on the position hash.
+ *
+ * Release 8~3
+ **/
+
+#ifndef _DAIDE_CLIENT_DAIDE_CLIENT_ORDER_GENERATOR_H
+#define _DAIDE_CLIENT_DAIDE_CLIENT_ORDER_GENERATOR_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "daide_client/map_and_units.h"
+#include "daide_client/map_topology.h"
+
+namespace DAIDE {
+
+// The legal orders in one position, for every power
+class LegalOrders : public MapTypes {
+public:
+    // An order. The fields used depend on the order type, as in UNIT_AND_ORDER. DISBAND_ORDER is also used for the
+    // remove orders of an adjustment turn.
+    using LEGAL_ORDER = struct {
+        ORDER_TYPE order_type;
+        COAST_INDEX destination;                    // Move, convoyed move or retreat. NO_COAST for other orders.
+        PROVINCE_INDEX other_source_province;       // The supported or convoyed unit
+        PROVINCE_INDEX other_dest_province;         // Where it is supported or convoyed to (its own province if holding)
+        int first_step;                             // The fleets a convoyed move goes through, in get_convoy_steps()
+        int number_of_steps;
+    };
+
+    // The orders for one unit
+    using UNIT_ORDERS = struct {
+        PROVINCE_INDEX unit;                        // Province of the unit (the dislodged unit in a retreat turn)
+        POWER_INDEX nationality;
+        int first_order;
+        int number_of_orders;
+    };
+
+    // A contiguous run of one of the arrays. Iterate it like a container.
+    template <typename T>
+    struct tag_list {
+        const T *first;
+        const T *last;
+
+        const T *begin() const { return first; }
+        const T *end() const { return last; }
+        const T &operator[](int index) const { return first[index]; }
+        int size() const { return static_cast<int>(last - first); }
+        bool empty() const { return first == last; }
+    };
+
+    using UNIT_ORDERS_LIST = tag_list<UNIT_ORDERS>;
+    using LEGAL_ORDER_LIST = tag_list<LEGAL_ORDER>;
+
+    // The units of a power which need orders this turn, in province order
+    UNIT_ORDERS_LIST get_units(POWER_INDEX power) const {
+        return make_list(unit_orders, power_first_unit[power], power_first_unit[power + 1]);
+    }
+
+    // The units of all the powers, taking the powers in turn
+    UNIT_ORDERS_LIST get_all_units() const {
+        return make_list(unit_orders, 0, static_cast<int>(unit_orders.size()));
+    }
+
+    int get_number_of_units() const { return static_cast<int>(unit_orders.size()); }
+
+    LEGAL_ORDER_LIST get_orders(const UNIT_ORDERS &unit) const {
+        return make_list(orders, unit.first_order, unit.first_order + unit.number_of_orders);
+    }
+
+    INDEX_LIST get_convoy_steps(const LEGAL_ORDER &order) const {
+        return INDEX_LIST {convoy_steps.data() + order.first_step,
+                           convoy_steps.data() + order.first_step + order.number_of_steps};
+    }
+
+    // Adjustment turns. The number of builds a power has (negative if it must remove units), and the coasts of the
+    // empty home centres it owns. Any builds it does not use are waived.
+    int get_number_of_builds(POWER_INDEX power) const { return power_builds[power]; }
+
+    INDEX_LIST get_build_locations(POWER_INDEX power) const {
+        return INDEX_LIST {build_locations.data() + power_first_build_location[power],
+                           build_locations.data() + power_first_build_location[power + 1]};
+    }
+
+    // The number of unit orders, for all powers
+    int get_number_of_orders() const { return static_cast<int>(orders.size()); }
+
+    // The map and season these orders are for
+    const std::shared_ptr<const MapTopology> &get_topology() const { return topology; }
+
+    const Token &get_season() const { return season; }
+
+    // Give a unit one of its orders, through the MapAndUnits set_..._order() functions. In an adjustment turn the
+    // remove order is entered as one of our winter orders.
+    bool set_order(MapAndUnits *map_and_units, const UNIT_ORDERS &unit, const LEGAL_ORDER &order) const;
+
+private:
+    friend class OrderGenerator;
+
+    template <typename T>
+    static tag_list<T> make_list(const std::vector<T> &values, int first, int last) {
+        return tag_list<T> {values.data() + first, values.data() + last};
+    }
+
+    // Empty the arrays, keeping their storage
+    void clear(int number_of_powers);
+
+    // The position these orders are for
+    std::shared_ptr<const MapTopology> topology;
+    uint64_t position_key {0};
+    Token season;
+
+    std::vector<LEGAL_ORDER> orders;
+    std::vector<UNIT_ORDERS> unit_orders;
+    std::vector<PROVINCE_INDEX> convoy_steps;
+    std::vector<COAST_INDEX> build_locations;
+
+    // Per power. The power_first_... arrays have an extra entry, marking the end of the last power.
+    std::vector<int> power_first_unit;
+    std::vector<int> power_builds;
+    std::vector<int> power_first_build_location;
+};
+
+class OrderGenerator : public MapTypes {
+public:
+    // The number of positions whose orders are kept
+    enum { CACHE_SIZE = 64 };
+
+    OrderGenerator();
+
+    // The legal orders in the current position of a MapAndUnits, whose position hash must be up to date. The result
+    // is kept until another position needs its place in the cache, so copy it to hold it for longer. A generator is
+    // not thread safe: use one per thread.
+    const LegalOrders &generate(const MapAndUnits &map_and_units);
+
+    // Forget all the kept results
+    void clear();
+
+private:
+    void generate_movement_orders(const MapAndUnits &map_and_units, LegalOrders *legal_orders);
+
+    void generate_retreat_orders(const MapAndUnits &map_and_units, LegalOrders *legal_orders);
+
+    void generate_adjustment_orders(const MapAndUnits &map_and_units, LegalOrders *legal_orders);
+
+    // Breadth first search from an army through the occupied sea provinces, recording the land provinces it can be
+    // convoyed to, the fleets it can use and the route to each province
+    void find_convoy_routes(const MapAndUnits &map_and_units, PROVINCE_INDEX army);
+
+    void add_order(LegalOrders *legal_orders,
+                   ORDER_TYPE order_type,
+                   COAST_INDEX destination,
+                   PROVINCE_INDEX other_source_province,
+                   PROVINCE_INDEX other_dest_province);
+
+    // The position hash, together with the retreat options of the dislodged units which it does not cover
+    static uint64_t get_position_key(const MapAndUnits &map_and_units);
+
+    std::vector<LegalOrders> cache;
+
+    // Working data for the position being generated
+    std::shared_ptr<const MapTopology> topology;
+    COAST_INDEX unit_coasts[MAX_PROVINCES];
+    PROVINCE_SET reachable_provinces[MAX_PROVINCES];    // For each unit, the provinces it can move to
+    std::vector<PROVINCE_INDEX> convoyable_armies;      // Armies with at least one convoy destination
+    PROVINCE_SET convoy_destinations[MAX_PROVINCES];    // For each army
+    PROVINCE_SET convoy_fleets[MAX_PROVINCES];          // For each army, the fleets which can be part of its convoy
+    PROVINCE_INDEX convoy_route_parent[MAX_PROVINCES];  // For the last search, the province each was reached from
+    PROVINCE_INDEX route_steps[MAX_PROVINCES];
+};
+
+} // namespace DAIDE
+
+#endif // _DAIDE_CLIENT_DAIDE_CLIENT_ORDER_GENERATOR_H
@@ -0,0 +1,376 @@
+/**
+ * Diplomacy AI Client - Part of the DAIDE project.
+ *
+ * Position Codec. Packs positions into bytes, and reads and writes files of them.
+ *
+ * Release 8~3
+ **/
+
+#include <algorithm>
+
+#include "daide_client/position_codec.h"
+
+using DAIDE::MapAndUnits;
+using DAIDE::MapTopology;
+using DAIDE::PositionCodec;
+using DAIDE::PositionReader;
+using DAIDE::PositionWriter;
+using DAIDE::Token;
+
+namespace {
+
+const char FILE_MAGIC[4] = {'D', 'P', 'O', 'S'};
+const uint8_t FILE_VERSION = 1;
+const int FILE_HEADER_SIZE = 4 + 1 + 8;
+
+const int SEASON_BITS = 3;
+const int YEAR_BITS = 16;
+const int NO_SEASON = 7;
+const int NUMBER_OF_SEASONS = 5;
+
+// Packs values of any width into a buffer, lowest bit first
+class BitWriter {
+public:
+    explicit BitWriter(PositionCodec::BUFFER *buffer) : m_buffer(buffer), m_bits_used(0) {}
+
+    void write(uint32_t value, int bits) {
+        for (int bit_ctr = 0; bit_ctr < bits; bit_ctr++) {
+            if (m_bits_used == 0) { m_buffer->push_back(0); }
+            if ((value >> bit_ctr) & 1) { m_buffer->back() |= static_cast<uint8_t>(1 << m_bits_used); }
+            m_bits_used = (m_bits_used + 1) & 7;
+        }
+    }
+
+private:
+    PositionCodec::BUFFER *m_buffer;
+    int m_bits_used;                            // Bits used in the last byte (0 if it is full)
+};
+
+// Unpacks what BitWriter packed. Reading past the end of the data sets the overrun flag and returns zeros.
+class BitReader {
+public:
+    BitReader(const uint8_t *data, size_t length) : m_data(data), m_length(length), m_position(0), m_overrun(false) {}
+
+    uint32_t read(int bits) {
+        uint32_t value {0};
+
+        for (int bit_ctr = 0; bit_ctr < bits; bit_ctr++) {
+            if ((m_position >> 3) >= m_length) {
+                m_overrun = true;
+                return 0;
+            }
+            if ((m_data[m_position >> 3] >> (m_position & 7)) & 1) { value |= uint32_t(1) << bit_ctr; }
+            m_position++;
+        }
+        return value;
+    }
+
+    bool overrun() const { return m_overrun; }
+
+    size_t get_bytes_used() const { return (m_position + 7) >> 3; }
+
+private:
+    const uint8_t *m_data;
+    size_t m_length;
+    size_t m_position;                          // In bits
+    bool m_overrun;
+};
+
+void write_uint64(uint64_t value, uint8_t *bytes) {
+    for (int byte_ctr = 0; byte_ctr < 8; byte_ctr++) {
+        bytes[byte_ctr] = static_cast<uint8_t>(value >> (byte_ctr * 8));
+    }
+}
+
+uint64_t read_uint64(const uint8_t *bytes) {
+    uint64_t value {0};
+
+    for (int byte_ctr = 0; byte_ctr < 8; byte_ctr++) {
+        value |= static_cast<uint64_t>(bytes[byte_ctr]) << (byte_ctr * 8);
+    }
+    return value;
+}
+
+} // namespace
+
+PositionCodec::PositionCodec(const std::shared_ptr<const MapTopology> &topology) :
+    topology {topology},
+    map_fingerprint {0}
+{
+    int number_of_powers = std::max(topology->number_of_powers, 0);
+    int number_of_provinces = std::max(topology->number_of_provinces, 0);
+
+    owner_bits = bits_for(number_of_powers + 1);
+    unit_count_bits = bits_for(number_of_provinces + 1);
+    coast_bits = bits_for(topology->number_of_coasts);
+    power_bits = bits_for(number_of_powers);
+
+    // Everything the packed form depends on: the powers, the centres, the coasts and their adjacencies
+    map_fingerprint = MapTopology::mix_hash((static_cast<uint64_t>(number_of_powers) << 32) | number_of_provinces);
+    for (PROVINCE_INDEX province_ctr = 0; province_ctr < number_of_provinces; province_ctr++) {
+        map_fingerprint = MapTopology::mix_hash(map_fingerprint
+                                                ^ topology->game_map[province_ctr].province_token.get_token()
+                                                ^ (topology->game_map[province_ctr].is_supply_centre ? 0x10000 : 0));
+    }
+    for (COAST_INDEX coast_ctr = 0; coast_ctr < topology->number_of_coasts; coast_ctr++) {
+        const COAST_ID &coast = topology->get_coast(coast_ctr);
+
+        map_fingerprint = MapTopology::mix_hash(map_fingerprint ^ (static_cast<uint64_t>(coast.province_index) << 16)
+                                                ^ coast.coast_token.get_token());
+        for (COAST_INDEX adjacent_coast : topology->get_coast_adjacencies(coast_ctr)) {
+            map_fingerprint = MapTopology::mix_hash(map_fingerprint ^ static_cast<uint64_t>(adjacent_coast));
+        }
+    }
+}
+
+int PositionCodec::bits_for(int limit) {
+    int bits {0};
+
+    while ((bits < 31) && ((1 << bits) < limit)) { bits++; }
+    return bits;
+}
+
+bool PositionCodec::encode(const GamePosition &position, BUFFER *buffer) const {
+    size_t original_size = buffer->size();
+    int number_of_powers = std::max(topology->number_of_powers, 0);
+    int season_index {NO_SEASON};
+    BitWriter writer(buffer);
+
+    // Turn
+    season_index = position.current_season.get_token() - TOKEN_SEASON_SPR.get_token();
+    if ((season_index < 0) || (season_index >= NUMBER_OF_SEASONS)) { season_index = NO_SEASON; }
+    writer.write(static_cast<uint32_t>(season_index), SEASON_BITS);
+    writer.write(static_cast<uint16_t>(position.current_year), YEAR_BITS);
+
+    // Supply centre owners, with number_of_powers for unowned
+    for (PROVINCE_INDEX province_ctr = 0; province_ctr < topology->number_of_provinces; province_ctr++) {
+        if (topology->game_map[province_ctr].is_supply_centre) {
+            const Token &owner = position.province_owner[province_ctr];
+            int owner_index = number_of_powers;
+
+            if ((owner.get_category() == CATEGORY_POWER) && (owner.get_subtoken() < number_of_powers)) {
+                owner_index = owner.get_subtoken();
+            }
+            writer.write(static_cast<uint32_t>(owner_index), owner_bits);
+        }
+    }
+
+    // Units, then dislodged units with their retreat options
+    for (const UNITS *unit_set : {&position.units, &position.dislodged_units}) {
+        bool is_dislodged = (unit_set == &position.dislodged_units);
+
+        writer.write(static_cast<uint32_t>(unit_set->size()), unit_count_bits);
+
+        for (auto &unit_itr : *unit_set) {
+            const UNIT_AND_ORDER &unit = unit_itr.second;
+            COAST_INDEX coast_index = topology->get_coast_index(unit.coast_id);
+
+            if ((coast_index == NO_COAST) || (unit.nationality < 0) || (unit.nationality >= number_of_powers)) {
+                buffer->resize(original_size);
+                return false;
+            }
+
+            writer.write(static_cast<uint32_t>(coast_index), coast_bits);
+            writer.write(static_cast<uint32_t>(unit.nationality), power_bits);
+
+            if (is_dislodged) {
+                size_t retreats_found {0};
+
+                for (COAST_INDEX adjacent_coast : topology->get_coast_adjacencies(coast_index)) {
+                    bool can_retreat = (unit.retreat_options.count(topology->get_coast(adjacent_coast)) != 0);
+
+                    writer.write(can_retreat ? 1 : 0, 1);
+                    if (can_retreat) { retreats_found++; }
+                }
+
+                if (retreats_found != unit.retreat_options.size()) {
+                    buffer->resize(original_size);
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+size_t PositionCodec::decode(const uint8_t *data, size_t length, GamePosition *position) const {
+    int number_of_powers = std::max(topology->number_of_powers, 0);
+    int season_index {NO_SEASON};
+    BitReader reader(data, length);
+
+    // Turn
+    season_index = static_cast<int>(reader.read(SEASON_BITS));
+    if (season_index == NO_SEASON) {
+        position->current_season = Token(0);
+    } else if (season_index < NUMBER_OF_SEASONS) {
+        position->current_season = Token(TOKEN_SEASON_SPR.get_token() + season_index);
+    } else {
+        return 0;
+    }
+    position->current_year = static_cast<int16_t>(reader.read(YEAR_BITS));
+
+    // Supply centre owners. Other provinces keep their owner from the map.
+    for (PROVINCE_INDEX province_ctr = 0; province_ctr < MAX_PROVINCES; province_ctr++) {
+        position->province_owner[province_ctr] = topology->game_map[province_ctr].initial_owner;
+    }
+    for (PROVINCE_INDEX province_ctr = 0; province_ctr < topology->number_of_provinces; province_ctr++) {
+        if (topology->game_map[province_ctr].is_supply_centre) {
+            int owner_index = static_cast<int>(reader.read(owner_bits));
+
+            if (owner_index > number_of_powers) { return 0; }
+            position->province_owner[province_ctr] =
+                    (owner_index == number_of_powers) ? TOKEN_PARAMETER_UNO : Token(CATEGORY_POWER, owner_index);
+        }
+    }
+
+    // Units, then dislodged units with their retreat options
+    position->units.clear();
+    position->dislodged_units.clear();
+    position->winter_orders.clear();
+
+    for (UNITS *unit_set : {&position->units, &position->dislodged_units}) {
+        bool is_dislodged = (unit_set == &position->dislodged_units);
+        int number_of_units = static_cast<int>(reader.read(unit_count_bits));
+
+        for (int unit_ctr = 0; unit_ctr < number_of_units; unit_ctr++) {
+            COAST_INDEX coast_index = static_cast<COAST_INDEX>(reader.read(coast_bits));
+            POWER_INDEX power_index = static_cast<POWER_INDEX>(reader.read(power_bits));
+
+            if ((coast_index >= topology->number_of_coasts) || (power_index >= number_of_powers)) { return 0; }
+
+            const COAST_ID &coast = topology->get_coast(coast_index);
+            if (unit_set->count(coast.province_index) != 0) { return 0; }
+
+            UNIT_AND_ORDER &unit = (*unit_set)[coast.province_index];
+            unit.coast_id = coast;
+            unit.nationality = power_index;
+            unit.unit_type = (coast.coast_token == TOKEN_UNIT_AMY) ? TOKEN_UNIT_AMY : TOKEN_UNIT_FLT;
+            unit.order_type = NO_ORDER;
+
+            if (is_dislodged) {
+                for (COAST_INDEX adjacent_coast : topology->get_coast_adjacencies(coast_index)) {
+                    if (reader.read(1) != 0) { unit.retreat_options.insert(topology->get_coast(adjacent_coast)); }
+                }
+            }
+        }
+    }
+
+    if (reader.overrun()) { return 0; }
+
+    position->position_hash = 0;
+    position->order_hash = 0;
+    return reader.get_bytes_used();
+}
+
+size_t PositionCodec::decode(const uint8_t *data, size_t length, MapAndUnits *map_and_units) const {
+    GamePosition position;
+    size_t bytes_used {0};
+
+    if (map_and_units->get_topology() != topology) { return 0; }
+
+    bytes_used = decode(data, length, &position);
+    if (bytes_used != 0) {
+        map_and_units->set_position(position);
+        map_and_units->rehash();
+    }
+    return bytes_used;
+}
+
+bool PositionWriter::open(const std::string &filename) {
+    uint8_t header[FILE_HEADER_SIZE];
+
+    close();
+    file = fopen(filename.c_str(), "wb");
+    if (file == nullptr) { return false; }
+
+    std::copy(FILE_MAGIC, FILE_MAGIC + 4, header);
+    header[4] = FILE_VERSION;
+    write_uint64(codec.get_map_fingerprint(), header + 5);
+
+    if (fwrite(header, 1, FILE_HEADER_SIZE, file) != FILE_HEADER_SIZE) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool PositionWriter::write(const GamePosition &position) {
+    uint8_t length_bytes[10];
+    size_t number_of_length_bytes {0};
+    size_t record_length {0};
+
+    if (file == nullptr) { return false; }
+
+    buffer.clear();
+    if (!codec.encode(position, &buffer)) { return false; }
+
+    // The length goes first, seven bits to a byte
+    record_length = buffer.size();
+    do {
+        length_bytes[number_of_length_bytes] = static_cast<uint8_t>(record_length & 0x7f);
+        record_length >>= 7;
+        if (record_length != 0) { length_bytes[number_of_length_bytes] |= 0x80; }
+        number_of_length_bytes++;
+    } while (record_length != 0);
+
+    return (fwrite(length_bytes, 1, number_of_length_bytes, file) == number_of_length_bytes)
+           && (fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size());
+}
+
+void PositionWriter::close() {
+    if (file != nullptr) {
+        fclose(file);
+        file = nullptr;
+    }
+}
+
+bool PositionReader::open(const std::string &filename) {
+    uint8_t header[FILE_HEADER_SIZE];
+
+    close();
+    file = fopen(filename.c_str(), "rb");
+    if (file == nullptr) { return false; }
+
+    if ((fread(header, 1, FILE_HEADER_SIZE, file) != FILE_HEADER_SIZE)
+        || !std::equal(FILE_MAGIC, FILE_MAGIC + 4, header)
+        || (header[4] != FILE_VERSION)
+        || (read_uint64(header + 5) != codec.get_map_fingerprint())) {
+
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool PositionReader::read_record() {
+    size_t record_length {0};
+    int shift {0};
+    int length_byte {0};
+
+    if (file == nullptr) { return false; }
+
+    do {
+        length_byte = fgetc(file);
+        if ((length_byte == EOF) || (shift > 28)) { return false; }
+        record_length |= static_cast<size_t>(length_byte & 0x7f) << shift;
+        shift += 7;
+    } while (length_byte & 0x80);
+
+    buffer.resize(record_length);
+    return fread(buffer.data(), 1, record_length, file) == record_length;
+}
+
+bool PositionReader::read(GamePosition *position) {
+    return read_record() && (codec.decode(buffer.data(), buffer.size(), position) == buffer.size());
+}
+
+bool PositionReader::read(MapAndUnits *map_and_units) {
+    return read_record() && (codec.decode(buffer.data(), buffer.size(), map_and_units) == buffer.size());
+}
+
+void PositionReader::close() {
+    if (file != nullptr) {
+        fclose(file);
+        file = nullptr;
+    }
+}
@@ -0,0 +1,121 @@
+/**
+ * Diplomacy AI Client - Part of the DAIDE project.
+ *
+ * Position Codec. Packs a position into a few dozen bytes for bulk storage, and reads and writes files of them.
+ *
+ * A packed position holds the turn, the owner of each supply centre, the units and the dislodged units with their
+ * retreat options. Each field takes only as many bits as the map needs: a unit is its dense coast index (which gives
+ * the province, coast and unit type) and its power, and its retreat options are one bit per adjacent coast. Orders,
+ * and the owners of provinces which are not supply centres, are not stored. A standard map position takes 50 to 60
+ * bytes.
+ *
+ * Release 8~3
+ **/
+
+#ifndef _DAIDE_CLIENT_DAIDE_CLIENT_POSITION_CODEC_H
+#define _DAIDE_CLIENT_DAIDE_CLIENT_POSITION_CODEC_H
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "daide_client/game_position.h"
+#include "daide_client/map_and_units.h"
+#include "daide_client/map_topology.h"
+
+namespace DAIDE {
+
+class PositionCodec : public MapTypes {
+public:
+    using BUFFER = std::vector<uint8_t>;
+
+    explicit PositionCodec(const std::shared_ptr<const MapTopology> &topology);
+
+    // Append the packed position to the buffer. Returns false, leaving the buffer unchanged, if the position does not
+    // fit the map (a unit on a coast the map does not have, or a retreat to a coast which is not adjacent).
+    bool encode(const GamePosition &position, BUFFER *buffer) const;
+
+    // Unpack a position. Returns the number of bytes used, or 0 if the data is not a valid position for the map.
+    // The hashes are left at zero, as they belong to the MapAndUnits which takes the position.
+    size_t decode(const uint8_t *data, size_t length, GamePosition *position) const;
+
+    // Unpack a position straight into a MapAndUnits using the same map, as set_position() does, and rehash it
+    size_t decode(const uint8_t *data, size_t length, MapAndUnits *map_and_units) const;
+
+    // Identifies the map, so a file is only read with the map it was written with
+    uint64_t get_map_fingerprint() const { return map_fingerprint; }
+
+    const std::shared_ptr<const MapTopology> &get_topology() const { return topology; }
+
+private:
+    // The number of bits needed to hold any value below the limit
+    static int bits_for(int limit);
+
+    std::shared_ptr<const MapTopology> topology;
+    uint64_t map_fingerprint;
+
+    // Field widths, in bits
+    int owner_bits;
+    int unit_count_bits;
+    int coast_bits;
+    int power_bits;
+};
+
+// Writes a file of packed positions: a header identifying the map, then each position preceded by its length
+class PositionWriter {
+public:
+    explicit PositionWriter(const std::shared_ptr<const MapTopology> &topology) : codec(topology) {}
+
+    PositionWriter(const PositionWriter &other) = delete;
+    PositionWriter &operator=(const PositionWriter &other) = delete;
+
+    ~PositionWriter() { close(); }
+
+    // Create the file and write the header. Returns false if it cannot be written.
+    bool open(const std::string &filename);
+
+    // Returns false if the position does not fit the map, or the file cannot be written
+    bool write(const GamePosition &position);
+
+    void close();
+
+private:
+    PositionCodec codec;
+    PositionCodec::BUFFER buffer;
+    FILE *file {nullptr};
+};
+
+// Reads a file written by PositionWriter, one position at a time
+class PositionReader {
+public:
+    explicit PositionReader(const std::shared_ptr<const MapTopology> &topology) : codec(topology) {}
+
+    PositionReader(const PositionReader &other) = delete;
+    PositionReader &operator=(const PositionReader &other) = delete;
+
+    ~PositionReader() { close(); }
+
+    // Open the file and check its header. Returns false if it cannot be read, or was written for another map.
+    bool open(const std::string &filename);
+
+    // Read the next position. Returns false at the end of the file, or if the file is damaged.
+    bool read(GamePosition *position);
+
+    bool read(MapAndUnits *map_and_units);
+
+    void close();
+
+private:
+    // Read the next record into the buffer
+    bool read_record();
+
+    PositionCodec codec;
+    PositionCodec::BUFFER buffer;
+    FILE *file {nullptr};
+};
+
+} // namespace DAIDE
+
+#endif // _DAIDE_CLIENT_DAIDE_CLIENT_POSITION_CODEC_H
@@ -0,0 +1,183 @@
+/**
+ * Diplomacy AI Client - Part of the DAIDE project.
+ *
+ * Province Map. A map from province index to a value, held as a fixed table with one slot per province and a
+ * ProvinceSet recording which slots are in use.
+ *
+ * It has the parts of the std::map interface used in the client (begin, end, find, upper_bound, count, insert, erase,
+ * operator[], size, empty, clear), and iterates in ascending order like std::map, so it can replace std::map<PROVINCE_INDEX, T>
+ * without changing the code which uses it. Lookups are an index, not a tree search. Only the slots in use are
+ * constructed, copied and destroyed. Iterators and references stay valid until their own entry is erased.
+ *
+ * Release 8~3
+ **/
+
+#ifndef _DAIDE_CLIENT_DAIDE_CLIENT_PROVINCE_MAP_H
+#define _DAIDE_CLIENT_DAIDE_CLIENT_PROVINCE_MAP_H
+
+#include <cstddef>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "daide_client/province_set.h"
+
+namespace DAIDE {
+
+template <typename T>
+class ProvinceMap {
+public:
+    enum { CAPACITY = ProvinceSet::CAPACITY };
+
+    using key_type = int;
+    using mapped_type = T;
+    using value_type = std::pair<const int, T>;
+    using size_type = int;
+
+    template <typename MAP, typename VALUE>
+    class basic_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = typename std::remove_const<VALUE>::type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = VALUE *;
+        using reference = VALUE &;
+
+        basic_iterator() : m_map(nullptr) {}
+        basic_iterator(MAP *map, ProvinceSet::const_iterator position) : m_map(map), m_position(position) {}
+
+        // An iterator converts to a const_iterator
+        template <typename OTHER_MAP, typename OTHER_VALUE>
+        basic_iterator(const basic_iterator<OTHER_MAP, OTHER_VALUE> &other)
+            : m_map(other.m_map), m_position(other.m_position) {}
+
+        reference operator*() const { return m_map->slot(*m_position); }
+        pointer operator->() const { return &(m_map->slot(*m_position)); }
+
+        basic_iterator &operator++() {
+            ++m_position;
+            return *this;
+        }
+
+        basic_iterator operator++(int) {
+            basic_iterator previous = *this;
+            ++m_position;
+            return previous;
+        }
+
+        bool operator==(const basic_iterator &other) const { return m_position == other.m_position; }
+        bool operator!=(const basic_iterator &other) const { return m_position != other.m_position; }
+
+    private:
+        template <typename OTHER_MAP, typename OTHER_VALUE> friend class basic_iterator;
+        friend class ProvinceMap;
+
+        MAP *m_map;
+        ProvinceSet::const_iterator m_position;
+    };
+
+    using iterator = basic_iterator<ProvinceMap, value_type>;
+    using const_iterator = basic_iterator<const ProvinceMap, const value_type>;
+
+    ProvinceMap() = default;
+
+    ProvinceMap(const ProvinceMap &other) { copy_from(other); }
+
+    ProvinceMap &operator=(const ProvinceMap &other) {
+        if (this != &other) {
+            clear();
+            copy_from(other);
+        }
+        return *this;
+    }
+
+    ~ProvinceMap() { clear(); }
+
+    iterator begin() { return iterator(this, m_occupied.begin()); }
+    iterator end() { return iterator(this, m_occupied.end()); }
+    const_iterator begin() const { return const_iterator(this, m_occupied.begin()); }
+    const_iterator end() const { return const_iterator(this, m_occupied.end()); }
+
+    iterator find(int province) { return m_occupied.contains(province) ? at_slot(province) : end(); }
+
+    const_iterator find(int province) const {
+        return m_occupied.contains(province) ? const_iterator(this, m_occupied.find(province)) : end();
+    }
+
+    iterator upper_bound(int province) { return iterator(this, m_occupied.upper_bound(province)); }
+
+    const_iterator upper_bound(int province) const { return const_iterator(this, m_occupied.upper_bound(province)); }
+
+    size_type count(int province) const { return m_occupied.count(province); }
+
+    size_type size() const { return m_occupied.size(); }
+
+    bool empty() const { return m_occupied.empty(); }
+
+    // The provinces in use
+    const ProvinceSet &get_provinces() const { return m_occupied; }
+
+    // As std::map, does nothing if the province is already in use
+    std::pair<iterator, bool> insert(const value_type &value) {
+        bool inserted = !m_occupied.contains(value.first);
+        if (inserted) {
+            new (&m_slots[value.first]) value_type(value);
+            m_occupied.insert(value.first);
+        }
+        return std::make_pair(at_slot(value.first), inserted);
+    }
+
+    // As std::map, a value initialised entry is added if the province is not in use
+    T &operator[](int province) {
+        if (!m_occupied.contains(province)) {
+            new (&m_slots[province]) value_type(province, T());
+            m_occupied.insert(province);
+        }
+        return slot(province).second;
+    }
+
+    size_type erase(int province) {
+        if (!m_occupied.contains(province)) { return 0; }
+
+        slot(province).~value_type();
+        m_occupied.erase(province);
+        return 1;
+    }
+
+    iterator erase(iterator position) {
+        int province = *(position.m_position);
+        ++position;
+        erase(province);
+        return position;
+    }
+
+    void clear() {
+        for (int province : m_occupied) {
+            slot(province).~value_type();
+        }
+        m_occupied.clear();
+    }
+
+private:
+    using SLOT = typename std::aligned_storage<sizeof(value_type), alignof(value_type)>::type;
+
+    value_type &slot(int province) { return *reinterpret_cast<value_type *>(&m_slots[province]); }
+    const value_type &slot(int province) const { return *reinterpret_cast<const value_type *>(&m_slots[province]); }
+
+    iterator at_slot(int province) { return iterator(this, m_occupied.find(province)); }
+
+    void copy_from(const ProvinceMap &other) {
+        for (int province : other.m_occupied) {
+            new (&m_slots[province]) value_type(other.slot(province));
+        }
+        m_occupied = other.m_occupied;
+    }
+
+    ProvinceSet m_occupied;
+    SLOT m_slots[CAPACITY];
+};
+
+} // namespace DAIDE
+
+#endif // _DAIDE_CLIENT_DAIDE_CLIENT_PROVINCE_MAP_H
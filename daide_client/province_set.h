@@ -0,0 +1,209 @@
+/**
+ * Diplomacy AI Client - Part of the DAIDE project.
+ *
+ * Province Set. A set of province indexes held as a 256 bit bitmap.
+ *
+ * It has the parts of the std::set interface used in the client (begin, end, find, insert, erase, count, size, empty,
+ * clear), and iterates in ascending order like std::set, so it can replace std::set<PROVINCE_INDEX> without changing
+ * the code which uses it. Iterators stay valid when other members are inserted or erased.
+ *
+ * Union, intersection and difference work a word at a time, using AVX2 when the compiler targets it.
+ *
+ * Release 8~3
+ **/
+
+#ifndef _DAIDE_CLIENT_DAIDE_CLIENT_PROVINCE_SET_H
+#define _DAIDE_CLIENT_DAIDE_CLIENT_PROVINCE_SET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <utility>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+namespace DAIDE {
+
+class ProvinceSet {
+public:
+    enum { CAPACITY = 256 };                        // Must match MapTypes::MAX_PROVINCES
+    enum { NUMBER_OF_WORDS = CAPACITY / 64 };
+
+    using value_type = int;
+    using key_type = int;
+    using size_type = std::size_t;
+
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = int;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const int *;
+        using reference = int;
+
+        const_iterator() : m_set(nullptr), m_index(CAPACITY) {}
+        const_iterator(const ProvinceSet *set, int index) : m_set(set), m_index(index) {}
+
+        int operator*() const { return m_index; }
+
+        const_iterator &operator++() {
+            m_index = m_set->find_next(m_index + 1);
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            const_iterator previous = *this;
+            ++(*this);
+            return previous;
+        }
+
+        bool operator==(const const_iterator &other) const { return m_index == other.m_index; }
+        bool operator!=(const const_iterator &other) const { return m_index != other.m_index; }
+
+    private:
+        const ProvinceSet *m_set;
+        int m_index;
+    };
+
+    using iterator = const_iterator;
+
+    ProvinceSet() : m_words {0, 0, 0, 0} {}
+
+    template <typename InputIterator>
+    ProvinceSet(InputIterator first, InputIterator last) : m_words {0, 0, 0, 0} { insert(first, last); }
+
+    ProvinceSet(std::initializer_list<int> provinces) : m_words {0, 0, 0, 0} {
+        insert(provinces.begin(), provinces.end());
+    }
+
+    // Iteration, in ascending order
+    const_iterator begin() const { return const_iterator(this, find_next(0)); }
+    const_iterator end() const { return const_iterator(this, CAPACITY); }
+
+    const_iterator find(int province) const { return contains(province) ? const_iterator(this, province) : end(); }
+
+    // The first member after the given province
+    const_iterator upper_bound(int province) const { return const_iterator(this, find_next(province + 1)); }
+
+    bool contains(int province) const { return (m_words[province >> 6] >> (province & 63)) & 1; }
+
+    size_type count(int province) const { return contains(province) ? 1 : 0; }
+
+    std::pair<const_iterator, bool> insert(int province) {
+        bool inserted = !contains(province);
+        m_words[province >> 6] |= uint64_t(1) << (province & 63);
+        return std::make_pair(const_iterator(this, province), inserted);
+    }
+
+    template <typename InputIterator>
+    void insert(InputIterator first, InputIterator last) {
+        for (; first != last; ++first) { insert(*first); }
+    }
+
+    // Erase by value (returns the number erased), or by position (returns the next member)
+    size_type erase(int province) {
+        size_type erased = count(province);
+        m_words[province >> 6] &= ~(uint64_t(1) << (province & 63));
+        return erased;
+    }
+
+    const_iterator erase(const_iterator position) {
+        int province = *position;
+        erase(province);
+        return const_iterator(this, find_next(province + 1));
+    }
+
+    void clear() {
+        for (auto &word : m_words) { word = 0; }
+    }
+
+    bool empty() const { return (m_words[0] | m_words[1] | m_words[2] | m_words[3]) == 0; }
+
+    size_type size() const {
+        return static_cast<size_type>(__builtin_popcountll(m_words[0]) + __builtin_popcountll(m_words[1])
+                                      + __builtin_popcountll(m_words[2]) + __builtin_popcountll(m_words[3]));
+    }
+
+    bool operator==(const ProvinceSet &other) const {
+        return (m_words[0] == other.m_words[0]) && (m_words[1] == other.m_words[1])
+               && (m_words[2] == other.m_words[2]) && (m_words[3] == other.m_words[3]);
+    }
+
+    bool operator!=(const ProvinceSet &other) const { return !(*this == other); }
+
+    // Set operations
+    ProvinceSet &operator|=(const ProvinceSet &other) {
+#ifdef __AVX2__
+        store(_mm256_or_si256(load(), other.load()));
+#else
+        for (int word_ctr = 0; word_ctr < NUMBER_OF_WORDS; word_ctr++) {
+            m_words[word_ctr] |= other.m_words[word_ctr];
+        }
+#endif
+        return *this;
+    }
+
+    ProvinceSet &operator&=(const ProvinceSet &other) {
+#ifdef __AVX2__
+        store(_mm256_and_si256(load(), other.load()));
+#else
+        for (int word_ctr = 0; word_ctr < NUMBER_OF_WORDS; word_ctr++) {
+            m_words[word_ctr] &= other.m_words[word_ctr];
+        }
+#endif
+        return *this;
+    }
+
+    // Remove the members of the other set
+    ProvinceSet &operator-=(const ProvinceSet &other) {
+#ifdef __AVX2__
+        store(_mm256_andnot_si256(other.load(), load()));
+#else
+        for (int word_ctr = 0; word_ctr < NUMBER_OF_WORDS; word_ctr++) {
+            m_words[word_ctr] &= ~other.m_words[word_ctr];
+        }
+#endif
+        return *this;
+    }
+
+    ProvinceSet operator|(const ProvinceSet &other) const { return ProvinceSet(*this) |= other; }
+    ProvinceSet operator&(const ProvinceSet &other) const { return ProvinceSet(*this) &= other; }
+    ProvinceSet operator-(const ProvinceSet &other) const { return ProvinceSet(*this) -= other; }
+
+    bool intersects(const ProvinceSet &other) const {
+        return ((m_words[0] & other.m_words[0]) | (m_words[1] & other.m_words[1])
+                | (m_words[2] & other.m_words[2]) | (m_words[3] & other.m_words[3])) != 0;
+    }
+
+    // Direct access to the bitmap, e.g. for hashing
+    uint64_t get_word(int word_index) const { return m_words[word_index]; }
+
+private:
+    // The first member at or after the given index, or CAPACITY if there is none
+    int find_next(int index) const {
+        if (index >= CAPACITY) { return CAPACITY; }
+
+        int word_index = index >> 6;
+        uint64_t word = m_words[word_index] & (~uint64_t(0) << (index & 63));
+
+        while (word == 0) {
+            if (++word_index == NUMBER_OF_WORDS) { return CAPACITY; }
+            word = m_words[word_index];
+        }
+        return (word_index << 6) + __builtin_ctzll(word);
+    }
+
+#ifdef __AVX2__
+    __m256i load() const { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(m_words)); }
+    void store(__m256i value) { _mm256_storeu_si256(reinterpret_cast<__m256i *>(m_words), value); }
+#endif
+
+    uint64_t m_words[NUMBER_OF_WORDS];
+};
+
+} // namespace DAIDE
+
+#endif // _DAIDE_CLIENT_DAIDE_CLIENT_PROVINCE_SET_H
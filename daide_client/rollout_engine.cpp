@@ -0,0 +1,295 @@
+/**
+ * Diplomacy AI Client - Part of the DAIDE project.
+ *
+ * Rollout Engine. Plays whole games in process, without a server.
+ *
+ * Release 8~3
+ **/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <future>
+#include <memory>
+#include <utility>
+
+#include "daide_client/metrics.h"
+#include "daide_client/rollout_engine.h"
+
+using DAIDE::MapTopology;
+using DAIDE::RolloutEngine;
+
+namespace {
+
+// The games of one call of play_games(). The last game to finish sets the promise.
+using ROLLOUT_STATE = struct {
+    std::promise<void> promise;
+    std::atomic<int> games_left;
+    std::atomic<long> number_of_turns;
+};
+
+int random_below(RolloutEngine::RANDOM &random, int limit) {
+    return static_cast<int>(random() % static_cast<uint64_t>(limit));
+}
+
+// The power holding more than half the supply centres, or NO_POWER
+RolloutEngine::POWER_INDEX find_solo(const std::vector<int> &centre_counts, int number_of_centres) {
+    for (int power_ctr = 0; power_ctr < static_cast<int>(centre_counts.size()); power_ctr++) {
+        if (centre_counts[power_ctr] * 2 > number_of_centres) { return power_ctr; }
+    }
+    return RolloutEngine::NO_POWER;
+}
+
+} // namespace
+
+int RolloutEngine::random_policy(const MapAndUnits &game,
+                                 const LegalOrders &legal_orders,
+                                 POWER_INDEX power,
+                                 RANDOM &random,
+                                 int choices[]) {
+    LegalOrders::UNIT_ORDERS_LIST units = legal_orders.get_units(power);
+    INDEX_LIST build_locations = legal_orders.get_build_locations(power);
+    int number_of_builds = legal_orders.get_number_of_builds(power);
+    int number_of_candidates = (number_of_builds > 0) ? build_locations.size() : units.size();
+    int number_of_choices {0};
+    PROVINCE_SET built_provinces;
+
+    if (game.current_season != TOKEN_SEASON_WIN) {
+        for (const auto &unit : units) {
+            choices[number_of_choices++] = random_below(random, unit.number_of_orders);
+        }
+        return number_of_choices;
+    }
+
+    for (int candidate_ctr = 0; candidate_ctr < number_of_candidates; candidate_ctr++) {
+        choices[candidate_ctr] = candidate_ctr;
+    }
+
+    // Take the coasts or units in a random order, building in each province once at most
+    for (int candidate_ctr = 0;
+         (candidate_ctr < number_of_candidates) && (number_of_choices < std::abs(number_of_builds));
+         candidate_ctr++) {
+
+        std::swap(choices[candidate_ctr],
+                  choices[candidate_ctr + random_below(random, number_of_candidates - candidate_ctr)]);
+
+        if (number_of_builds > 0) {
+            PROVINCE_INDEX province = legal_orders.get_topology()->get_coast(
+                    build_locations.begin()[choices[candidate_ctr]]).province_index;
+
+            if (built_provinces.contains(province)) { continue; }
+            built_provinces.insert(province);
+        }
+        choices[number_of_choices++] = choices[candidate_ctr];
+    }
+    return number_of_choices;
+}
+
+RolloutEngine::RolloutEngine(AdjudicationPool *pool) : pool(pool), default_policy(random_policy) {}
+
+void RolloutEngine::set_policy(const POLICY &policy) {
+    default_policy = policy;
+    policies.clear();
+}
+
+void RolloutEngine::set_policy(POWER_INDEX power, const POLICY &policy) {
+    if (power < 0) { return; }
+
+    if (power >= static_cast<int>(policies.size())) {
+        policies.resize(power + 1);
+    }
+    policies[power] = policy;
+}
+
+RolloutEngine::ROLLOUT_STATS RolloutEngine::play_games(const GamePosition &position,
+                                                       int number_of_games,
+                                                       uint64_t seed,
+                                                       std::vector<GAME_RESULT> *results) {
+    static MetricsCounter &games_played = MetricsRegistry::instance()->counter(
+            "daide_rollout_games_total", "Games played by RolloutEngine::play_games()");
+
+    auto shared_position = std::make_shared<const GamePosition>(position);
+    auto rollout = std::make_shared<ROLLOUT_STATE>();
+    std::future<void> finished = rollout->promise.get_future();
+    ROLLOUT_STATS stats {std::max(number_of_games, 0), 0, 0.0, 0.0};
+    auto start_time = std::chrono::steady_clock::now();
+
+    if (results != nullptr) {
+        results->assign(stats.number_of_games, GAME_RESULT {GAME_END_LAST_YEAR, NO_POWER, 0, 0, {}});
+    }
+    if (number_of_games <= 0) { return stats; }
+
+    rollout->games_left = number_of_games;
+    rollout->number_of_turns = 0;
+
+    for (int game_ctr = 0; game_ctr < number_of_games; game_ctr++) {
+        GAME_RESULT *game_result = (results == nullptr) ? nullptr : &((*results)[game_ctr]);
+
+        pool->submit([this, shared_position, rollout, seed, game_ctr, game_result](
+                AdjudicationPool::WORKER_SCRATCH &scratch) {
+            MapAndUnits &game = scratch.map_and_units;
+            MapAndUnits::MOVE_ADJUDICATOR worker_move_adjudicator = game.get_move_adjudicator();
+            bool check_on_submission = game.check_orders_on_submission;
+            bool check_on_adjudication = game.check_orders_on_adjudication;
+            RANDOM random(MapTopology::mix_hash(seed + static_cast<uint64_t>(game_ctr)));
+
+            // The orders are legal by construction, so they are not checked
+            game.set_position(*shared_position);
+            game.set_order_checking(false, false);
+            game.set_move_adjudicator(move_adjudicator);
+
+            GAME_RESULT result = play_game(&game, &scratch.order_generator, random);
+
+            // The worker's MapAndUnits is shared with the pool's other tasks
+            game.set_order_checking(check_on_submission, check_on_adjudication);
+            game.set_move_adjudicator(worker_move_adjudicator);
+
+            rollout->number_of_turns.fetch_add(result.number_of_turns);
+            if (game_result != nullptr) { *game_result = std::move(result); }
+
+            if (rollout->games_left.fetch_sub(1) == 1) {
+                rollout->promise.set_value();
+            }
+        });
+    }
+
+    finished.wait();
+
+    stats.number_of_turns = rollout->number_of_turns.load();
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    stats.games_per_second = (stats.seconds > 0.0) ? stats.number_of_games / stats.seconds : 0.0;
+    games_played.increment(static_cast<uint64_t>(number_of_games));
+    return stats;
+}
+
+RolloutEngine::GAME_RESULT RolloutEngine::play_game(MapAndUnits *game,
+                                                    OrderGenerator *order_generator,
+                                                    RANDOM &random) const {
+    GAME_RESULT result {GAME_END_LAST_YEAR, NO_POWER, game->current_year, 0, {}};
+    std::vector<int> last_centre_counts;
+    std::vector<int> choices;
+    int final_year = (last_year > 0) ? last_year : game->current_year + DEFAULT_YEARS - 1;
+    int number_of_centres = count_centres(*game, &(result.centre_counts));
+    int counted_year = game->current_year;
+    int unchanged_years {0};
+
+    while (game->current_year <= final_year) {
+        result.winner = find_solo(result.centre_counts, number_of_centres);
+        if (result.winner != NO_POWER) {
+            result.game_end = GAME_END_SOLO;
+            break;
+        }
+
+        if ((draw_years > 0) && (unchanged_years >= draw_years)) {
+            result.game_end = GAME_END_DRAW;
+            break;
+        }
+
+        play_turn(game, order_generator, random, &choices);
+        result.number_of_turns++;
+
+        // The centres change hands at the end of each year
+        if (game->current_year != counted_year) {
+            last_centre_counts.swap(result.centre_counts);
+            count_centres(*game, &(result.centre_counts));
+            unchanged_years = (result.centre_counts == last_centre_counts) ? unchanged_years + 1 : 0;
+            counted_year = game->current_year;
+        }
+    }
+
+    result.final_year = game->current_year;
+    return result;
+}
+
+void RolloutEngine::play_turn(MapAndUnits *game,
+                              OrderGenerator *order_generator,
+                              RANDOM &random,
+                              std::vector<int> *choices) const {
+    const LegalOrders &legal_orders = order_generator->generate(*game);
+    bool adjustment_turn = (game->current_season == TOKEN_SEASON_WIN);
+    int choices_needed = legal_orders.get_number_of_units();
+
+    if (adjustment_turn) {
+        for (POWER_INDEX power_ctr = 0; power_ctr < game->number_of_powers; power_ctr++) {
+            choices_needed = std::max(choices_needed, legal_orders.get_build_locations(power_ctr).size());
+        }
+    }
+    if (static_cast<int>(choices->size()) < choices_needed) {
+        choices->resize(choices_needed);
+    }
+
+    for (POWER_INDEX power_ctr = 0; power_ctr < game->number_of_powers; power_ctr++) {
+        LegalOrders::UNIT_ORDERS_LIST units = legal_orders.get_units(power_ctr);
+
+        if (adjustment_turn ? (legal_orders.get_number_of_builds(power_ctr) == 0) : units.empty()) { continue; }
+
+        int number_of_choices = get_policy(power_ctr)(*game, legal_orders, power_ctr, random, choices->data());
+
+        if (adjustment_turn) {
+            set_adjustment_orders(game, legal_orders, power_ctr, choices->data(), number_of_choices);
+            continue;
+        }
+
+        for (int unit_ctr = 0; unit_ctr < std::min(number_of_choices, units.size()); unit_ctr++) {
+            int choice = (*choices)[unit_ctr];
+            if ((choice < 0) || (choice >= units[unit_ctr].number_of_orders)) { continue; }
+
+            legal_orders.set_order(game, units[unit_ctr], legal_orders.get_orders(units[unit_ctr])[choice]);
+        }
+    }
+
+    game->adjudicate();
+    game->apply_adjudication();
+}
+
+void RolloutEngine::set_adjustment_orders(MapAndUnits *game,
+                                          const LegalOrders &legal_orders,
+                                          POWER_INDEX power,
+                                          const int choices[],
+                                          int number_of_choices) const {
+    WINTER_ORDERS_FOR_POWER &orders = game->winter_orders[power];
+    LegalOrders::UNIT_ORDERS_LIST units = legal_orders.get_units(power);
+    INDEX_LIST build_locations = legal_orders.get_build_locations(power);
+    int number_of_builds = legal_orders.get_number_of_builds(power);
+    PROVINCE_SET ordered_provinces;
+    COAST_ID location {};
+
+    // Entered as the server enters the orders it receives, for the power's own winter orders
+    for (int choice_ctr = 0;
+         (choice_ctr < number_of_choices)
+         && (static_cast<int>(orders.builds_or_disbands.size()) < std::abs(number_of_builds));
+         choice_ctr++) {
+
+        int choice = choices[choice_ctr];
+
+        if (number_of_builds > 0) {
+            if ((choice < 0) || (choice >= build_locations.size())) { continue; }
+            location = legal_orders.get_topology()->get_coast(build_locations.begin()[choice]);
+        } else {
+            if ((choice < 0) || (choice >= units.size())) { continue; }
+            location = game->units[units[choice].unit].coast_id;
+        }
+
+        if (ordered_provinces.contains(location.province_index)) { continue; }
+        ordered_provinces.insert(location.province_index);
+
+        orders.builds_or_disbands.insert(BUILDS_OR_DISBANDS::value_type(location, Token(0)));
+    }
+}
+
+int RolloutEngine::count_centres(const MapAndUnits &game, std::vector<int> *centre_counts) {
+    int number_of_centres {0};
+
+    centre_counts->assign(game.number_of_powers, 0);
+
+    for (PROVINCE_INDEX province_ctr = 0; province_ctr < game.number_of_provinces; province_ctr++) {
+        if (!game.game_map[province_ctr].is_supply_centre) { continue; }
+
+        number_of_centres++;
+        if (game.province_owner[province_ctr] != TOKEN_PARAMETER_UNO) {
+            (*centre_counts)[game.province_owner[province_ctr].get_subtoken()]++;
+        }
+    }
+    return number_of_centres;
+}
@@ -0,0 +1,138 @@
+/**
+ * Diplomacy AI Client - Part of the DAIDE project.
+ *
+ * Rollout Engine. Plays whole games in process, without a server, for Monte Carlo evaluation and for tuning bots.
+ *
+ * Every turn, each power's orders are chosen by a policy from the legal orders the OrderGenerator lists for the
+ * position. The engine enters them as the server would, adjudicates the turn and applies it, through the movement,
+ * retreat and adjustment turns, until a power has a solo, the game is drawn or the last year has been played.
+ *
+ * Many games are played at once, one task per game on an AdjudicationPool. Each game is played on the MapAndUnits of
+ * the worker running it, with the worker's own OrderGenerator, and has its own random generator seeded from its index,
+ * so a run with the same seed plays the same games however the tasks are shared out.
+ *
+ * Release 8~3
+ **/
+
+#ifndef _DAIDE_CLIENT_DAIDE_CLIENT_ROLLOUT_ENGINE_H
+#define _DAIDE_CLIENT_DAIDE_CLIENT_ROLLOUT_ENGINE_H
+
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include "daide_client/adjudication_pool.h"
+#include "daide_client/game_position.h"
+#include "daide_client/map_and_units.h"
+#include "daide_client/order_generator.h"
+
+namespace DAIDE {
+
+class RolloutEngine : public MapTypes {
+public:
+    enum { NO_POWER = -1 };
+    enum { DEFAULT_YEARS = 50 };                // Years played from the starting position, unless set otherwise
+    enum { DEFAULT_DRAW_YEARS = 10 };
+
+    // How a game ended
+    using GAME_END = enum {
+        GAME_END_SOLO,                          // A power holds more than half the supply centres
+        GAME_END_DRAW,                          // No power's centre count changed for the draw years
+        GAME_END_LAST_YEAR                      // The last year was played
+    };
+
+    using GAME_RESULT = struct {
+        GAME_END game_end;
+        POWER_INDEX winner;                     // The power with the solo, or NO_POWER
+        int final_year;                         // The year of the turn the game ended before
+        int number_of_turns;                    // The number of turns adjudicated
+        std::vector<int> centre_counts;         // Each power's supply centres at the end
+    };
+
+    // The totals for a call of play_games()
+    using ROLLOUT_STATS = struct {
+        int number_of_games;
+        long number_of_turns;
+        double seconds;
+        double games_per_second;
+    };
+
+    using RANDOM = std::mt19937_64;
+
+    // Chooses a power's orders for a turn, writing them as indexes into the legal orders, and returns how many it
+    // wrote. In a movement or retreat turn, the index in legal_orders.get_orders() of the order for each of the power's
+    // units in get_units(power), in turn; units with no order hold, or disband. In an adjustment turn, the index in
+    // get_build_locations(power) of each coast to build on, or in get_units(power) of each unit to remove; builds not
+    // ordered are waived, and removes not ordered are made by the civil disorder rules.
+    // Called on the worker playing the game, so it must be safe to call from several threads at once.
+    using POLICY = std::function<int(const MapAndUnits &game,
+                                     const LegalOrders &legal_orders,
+                                     POWER_INDEX power,
+                                     RANDOM &random,
+                                     int choices[])>;
+
+    // Chooses uniformly from each unit's legal orders, and makes every build or remove it can, on random coasts
+    static int random_policy(const MapAndUnits &game,
+                             const LegalOrders &legal_orders,
+                             POWER_INDEX power,
+                             RANDOM &random,
+                             int choices[]);
+
+    // The games are played on the pool's workers. The pool must be kept until the engine is finished with.
+    explicit RolloutEngine(AdjudicationPool *pool);
+
+    // Set the policy for every power, or for one power. The random policy is used until one is set.
+    void set_policy(const POLICY &policy);
+
+    void set_policy(POWER_INDEX power, const POLICY &policy);
+
+    // The last year whose turns are played, or 0 to play DEFAULT_YEARS from the starting position
+    void set_last_year(int year) { last_year = year; }
+
+    // Games are drawn once no power's centre count has changed for this many years. 0 to play on to the last year.
+    void set_draw_years(int years) { draw_years = years; }
+
+    void set_move_adjudicator(MapAndUnits::MOVE_ADJUDICATOR adjudicator) { move_adjudicator = adjudicator; }
+
+    // Play a number of games from a position, and wait for them all to finish. Each game's result is written to
+    // results, if given. Must not be called from a task on the pool.
+    ROLLOUT_STATS play_games(const GamePosition &position,
+                             int number_of_games,
+                             uint64_t seed,
+                             std::vector<GAME_RESULT> *results = nullptr);
+
+    // Play one game, from the position the MapAndUnits holds, on the calling thread
+    GAME_RESULT play_game(MapAndUnits *game, OrderGenerator *order_generator, RANDOM &random) const;
+
+private:
+    const POLICY &get_policy(POWER_INDEX power) const {
+        return ((power < static_cast<int>(policies.size())) && policies[power]) ? policies[power] : default_policy;
+    }
+
+    // Choose every power's orders and enter them, then adjudicate the turn and move on to the next
+    void play_turn(MapAndUnits *game,
+                   OrderGenerator *order_generator,
+                   RANDOM &random,
+                   std::vector<int> *choices) const;
+
+    void set_adjustment_orders(MapAndUnits *game,
+                               const LegalOrders &legal_orders,
+                               POWER_INDEX power,
+                               const int choices[],
+                               int number_of_choices) const;
+
+    // The supply centres each power owns. Returns the number of supply centres on the map.
+    static int count_centres(const MapAndUnits &game, std::vector<int> *centre_counts);
+
+    AdjudicationPool *pool;
+    POLICY default_policy;
+    std::vector<POLICY> policies;               // By power. Empty for powers using the default policy.
+    int last_year {0};
+    int draw_years {DEFAULT_DRAW_YEARS};
+    MapAndUnits::MOVE_ADJUDICATOR move_adjudicator {MapAndUnits::DEPENDENCY_MOVE_ADJUDICATOR};
+};
+
+} // namespace DAIDE
+
+#endif // _DAIDE_CLIENT_DAIDE_CLIENT_ROLLOUT_ENGINE_H
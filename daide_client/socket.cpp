@@ -15,12 +15,16 @@
 
 #include "daide_client/ai_client.h"
 #include "daide_client/error_log.h"
+#include "daide_client/metrics.h"
 #include "daide_client/socket.h"
 
 /////////////////////////////////////////////////////////////////////////////
 
 using DAIDE::Socket;
 using DAIDE::MessageHeader;
+using DAIDE::MetricsCounter;
+using DAIDE::MetricsGauge;
+using DAIDE::MetricsRegistry;
 
 using MessagePtr = Socket::MessagePtr;
 
@@ -28,6 +32,39 @@ Socket* Socket::SocketTab[FD_SETSIZE];
 
 int Socket::SocketCnt;
 
+namespace {
+
+// Metrics shared by all sockets
+using SOCKET_METRICS = struct {
+    MetricsCounter &bytes_received;
+    MetricsCounter &bytes_sent;
+    MetricsCounter &messages_received;
+    MetricsCounter &messages_sent;
+    MetricsGauge &incoming_queue_depth;
+    MetricsGauge &outgoing_queue_depth;
+    MetricsCounter &connects;
+    MetricsCounter &errors;
+    MetricsGauge &connected;
+};
+
+SOCKET_METRICS &socket_metrics() {
+    MetricsRegistry *registry = MetricsRegistry::instance();
+    static SOCKET_METRICS metrics {
+        registry->counter("daide_socket_received_bytes_total", "Bytes received from the server"),
+        registry->counter("daide_socket_sent_bytes_total", "Bytes sent to the server"),
+        registry->counter("daide_socket_received_messages_total", "Messages received from the server"),
+        registry->counter("daide_socket_sent_messages_total", "Messages sent to the server"),
+        registry->gauge("daide_socket_incoming_queue_depth", "Messages received but not yet processed"),
+        registry->gauge("daide_socket_outgoing_queue_depth", "Messages queued but not yet sent"),
+        registry->counter("daide_socket_connects_total", "Successful connections to the server"),
+        registry->counter("daide_socket_errors_total", "Socket errors and unexpected disconnections"),
+        registry->gauge("daide_socket_connected", "1 if connected to the server")
+    };
+    return metrics;
+}
+
+} // namespace
+
 Socket::~Socket() {
     // Destructor.
     // FIXME - Avoid using C-casts and delete
@@ -64,6 +101,7 @@ void Socket::SendData() {
             if (OutgoingMessageQueue.empty()) return; // nothing more to send
             OutgoingMessage = OutgoingMessageQueue.front(); // next message to send
             OutgoingMessageQueue.pop();
+            socket_metrics().outgoing_queue_depth.set(static_cast<int64_t>(OutgoingMessageQueue.size()));
             OutgoingNext = 0;
             short length = get_message_header(OutgoingMessage)->length;
             AdjustOrdering(OutgoingMessage, length);
@@ -76,12 +114,15 @@ void Socket::SendData() {
         if (sent == SOCKET_ERROR) {
             int error = WSAGetLastError();
             log_error("Failure %d during SendDatar", error);
+            socket_metrics().errors.increment();
             DAIDE::the_bot.stop();
             return;
         }
         OutgoingNext += static_cast<size_t>(sent);
+        socket_metrics().bytes_sent.increment(static_cast<uint64_t>(sent));
         if (OutgoingNext < OutgoingLength) return; // current message not fully sent
         OutgoingMessage.reset();
+        socket_metrics().messages_sent.increment();
     }
 }
 
@@ -96,15 +137,18 @@ void Socket::ReceiveData() {
 
     if (!received) {
         log_error("Failure: closed socket during read from Server");
+        socket_metrics().errors.increment();
         the_bot.stop();
         return;
     }
     if (received == SOCKET_ERROR) {
         int error = WSAGetLastError();
         log_error("Failure %d during ReceiveData", error);
+        socket_metrics().errors.increment();
         the_bot.stop();
         return;
     }
+    socket_metrics().bytes_received.increment(static_cast<uint64_t>(received));
     for (;;) { // while incoming data available
         // max # bytes that may be read into current message
         size_t count = std::min(IncomingLength - IncomingNext, static_cast<size_t>(received) - bufferNext);
@@ -150,12 +194,14 @@ void Socket::Start() {
     // Start using the socket.
     Connected = true;
     log("connected");
+    socket_metrics().connected.set(1);
     SendData();
 }
 
 void Socket::Close()
 {
     Connected = false;
+    socket_metrics().connected.set(0);
     if (MySocket) {
         log("disconnected");
         close(MySocket);
@@ -220,6 +266,7 @@ bool Socket::Connect(const std::string& address, int port) {
     OutgoingMessage.reset();
 
     InsertSocket();
+    socket_metrics().connects.increment();
 
     return true;
 }
@@ -227,11 +274,14 @@ bool Socket::Connect(const std::string& address, int port) {
 void Socket::PushIncomingMessage(const MessagePtr &message) {
     // Push incoming `message` on end of IncomingMessageQueue.
     IncomingMessageQueue.push(message); // safe to follow the post as we are in the Main thread
+    socket_metrics().messages_received.increment();
+    socket_metrics().incoming_queue_depth.set(static_cast<int64_t>(IncomingMessageQueue.size()));
 }
 
 void Socket::PushOutgoingMessage(const MessagePtr &message) {
     // Push outgoing `message` on end of OutgoingMessageQueue.
     OutgoingMessageQueue.push(message);
+    socket_metrics().outgoing_queue_depth.set(static_cast<int64_t>(OutgoingMessageQueue.size()));
     if (!OutgoingMessage && Connected) SendData();
 }
 
@@ -244,6 +294,7 @@ Socket::MessagePtr Socket::PullIncomingMessage() {
     if (!IncomingMessageQueue.empty()) {
         incomingMessage = IncomingMessageQueue.front(); // message to be processed
         IncomingMessageQueue.pop(); // remove it
+        socket_metrics().incoming_queue_depth.set(static_cast<int64_t>(IncomingMessageQueue.size()));
         // trigger recall if more messages remain
     }
 
@@ -75,6 +75,8 @@ public:
 
     void Close();
 
+    SOCKET GetSocket() const { return MySocket; }
+
     void SendData();
 
     void ReceiveData();
@@ -268,7 +268,7 @@ int TokenMessage::set_message_from_text(const std::string &text) {
     char token_text[5] {};
     std::string token_string;
     Token *token_message {nullptr};
-    TEXT_TO_TOKEN_MAP *text_to_token_map = &(TokenTextMap::instance()->m_text_to_token_map);
+    const TokenTextMap *token_text_map = TokenTextMap::instance();
 
     // FIXME - Use smart pointers instead
     token_message = new Token[text.length()];
@@ -316,10 +316,9 @@ int TokenMessage::set_message_from_text(const std::string &text) {
             token_text[3] = '\0';
             token_string = token_text;
 
-            auto token_itr = text_to_token_map->find(token_string);
-            if (token_itr == text_to_token_map->end()) { return char_ctr; }     // Undefined token
+            // Undefined token
+            if (!token_text_map->get_token(token_string, &token_message[token_ctr])) { return char_ctr; }
 
-            token_message[token_ctr] = token_itr->second;
             token_ctr++;
             char_ctr = char_ctr + 3;
 
@@ -370,7 +369,8 @@ void TokenMessage::set_message_as_ascii(const std::string &text) {
 std::string TokenMessage::get_message_as_text() const {
     bool is_ascii_text {false};
     std::ostringstream message_as_text;
-    TOKEN_TO_TEXT_MAP *token_to_text_map = &(TokenTextMap::instance()->m_token_to_text_map);
+    const TokenTextMap *token_text_map = TokenTextMap::instance();
+    std::string token_string;
 
     for (int token_ctr = 0; token_ctr < m_message_length; token_ctr++) {
         if (is_ascii_text && (m_message[token_ctr].get_category() != CATEGORY_ASCII)) {
@@ -388,8 +388,11 @@ std::string TokenMessage::get_message_as_text() const {
         } else if (m_message[token_ctr].is_number()) {
             message_as_text << m_message[token_ctr].get_number() << " ";
         } else {
-            auto token_itr = token_to_text_map->find(m_message[token_ctr].get_token());
-            message_as_text << ((token_itr == token_to_text_map->end()) ? "??? " : token_itr->second + " ");
+            if (token_text_map->get_text(m_message[token_ctr], &token_string)) {
+                message_as_text << token_string << " ";
+            } else {
+                message_as_text << "??? ";
+            }
         }
     }
 
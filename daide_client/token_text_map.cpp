@@ -12,6 +12,8 @@
  * Release 8~3
  **/
 
+#include <mutex>
+
 #include "daide_client/token_text_map.h"
 
 using DAIDE::TokenTextMap;
@@ -21,7 +23,32 @@ TokenTextMap *TokenTextMap::instance() {
     return &the_instance;
 }
 
+bool TokenTextMap::get_text(const Token &token, std::string *token_string) const {
+    std::shared_lock<std::shared_timed_mutex> lock(m_mutex);
+
+    auto token_itr = m_token_to_text_map.find(token);
+    if (token_itr == m_token_to_text_map.end()) { return false; }
+
+    *token_string = token_itr->second;
+    return true;
+}
+
+bool TokenTextMap::get_token(const std::string &token_string, Token *token) const {
+    std::shared_lock<std::shared_timed_mutex> lock(m_mutex);
+
+    auto text_itr = m_text_to_token_map.find(token_string);
+    if (text_itr == m_text_to_token_map.end()) { return false; }
+
+    *token = text_itr->second;
+    return true;
+}
+
 void TokenTextMap::clear_category(BYTE category) {
+    std::unique_lock<std::shared_timed_mutex> lock(m_mutex);
+    clear_category_locked(category);
+}
+
+void TokenTextMap::clear_category_locked(BYTE category) {
     TOKEN_TO_TEXT_MAP::iterator token_to_text_itr;
     LANGUAGE_TOKEN category_value = (LANGUAGE_TOKEN) (category) << 8;
     LANGUAGE_TOKEN next_category_value = (LANGUAGE_TOKEN) (category + 1) << 8;
@@ -45,13 +72,16 @@ void TokenTextMap::clear_category(BYTE category) {
 }
 
 void TokenTextMap::clear_power_and_province_categories() {
-    clear_category(CATEGORY_POWER);
+    std::unique_lock<std::shared_timed_mutex> lock(m_mutex);
+
+    clear_category_locked(CATEGORY_POWER);
     for (BYTE category_ctr = CATEGORY_PROVINCE_MIN; category_ctr <= CATEGORY_PROVINCE_MAX; category_ctr++) {
-        clear_category(category_ctr);
+        clear_category_locked(category_ctr);
     }
 }
 
 bool TokenTextMap::add_token(const Token &token, const std::string &token_string) {
+    std::unique_lock<std::shared_timed_mutex> lock(m_mutex);
     bool added_ok {true};
 
     // Already added, not readding
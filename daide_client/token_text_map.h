@@ -15,6 +15,10 @@
 #ifndef _DAIDE_CLIENT_DAIDE_CLIENT_TOKEN_TEXT_MAP_H
 #define _DAIDE_CLIENT_DAIDE_CLIENT_TOKEN_TEXT_MAP_H
 
+#include <map>
+#include <shared_mutex>
+#include <string>
+
 #include "daide_client/tokens.h"
 
 namespace DAIDE {
@@ -22,12 +26,16 @@ namespace DAIDE {
 using TOKEN_TO_TEXT_MAP = std::map<Token, std::string>;
 using TEXT_TO_TOKEN_MAP = std::map<std::string, Token>;
 
+// The text for each token. Shared by the whole process, so it is locked: lookups may be made from any thread while
+// the tokens are being changed.
 class TokenTextMap {
 public:
     static TokenTextMap *instance();
 
-    TOKEN_TO_TEXT_MAP m_token_to_text_map;
-    TEXT_TO_TOKEN_MAP m_text_to_token_map;
+    // Look up the text for a token, or the token for a text. Returns false if there is none.
+    bool get_text(const Token &token, std::string *token_string) const;
+
+    bool get_token(const std::string &token_string, Token *token) const;
 
     void clear_category(BYTE category);
 
@@ -37,6 +45,13 @@ public:
 
 private:
     TokenTextMap();
+
+    // As clear_category(), with the lock already held
+    void clear_category_locked(BYTE category);
+
+    mutable std::shared_timed_mutex m_mutex;
+    TOKEN_TO_TEXT_MAP m_token_to_text_map;
+    TEXT_TO_TOKEN_MAP m_text_to_token_map;
 };
 
 } // namespace DAIDE
@@ -0,0 +1,676 @@
+/**
+ * Diplomacy AI Client - Part of the DAIDE project.
+ *
+ * Adjudicator Fuzzer. Adjudicates random order sets with the phased and the dependency move adjudicators, and reports
+ * every order set on which their results differ.
+ *
+ * With -i, the incremental adjudicator is checked against the dependency one instead. Each position is then given a
+ * run of order sets, each changing the orders of one or two units from the one before, as a bot searching over
+ * orders would. Half the changes are given to the incremental adjudicator as SUB messages, as a server receives them.
+ *
+ * The positions come from random games played from the standard opening, and from units scattered at random over the
+ * standard map, which brings many more of them into contact. The orders are chosen to fit together: units mostly
+ * support the moves and holds actually ordered, and armies are convoyed by the fleets on their route, with orders
+ * which don't fit mixed in.
+ *
+ * The results compared are the flags of each unit and where each dislodged unit was dislodged from. The results are
+ * then applied, and the retreat options of the dislodged units compared, which checks the standoffs which matter.
+ * The position and order hashes, kept up to date as the orders are set and the results applied, are checked against
+ * ones computed from scratch.
+ *
+ * Before fuzzing, each adjudicator is checked on the standard opening: a unit moving alone into an empty province,
+ * with every other unit holding, must move. Then the winters of a random game are adjudicated, applied and undone,
+ * and must leave the winter orders as they were.
+ *
+ * Usage: fuzz_adjudicator [-nOrderSets] [-sSeed] [-mMismatchesToShow] [-i]
+ *
+ * Release 8~3
+ **/
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench/standard_game.h"
+#include "daide_client/map_and_units.h"
+#include "daide_client/map_cache.h"
+#include "daide_client/order_generator.h"
+
+using DAIDE::GamePosition;
+using DAIDE::LegalOrders;
+using DAIDE::MapAndUnits;
+using DAIDE::MapCache;
+using DAIDE::MapTopology;
+using DAIDE::OrderGenerator;
+using DAIDE::Token;
+using DAIDE::TokenMessage;
+using DAIDE::set_chosen_orders;
+using DAIDE::set_up_standard_game;
+
+namespace {
+
+// The games the positions are taken from
+enum { NUMBER_OF_GAMES = 20 };
+enum { YEARS_PER_GAME = 20 };
+
+// The positions with scattered units, and the chance (in tenths) of a unit in each province
+enum { NUMBER_OF_SCATTERED_POSITIONS = 500 };
+enum { SCATTERED_UNIT_TENTHS = 6 };
+
+enum { DEFAULT_ORDER_SETS = 1000000 };
+enum { DEFAULT_SEED = 1 };
+enum { DEFAULT_MISMATCHES_TO_SHOW = 5 };
+
+// For the incremental adjudicator, the order sets given to each position, and the most units changed between them
+enum { ORDER_SETS_PER_POSITION = 8 };
+enum { MOST_UNITS_CHANGED = 2 };
+
+using RANDOM = std::mt19937;
+
+// A position to order, with its legal orders
+using BASE_POSITION = struct {
+    GamePosition position;
+    LegalOrders legal_orders;
+};
+
+using BASE_POSITIONS = std::vector<BASE_POSITION>;
+
+int random_below(RANDOM &random, int limit) {
+    return static_cast<int>(random() % static_cast<unsigned>(limit));
+}
+
+// The index in the unit's legal orders of a random one of the given type, or -1 if it has none
+int choose_order_of_type(RANDOM &random, const LegalOrders::LEGAL_ORDER_LIST &orders, MapAndUnits::ORDER_TYPE type) {
+    int number_of_orders {0};
+
+    for (const auto &order : orders) {
+        if (order.order_type == type) { number_of_orders++; }
+    }
+    if (number_of_orders == 0) { return -1; }
+
+    int orders_to_skip = random_below(random, number_of_orders);
+    for (int order_ctr = 0; order_ctr < orders.size(); order_ctr++) {
+        if ((orders[order_ctr].order_type == type) && (orders_to_skip-- == 0)) { return order_ctr; }
+    }
+    return -1;
+}
+
+// Play random games from the standard opening, keeping each movement position reached
+void play_games(RANDOM &random, MapAndUnits &map_and_units, OrderGenerator &order_generator,
+                BASE_POSITIONS *base_positions) {
+    for (int game_ctr = 0; game_ctr < NUMBER_OF_GAMES; game_ctr++) {
+        set_up_standard_game(map_and_units);
+
+        for (int turn_ctr = 0; (turn_ctr < YEARS_PER_GAME * 5) && !map_and_units.game_over; turn_ctr++) {
+            const LegalOrders &legal_orders = order_generator.generate(map_and_units);
+
+            // Adjustments are left to civil disorder
+            if (map_and_units.current_season != DAIDE::TOKEN_SEASON_WIN) {
+                std::vector<uint16_t> choices;
+
+                for (const auto &unit : legal_orders.get_all_units()) {
+                    choices.push_back(static_cast<uint16_t>(random_below(random, legal_orders.get_orders(unit).size())));
+                }
+
+                if ((map_and_units.current_season == DAIDE::TOKEN_SEASON_SPR)
+                    || (map_and_units.current_season == DAIDE::TOKEN_SEASON_FAL)) {
+                    base_positions->push_back(BASE_POSITION {map_and_units.get_position(), legal_orders});
+                }
+                set_chosen_orders(map_and_units, legal_orders, choices);
+            }
+
+            map_and_units.adjudicate();
+            map_and_units.apply_adjudication();
+        }
+    }
+}
+
+// Spring positions with a unit of a random power in most provinces, on a random one of its coasts
+void scatter_units(RANDOM &random, MapAndUnits &map_and_units, OrderGenerator &order_generator,
+                   BASE_POSITIONS *base_positions) {
+    const MapTopology &topology = *map_and_units.get_topology();
+
+    for (int position_ctr = 0; position_ctr < NUMBER_OF_SCATTERED_POSITIONS; position_ctr++) {
+        set_up_standard_game(map_and_units);
+        map_and_units.units.clear();
+
+        for (MapAndUnits::PROVINCE_INDEX province = 0; province < map_and_units.number_of_provinces; province++) {
+            int number_of_coasts = topology.get_end_coast(province) - topology.get_first_coast(province);
+            if ((number_of_coasts <= 0) || (random_below(random, 10) >= SCATTERED_UNIT_TENTHS)) { continue; }
+
+            MapAndUnits::UNIT_AND_ORDER unit {};
+            unit.coast_id = topology.get_coast(topology.get_first_coast(province) + random_below(random, number_of_coasts));
+            unit.nationality = random_below(random, map_and_units.number_of_powers);
+            unit.unit_type = (unit.coast_id.coast_token == DAIDE::TOKEN_UNIT_AMY) ? DAIDE::TOKEN_UNIT_AMY
+                                                                                   : DAIDE::TOKEN_UNIT_FLT;
+            unit.order_type = MapAndUnits::NO_ORDER;
+            map_and_units.units[province] = unit;
+        }
+        map_and_units.rehash();
+
+        base_positions->push_back(BASE_POSITION {map_and_units.get_position(), order_generator.generate(map_and_units)});
+    }
+}
+
+// Orders which mostly fit together. Some units move or hold, some armies are convoyed by the fleets on their route,
+// and most of the rest support one of the moves or holds ordered. One order in ten is chosen at random.
+std::vector<uint16_t> choose_orders(RANDOM &random, const LegalOrders &legal_orders) {
+    const MapTopology &topology = *legal_orders.get_topology();
+    LegalOrders::UNIT_ORDERS_LIST units = legal_orders.get_all_units();
+    std::vector<int> choices(units.size(), -1);
+    int unit_index[MapAndUnits::MAX_PROVINCES];
+    MapAndUnits::PROVINCE_INDEX destinations[MapAndUnits::MAX_PROVINCES];
+
+    for (int unit_ctr = 0; unit_ctr < units.size(); unit_ctr++) {
+        unit_index[units[unit_ctr].unit] = unit_ctr;
+    }
+
+    // Moves and holds
+    for (int unit_ctr = 0; unit_ctr < units.size(); unit_ctr++) {
+        LegalOrders::LEGAL_ORDER_LIST orders = legal_orders.get_orders(units[unit_ctr]);
+        int order_chosen = random_below(random, 10);
+
+        if (order_chosen < 4) {
+            choices[unit_ctr] = choose_order_of_type(random, orders, MapAndUnits::MOVE_ORDER);
+        } else if (order_chosen < 5) {
+            choices[unit_ctr] = choose_order_of_type(random, orders, MapAndUnits::HOLD_ORDER);
+        } else if (order_chosen < 6) {
+            choices[unit_ctr] = random_below(random, orders.size());
+        }
+    }
+
+    // Convoys, through fleets which haven't been given an order
+    for (int unit_ctr = 0; unit_ctr < units.size(); unit_ctr++) {
+        LegalOrders::LEGAL_ORDER_LIST orders = legal_orders.get_orders(units[unit_ctr]);
+        int convoy_choice = choose_order_of_type(random, orders, MapAndUnits::MOVE_BY_CONVOY_ORDER);
+        if ((convoy_choice < 0) || (random_below(random, 2) == 0)) { continue; }
+
+        const LegalOrders::LEGAL_ORDER &convoy = orders[convoy_choice];
+        MapAndUnits::INDEX_LIST steps = legal_orders.get_convoy_steps(convoy);
+        MapAndUnits::PROVINCE_INDEX destination = topology.get_coast(convoy.destination).province_index;
+        bool route_free {true};
+
+        for (MapAndUnits::PROVINCE_INDEX fleet : steps) {
+            if (choices[unit_index[fleet]] >= 0) { route_free = false; }
+        }
+        if (!route_free) { continue; }
+
+        choices[unit_ctr] = convoy_choice;
+        for (MapAndUnits::PROVINCE_INDEX fleet : steps) {
+            LegalOrders::LEGAL_ORDER_LIST fleet_orders = legal_orders.get_orders(units[unit_index[fleet]]);
+
+            for (int order_ctr = 0; order_ctr < fleet_orders.size(); order_ctr++) {
+                if ((fleet_orders[order_ctr].order_type == MapAndUnits::CONVOY_ORDER)
+                    && (fleet_orders[order_ctr].other_source_province == units[unit_ctr].unit)
+                    && (fleet_orders[order_ctr].other_dest_province == destination)) {
+                    choices[unit_index[fleet]] = order_ctr;
+                }
+            }
+        }
+    }
+
+    // Where each unit ordered so far is going, or its own province if it isn't moving
+    for (int unit_ctr = 0; unit_ctr < units.size(); unit_ctr++) {
+        destinations[units[unit_ctr].unit] = units[unit_ctr].unit;
+
+        if (choices[unit_ctr] >= 0) {
+            const LegalOrders::LEGAL_ORDER &order = legal_orders.get_orders(units[unit_ctr])[choices[unit_ctr]];
+
+            if ((order.order_type == MapAndUnits::MOVE_ORDER)
+                || (order.order_type == MapAndUnits::MOVE_BY_CONVOY_ORDER)) {
+                destinations[units[unit_ctr].unit] = topology.get_coast(order.destination).province_index;
+            }
+        }
+    }
+
+    // Supports for the orders given, and random orders for the rest
+    for (int unit_ctr = 0; unit_ctr < units.size(); unit_ctr++) {
+        if (choices[unit_ctr] >= 0) { continue; }
+
+        LegalOrders::LEGAL_ORDER_LIST orders = legal_orders.get_orders(units[unit_ctr]);
+        int number_of_fitting_supports {0};
+
+        for (const auto &order : orders) {
+            if (((order.order_type == MapAndUnits::SUPPORT_TO_HOLD_ORDER)
+                 || (order.order_type == MapAndUnits::SUPPORT_TO_MOVE_ORDER))
+                && (destinations[order.other_source_province] == order.other_dest_province)) {
+                number_of_fitting_supports++;
+            }
+        }
+
+        if ((number_of_fitting_supports == 0) || (random_below(random, 10) == 0)) {
+            choices[unit_ctr] = random_below(random, orders.size());
+            continue;
+        }
+
+        int supports_to_skip = random_below(random, number_of_fitting_supports);
+        for (int order_ctr = 0; order_ctr < orders.size(); order_ctr++) {
+            if (((orders[order_ctr].order_type == MapAndUnits::SUPPORT_TO_HOLD_ORDER)
+                 || (orders[order_ctr].order_type == MapAndUnits::SUPPORT_TO_MOVE_ORDER))
+                && (destinations[orders[order_ctr].other_source_province] == orders[order_ctr].other_dest_province)
+                && (supports_to_skip-- == 0)) {
+                choices[unit_ctr] = order_ctr;
+            }
+        }
+    }
+
+    // Units with no move or hold of the type wanted
+    std::vector<uint16_t> order_set;
+    for (int unit_ctr = 0; unit_ctr < units.size(); unit_ctr++) {
+        if (choices[unit_ctr] < 0) {
+            choices[unit_ctr] = random_below(random, legal_orders.get_orders(units[unit_ctr]).size());
+        }
+        order_set.push_back(static_cast<uint16_t>(choices[unit_ctr]));
+    }
+    return order_set;
+}
+
+// Change the orders of a few units, to ones which fit with a new set of orders
+void change_orders(RANDOM &random, const LegalOrders &legal_orders, std::vector<uint16_t> *choices) {
+    std::vector<uint16_t> new_choices = choose_orders(random, legal_orders);
+    int units_to_change = 1 + random_below(random, MOST_UNITS_CHANGED);
+
+    for (int unit_ctr = 0; unit_ctr < units_to_change; unit_ctr++) {
+        int unit_to_change = random_below(random, choices->size());
+        (*choices)[unit_to_change] = new_choices[unit_to_change];
+    }
+}
+
+// Enter the orders of each power with a changed order as a SUB message, as orders from a client are. The messenger
+// holds the new orders, and the map the ones from before the change.
+void submit_changed_orders(MapAndUnits &messenger,
+                           MapAndUnits &map_and_units,
+                           const LegalOrders &legal_orders,
+                           const std::vector<uint16_t> &previous_choices,
+                           const std::vector<uint16_t> &choices) {
+    LegalOrders::UNIT_ORDERS_LIST units = legal_orders.get_all_units();
+    std::vector<bool> power_changed(map_and_units.number_of_powers, false);
+    std::vector<Token> order_results(MapAndUnits::MAX_PROVINCES);
+
+    for (int unit_ctr = 0; unit_ctr < units.size(); unit_ctr++) {
+        if (choices[unit_ctr] != previous_choices[unit_ctr]) {
+            power_changed[map_and_units.units.find(units[unit_ctr].unit)->second.nationality] = true;
+        }
+    }
+
+    for (int power_ctr = 0; power_ctr < map_and_units.number_of_powers; power_ctr++) {
+        if (power_changed[power_ctr]) {
+            messenger.set_power_played(Token(DAIDE::CATEGORY_POWER, static_cast<DAIDE::BYTE>(power_ctr)));
+            map_and_units.process_orders(messenger.build_sub_command(), power_ctr, order_results.data());
+        }
+    }
+}
+
+// The first difference between the results of the adjudications, or an empty string if they are the same
+std::string compare_results(const MapAndUnits &reference, const MapAndUnits &candidate) {
+    char difference[128];
+
+    for (const auto &unit : reference.units) {
+        const MapAndUnits::UNIT_AND_ORDER &expected = unit.second;
+        const MapAndUnits::UNIT_AND_ORDER &result = candidate.units.find(unit.first)->second;
+        const char *flag {nullptr};
+
+        if (expected.unit_moves != result.unit_moves) {
+            flag = "unit_moves";
+        } else if (expected.bounce != result.bounce) {
+            flag = "bounce";
+        } else if (expected.dislodged != result.dislodged) {
+            flag = "dislodged";
+        } else if (expected.dislodged && (expected.dislodged_from != result.dislodged_from)) {
+            flag = "dislodged_from";
+        } else if (expected.support_cut != result.support_cut) {
+            flag = "support_cut";
+        } else if (expected.support_void != result.support_void) {
+            flag = "support_void";
+        } else if (expected.no_convoy != result.no_convoy) {
+            flag = "no_convoy";
+        } else if (expected.convoy_broken != result.convoy_broken) {
+            flag = "convoy_broken";
+        } else if (expected.no_army_to_convoy != result.no_army_to_convoy) {
+            flag = "no_army_to_convoy";
+        }
+
+        if (flag != nullptr) {
+            std::snprintf(difference, sizeof(difference), "%s differs for the unit in province %d", flag, unit.first);
+            return difference;
+        }
+    }
+
+    return std::string();
+}
+
+// The first difference between the retreat options once the results are applied
+std::string compare_retreat_options(const MapAndUnits &reference, const MapAndUnits &candidate) {
+    char difference[128];
+
+    for (const auto &unit : reference.dislodged_units) {
+        const MapAndUnits::COAST_SET &expected = unit.second.retreat_options;
+        const MapAndUnits::COAST_SET &result = candidate.dislodged_units.find(unit.first)->second.retreat_options;
+
+        // Coasts are only ordered, so the sets are compared both ways
+        if ((expected < result) || (result < expected)) {
+            std::snprintf(difference, sizeof(difference), "retreat options differ for the unit in province %d",
+                          unit.first);
+            return difference;
+        }
+    }
+    return std::string();
+}
+
+// A difference between the hashes kept as the position and orders change and the ones computed from scratch, or an
+// empty string if there is none
+std::string compare_hashes(const MapAndUnits &map_and_units, const char *name) {
+    char difference[128];
+
+    if (map_and_units.get_position_hash() != map_and_units.compute_position_hash()) {
+        std::snprintf(difference, sizeof(difference), "position hash of the %s adjudicator is out of date", name);
+        return difference;
+    }
+    if (map_and_units.get_order_hash() != map_and_units.compute_order_hash()) {
+        std::snprintf(difference, sizeof(difference), "order hash of the %s adjudicator is out of date", name);
+        return difference;
+    }
+    return std::string();
+}
+
+void show_mismatch(long order_set_ctr, const std::string &difference, MapAndUnits &reference, MapAndUnits &candidate) {
+    std::vector<TokenMessage> expected_results(MapAndUnits::MAX_PROVINCES);
+    std::vector<TokenMessage> results(MapAndUnits::MAX_PROVINCES);
+    int number_of_results = reference.get_adjudication_results(expected_results.data());
+
+    candidate.get_adjudication_results(results.data());
+
+    std::printf("Order set %ld: %s\n", order_set_ctr, difference.c_str());
+    for (int result_ctr = 0; result_ctr < number_of_results; result_ctr++) {
+        std::string expected = expected_results[result_ctr].get_message_as_text();
+        std::string result = results[result_ctr].get_message_as_text();
+
+        std::printf("  %s\n", expected.c_str());
+        if (result != expected) {
+            std::printf("! %s\n", result.c_str());
+        }
+    }
+}
+
+// Each unit in the standard opening moves alone into each empty province it can reach, with every other unit
+// holding, and every move must succeed. Returns whether they all did.
+bool check_moves_into_empty_provinces(const MapAndUnits &opening, OrderGenerator &order_generator) {
+    std::unique_ptr<MapAndUnits> map_and_units(new MapAndUnits(opening));
+    const MapTopology &topology = *map_and_units->get_topology();
+    const LegalOrders &legal_orders = order_generator.generate(*map_and_units);
+    LegalOrders::UNIT_ORDERS_LIST units = legal_orders.get_all_units();
+    const MapAndUnits::MOVE_ADJUDICATOR adjudicators[] = {MapAndUnits::PHASED_MOVE_ADJUDICATOR,
+                                                          MapAndUnits::DEPENDENCY_MOVE_ADJUDICATOR,
+                                                          MapAndUnits::INCREMENTAL_MOVE_ADJUDICATOR};
+    std::vector<uint16_t> holds;
+    bool all_moved {true};
+
+    for (const auto &unit : units) {
+        int hold_choice {0};
+        LegalOrders::LEGAL_ORDER_LIST orders = legal_orders.get_orders(unit);
+
+        while (orders[hold_choice].order_type != MapAndUnits::HOLD_ORDER) { hold_choice++; }
+        holds.push_back(static_cast<uint16_t>(hold_choice));
+    }
+
+    for (MapAndUnits::MOVE_ADJUDICATOR adjudicator : adjudicators) {
+        map_and_units->set_move_adjudicator(adjudicator);
+
+        for (int unit_ctr = 0; unit_ctr < units.size(); unit_ctr++) {
+            LegalOrders::LEGAL_ORDER_LIST orders = legal_orders.get_orders(units[unit_ctr]);
+
+            for (int order_ctr = 0; order_ctr < orders.size(); order_ctr++) {
+                if ((orders[order_ctr].order_type != MapAndUnits::MOVE_ORDER)
+                    || (map_and_units->units.find(topology.get_coast(orders[order_ctr].destination).province_index)
+                        != map_and_units->units.end())) {
+                    continue;
+                }
+
+                std::vector<uint16_t> choices = holds;
+                choices[unit_ctr] = static_cast<uint16_t>(order_ctr);
+                set_chosen_orders(*map_and_units, legal_orders, choices);
+                map_and_units->adjudicate();
+
+                if (!map_and_units->units[units[unit_ctr].unit].unit_moves) {
+                    std::printf("Adjudicator %d: move %d of the unit in province %d into an empty province failed\n",
+                                static_cast<int>(adjudicator),
+                                order_ctr,
+                                units[unit_ctr].unit);
+                    all_moved = false;
+                }
+            }
+        }
+    }
+    return all_moved;
+}
+
+// Whether the winter orders of each power are the same in both
+bool same_winter_orders(const MapAndUnits::WINTER_ORDERS &expected,
+                        const MapAndUnits::WINTER_ORDERS &result,
+                        MapAndUnits::POWER_INDEX power_index) {
+    auto expected_itr = expected.find(power_index);
+    auto result_itr = result.find(power_index);
+
+    if ((expected_itr == expected.end()) || (result_itr == result.end())) {
+        return (expected_itr == expected.end()) && (result_itr == result.end());
+    }
+
+    const MapAndUnits::WINTER_ORDERS_FOR_POWER &expected_orders = expected_itr->second;
+    const MapAndUnits::WINTER_ORDERS_FOR_POWER &result_orders = result_itr->second;
+
+    // Coasts are only ordered, so the orders are compared both ways
+    return (expected_orders.is_building == result_orders.is_building)
+           && (expected_orders.number_of_orders_required == result_orders.number_of_orders_required)
+           && (expected_orders.number_of_waives == result_orders.number_of_waives)
+           && !(expected_orders.builds_or_disbands < result_orders.builds_or_disbands)
+           && !(result_orders.builds_or_disbands < expected_orders.builds_or_disbands);
+}
+
+// A random game from the standard opening, with adjustments left to civil disorder. Each winter is adjudicated,
+// applied and undone, and the winter orders must be as they were before, without the disbands, waives and results
+// written by the adjudication. Returns whether they all were.
+bool check_undo_of_adjustments(const MapAndUnits &opening, OrderGenerator &order_generator) {
+    std::unique_ptr<MapAndUnits> map_and_units(new MapAndUnits(opening));
+    RANDOM random(DEFAULT_SEED);
+    bool all_undone {true};
+
+    map_and_units->set_undo_logging(true);
+
+    for (int turn_ctr = 0; (turn_ctr < YEARS_PER_GAME * 5) && !map_and_units->game_over; turn_ctr++) {
+        const LegalOrders &legal_orders = order_generator.generate(*map_and_units);
+
+        if (map_and_units->current_season == DAIDE::TOKEN_SEASON_WIN) {
+            MapAndUnits::WINTER_ORDERS winter_orders = map_and_units->winter_orders;
+            auto undo_mark = map_and_units->get_undo_mark();
+
+            map_and_units->adjudicate();
+            map_and_units->apply_adjudication();
+            map_and_units->undo_to(undo_mark);
+
+            for (int power_ctr = 0; power_ctr < map_and_units->number_of_powers; power_ctr++) {
+                if (!same_winter_orders(winter_orders, map_and_units->winter_orders, power_ctr)) {
+                    std::printf("Winter %d: undo_to() did not restore the winter orders of power %d\n",
+                                map_and_units->current_year,
+                                power_ctr);
+                    all_undone = false;
+                }
+            }
+        } else {
+            std::vector<uint16_t> choices;
+
+            for (const auto &unit : legal_orders.get_all_units()) {
+                choices.push_back(static_cast<uint16_t>(random_below(random, legal_orders.get_orders(unit).size())));
+            }
+            set_chosen_orders(*map_and_units, legal_orders, choices);
+        }
+
+        map_and_units->adjudicate();
+        map_and_units->apply_adjudication();
+    }
+    return all_undone;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    long number_of_order_sets {DEFAULT_ORDER_SETS};
+    unsigned seed {DEFAULT_SEED};
+    long mismatches_to_show {DEFAULT_MISMATCHES_TO_SHOW};
+    bool incremental {false};
+    bool arguments_ok {true};
+
+    for (int arg_ctr = 1; arg_ctr < argc; arg_ctr++) {
+        std::string arg = argv[arg_ctr];
+
+        if ((arg.size() > 2) && (arg.compare(0, 2, "-n") == 0)) {
+            number_of_order_sets = std::atol(arg.c_str() + 2);
+            arguments_ok = arguments_ok && (number_of_order_sets > 0);
+        } else if ((arg.size() > 2) && (arg.compare(0, 2, "-s") == 0)) {
+            seed = static_cast<unsigned>(std::strtoul(arg.c_str() + 2, nullptr, 10));
+        } else if ((arg.size() > 2) && (arg.compare(0, 2, "-m") == 0)) {
+            mismatches_to_show = std::atol(arg.c_str() + 2);
+        } else if (arg == "-i") {
+            incremental = true;
+        } else {
+            arguments_ok = false;
+        }
+    }
+
+    if (!arguments_ok) {
+        std::fprintf(stderr, "Usage: %s [-nOrderSets] [-sSeed] [-mMismatchesToShow] [-i]\n", argv[0]);
+        return 1;
+    }
+
+    // Build the map without touching any cache files
+    MapCache::set_cache_directory("");
+
+    std::unique_ptr<MapAndUnits> reference(new MapAndUnits);
+    TokenMessage mdf_message;
+    mdf_message.set_message_from_text(DAIDE::STANDARD_MDF);
+
+    int error_location = reference->set_map(mdf_message);
+    if ((error_location != DAIDE::ADJUDICATOR_NO_ERROR) || !set_up_standard_game(*reference)) {
+        std::fprintf(stderr, "Could not set up the standard map (error at %d)\n", error_location);
+        return 1;
+    }
+    reference->set_order_checking(false, false);
+
+    // The adjudicator checked, and the one it is checked against
+    std::unique_ptr<MapAndUnits> candidate(new MapAndUnits(*reference));
+    const char *reference_name = incremental ? "dependency" : "phased";
+    const char *candidate_name = incremental ? "incremental" : "dependency";
+
+    if (incremental) {
+        reference->set_move_adjudicator(MapAndUnits::DEPENDENCY_MOVE_ADJUDICATOR);
+        candidate->set_move_adjudicator(MapAndUnits::INCREMENTAL_MOVE_ADJUDICATOR);
+    } else {
+        candidate->set_move_adjudicator(MapAndUnits::DEPENDENCY_MOVE_ADJUDICATOR);
+    }
+
+    RANDOM random(seed);
+    OrderGenerator order_generator;
+    BASE_POSITIONS game_positions;
+    BASE_POSITIONS scattered_positions;
+
+    if (!check_moves_into_empty_provinces(*reference, order_generator)
+        || !check_undo_of_adjustments(*reference, order_generator)) {
+        return 2;
+    }
+
+    play_games(random, *reference, order_generator, &game_positions);
+    scatter_units(random, *reference, order_generator, &scattered_positions);
+
+    long mismatches {0};
+    double reference_seconds {0.0};
+    double candidate_seconds {0.0};
+    const BASE_POSITION *base_position {nullptr};
+    std::vector<uint16_t> choices;
+    std::vector<uint16_t> previous_choices;
+    bool submitting {false};
+
+    // Gives the candidate its changed orders as SUB messages
+    std::unique_ptr<MapAndUnits> messenger(new MapAndUnits(*reference));
+
+    for (long order_set_ctr = 0; order_set_ctr < number_of_order_sets; order_set_ctr++) {
+        if (!incremental || ((order_set_ctr % ORDER_SETS_PER_POSITION) == 0)) {
+            long position_ctr = incremental ? (order_set_ctr / ORDER_SETS_PER_POSITION) : order_set_ctr;
+            const BASE_POSITIONS &base_positions = ((position_ctr % 2) == 0) ? game_positions : scattered_positions;
+
+            base_position = &(base_positions[random_below(random, base_positions.size())]);
+            choices = choose_orders(random, base_position->legal_orders);
+            submitting = false;
+        } else {
+            previous_choices = choices;
+            change_orders(random, base_position->legal_orders, &choices);
+            submitting = (random_below(random, 2) == 0);
+        }
+
+        reference->set_position(base_position->position);
+        set_chosen_orders(*reference, base_position->legal_orders, choices);
+        candidate->set_position(base_position->position);
+
+        if (submitting) {
+            messenger->set_position(base_position->position);
+            set_chosen_orders(*messenger, base_position->legal_orders, choices);
+            set_chosen_orders(*candidate, base_position->legal_orders, previous_choices);
+            submit_changed_orders(*messenger, *candidate, base_position->legal_orders, previous_choices, choices);
+        } else {
+            set_chosen_orders(*candidate, base_position->legal_orders, choices);
+        }
+
+        std::string difference = compare_hashes(*reference, reference_name) + compare_hashes(*candidate, candidate_name);
+        if (!difference.empty()) {
+            if (mismatches < mismatches_to_show) {
+                std::printf("Order set %ld: %s\n", order_set_ctr, difference.c_str());
+            }
+            mismatches++;
+            continue;
+        }
+
+        auto start_time = std::chrono::steady_clock::now();
+        reference->adjudicate();
+        auto reference_time = std::chrono::steady_clock::now();
+        candidate->adjudicate();
+        auto end_time = std::chrono::steady_clock::now();
+
+        reference_seconds += std::chrono::duration<double>(reference_time - start_time).count();
+        candidate_seconds += std::chrono::duration<double>(end_time - reference_time).count();
+
+        difference = compare_results(*reference, *candidate);
+        if (!difference.empty() && (mismatches < mismatches_to_show)) {
+            show_mismatch(order_set_ctr, difference, *reference, *candidate);
+        }
+
+        if (difference.empty()) {
+            reference->apply_adjudication();
+            candidate->apply_adjudication();
+            difference = compare_retreat_options(*reference, *candidate);
+            if (difference.empty()) {
+                difference = compare_hashes(*reference, reference_name) + compare_hashes(*candidate, candidate_name);
+            }
+
+            if (!difference.empty() && (mismatches < mismatches_to_show)) {
+                std::printf("Order set %ld: %s\n", order_set_ctr, difference.c_str());
+            }
+        }
+
+        if (!difference.empty()) { mismatches++; }
+    }
+
+    std::printf("{\"fuzzer\": \"adjudicator\", \"seed\": %u, \"order_sets\": %ld, \"mismatches\": %ld, "
+                "\"%s_seconds\": %.3f, \"%s_seconds\": %.3f}\n",
+                seed,
+                number_of_order_sets,
+                mismatches,
+                reference_name,
+                reference_seconds,
+                candidate_name,
+                candidate_seconds);
+
+    return (mismatches == 0) ? 0 : 2;
+}